@@ -48,6 +48,14 @@ uint32_t CurrAddress;
  */
 bool RunBootloader = true;
 
+#if defined(ENABLE_PAGE_PIPELINING)
+/** Buffer holding the data of the FLASH page being written by a block write command. The page data is received into
+ *  this buffer while the previously written page is still being programmed, and only then loaded into the temporary
+ *  page buffer of the AVR, as the temporary page buffer cannot be filled while a page program is in progress.
+ */
+static uint8_t PageData[SPM_PAGESIZE];
+#endif
+
 
 /** Main program entry point. This routine configures the hardware required by the bootloader, then continuously 
  *  runs the bootloader processing routine until instructed to soft-exit, or hard-reset via the watchdog to start
@@ -124,7 +132,9 @@ static void ReadWriteMemoryBlock(const uint8_t Command)
 	char     MemoryType;
 	
 	bool     HighByte = false;
+	#if !defined(ENABLE_PAGE_PIPELINING)
 	uint8_t  LowByte  = 0;
+	#endif
 	
 	BlockSize  = (FetchNextCommandByte() << 8);
 	BlockSize |=  FetchNextCommandByte();
@@ -174,6 +184,55 @@ static void ReadWriteMemoryBlock(const uint8_t Command)
 	}
 	else
 	{
+		#if defined(ENABLE_PAGE_PIPELINING)
+		/* The EEPROM cannot be written while a page program started by an earlier block write is in progress */
+		if (MemoryType == 'E')
+		  boot_spm_busy_wait();
+
+		while (BlockSize)
+		{
+			if (MemoryType == 'F')
+			{
+				uint32_t PageStartAddress = CurrAddress;
+				uint16_t PageBytes        = (BlockSize < SPM_PAGESIZE) ? BlockSize : SPM_PAGESIZE;
+
+				/* Receive the page data while the page written by the previous block write is still being programmed */
+				FetchNextCommandBlock(PageData, PageBytes);
+				BlockSize -= PageBytes;
+
+				/* Pad out an incomplete last word of the page */
+				if (PageBytes & 0x01)
+				  PageData[PageBytes++] = 0xFF;
+
+				/* Erase the page once the previous page program has completed */
+				boot_spm_busy_wait();
+				boot_page_erase(PageStartAddress);
+				boot_spm_busy_wait();
+
+				/* Load the received page data into the temporary page buffer */
+				for (uint16_t PageByte = 0; PageByte < PageBytes; PageByte += 2)
+				{
+					boot_page_fill(CurrAddress, ((PageData[PageByte + 1] << 8) | PageData[PageByte]));
+
+					/* Increment the address counter after use */
+					CurrAddress += 2;
+				}
+
+				/* Start the page program, which completes while the host sends the next block rather than being waited on */
+				boot_page_write(PageStartAddress);
+			}
+			else
+			{
+				/* Write the next EEPROM byte from the endpoint */
+				eeprom_write_byte((uint8_t*)((intptr_t)(CurrAddress >> 1)), FetchNextCommandByte());					
+
+				/* Increment the address counter after use */
+				CurrAddress += 2;
+
+				BlockSize--;
+			}
+		}
+		#else
 		uint32_t PageStartAddress = CurrAddress;
 
 		if (MemoryType == 'F')
@@ -223,7 +282,8 @@ static void ReadWriteMemoryBlock(const uint8_t Command)
 			/* Wait until write operation has completed */
 			boot_spm_busy_wait();
 		}
-	
+		#endif
+
 		/* Send response byte back to the host */
 		WriteNextResponseByte('\r');		
 	}
@@ -255,6 +315,43 @@ static uint8_t FetchNextCommandByte(void)
 	return Endpoint_Read_Byte();
 }
 
+#if defined(ENABLE_PAGE_PIPELINING)
+/** Retrieves a block of bytes from the host in the CDC data OUT endpoint, reading each received packet in turn and clearing
+ *  the endpoint bank once it has been emptied to allow reception of the next data packet from the host.
+ *
+ *  \param[out] Buffer  Pointer to the buffer to store the received bytes into
+ *  \param[in]  Length  Number of bytes to receive from the host
+ */
+static void FetchNextCommandBlock(uint8_t* Buffer,
+                                  uint16_t Length)
+{
+	/* Select the OUT endpoint so that the data bytes can be read */
+	Endpoint_SelectEndpoint(CDC_RX_EPNUM);
+
+	while (Length)
+	{
+		/* If OUT endpoint empty, clear it and wait for the next packet from the host */
+		if (!(Endpoint_IsReadWriteAllowed()))
+		{
+			Endpoint_ClearOUT();
+
+			while (!(Endpoint_IsOUTReceived()))
+			{
+				if (USB_DeviceState == DEVICE_STATE_Unattached)
+				  return;
+			}
+		}
+
+		/* Fetch the remaining bytes of the current packet from the OUT endpoint */
+		while (Length && Endpoint_IsReadWriteAllowed())
+		{
+			*(Buffer++) = Endpoint_Read_Byte();
+			Length--;
+		}
+	}
+}
+#endif
+
 /** Writes the next response byte to the CDC data IN endpoint, and sends the endpoint back if needed to free up the
  *  bank when full ready for the next byte in the packet to the host.
  *
@@ -295,6 +392,13 @@ void CDC_Task(void)
 		/* Read in the bootloader command (first byte sent from host) */
 		uint8_t Command = FetchNextCommandByte();
 
+		#if defined(ENABLE_PAGE_PIPELINING)
+		/* Wait for any page program started by an earlier block write to complete, except for block writes which wait
+		 * only once the next page's data has been received */
+		if (Command != 'B')
+		  boot_spm_busy_wait();
+		#endif
+
 		if ((Command == 'L') || (Command == 'P') || (Command == 'T') || (Command == 'E'))
 		{
 			if (Command == 'E')
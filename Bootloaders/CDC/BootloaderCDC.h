@@ -78,6 +78,10 @@
 		#if defined(INCLUDE_FROM_BOOTLOADERCDC_C) || defined(__DOXYGEN__)
 			static void    ReadWriteMemoryBlock(const uint8_t Command);
 			static uint8_t FetchNextCommandByte(void);
+			#if defined(ENABLE_PAGE_PIPELINING) || defined(__DOXYGEN__)
+			static void    FetchNextCommandBlock(uint8_t* Buffer,
+			                                     uint16_t Length);
+			#endif
 			static void    WriteNextResponseByte(const uint8_t Response);
 		#endif
 
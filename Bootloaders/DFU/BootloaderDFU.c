@@ -72,6 +72,22 @@ DFU_Command_t SentCommand;
  */
 uint8_t ResponseByte;
 
+#if defined(ENABLE_CRC32_COMMAND)
+/** Response to the last issued Flash CRC32 command, containing the CRC32 of the requested flash range which is sent
+ *  to the host as a four byte response when the next DFU_UPLOAD command is issued by the host.
+ */
+uint32_t ResponseCRC32;
+
+/** Lookup table for the CRC32 polynomial (0xEDB88320 in reflected form), indexed by nibble. This is kept in RAM, as
+ *  the bootloader may reside above the first 64KB of flash where it cannot be read via the near flash access routines.
+ */
+static const uint32_t CRC32NibbleTable[16] =
+	{
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+#endif
+
 /** Pointer to the start of the user application. By default this is 0x0000 (the reset vector), however the host
  *  may specify an alternate address when issuing the application soft-start command.
  */
@@ -92,6 +108,26 @@ uint16_t StartAddr = 0x0000;
  */
 uint16_t EndAddr = 0x0000;
 
+#if (SKIP_UNCHANGED_PAGES == true)
+/** Number of flash pages whose erase and write cycles were skipped since the bootloader started or the flash
+ *  was last erased, as the data sent by the host for them already matched the existing flash contents.
+ */
+uint16_t SkippedFlashPages = 0;
+#endif
+
+#if defined(ENABLE_BULK_TRANSPORT)
+/** Flag to indicate if the host has selected the vendor specific bulk transport. When set, the data of each memory
+ *  program and memory read block is transferred via the bulk OUT and IN endpoints rather than as part of the DFU_DNLOAD
+ *  and DFU_UPLOAD control requests, which continue to carry the DFU commands and manage the DFU state.
+ */
+volatile bool BulkTransport = false;
+
+/** Flag to indicate that the memory block being transferred over the bulk transport has been aborted by the host, by
+ *  resetting or reconfiguring the device or issuing a DFU_ABORT or DFU_CLRSTATUS request while the block is in progress.
+ */
+static volatile bool BulkBlockAborted = false;
+#endif
+
 
 /** Main program entry point. This routine configures the hardware required by the bootloader, then continuously 
  *  runs the bootloader processing routine until instructed to soft-exit, or hard-reset via the watchdog to start
@@ -107,7 +143,13 @@ int main(void)
 
 	/* Run the USB management task while the bootloader is supposed to be running */
 	while (RunBootloader || WaitForExit)
-	  USB_USBTask();
+	{
+		USB_USBTask();
+
+		#if defined(ENABLE_BULK_TRANSPORT)
+		BulkTransport_Task();
+		#endif
+	}
 	
 	/* Reset configured hardware back to their original states for the user application */
 	ResetHardware();
@@ -145,6 +187,127 @@ void ResetHardware(void)
 	MCUCR = 0;
 }
 
+#if defined(ENABLE_BULK_TRANSPORT)
+/** Event handler for the USB_Reset event. This abandons any use of the bulk transport, as the host must reselect it
+ *  once the device has been reconfigured.
+ */
+void EVENT_USB_Device_Reset(void)
+{
+	BulkTransport_Reset();
+}
+
+/** Event handler for the USB_ConfigurationChanged event. This configures the device's bulk transport endpoints,
+ *  ready to transfer memory block data to and from the host.
+ */
+void EVENT_USB_Device_ConfigurationChanged(void)
+{
+	BulkTransport_Reset();
+
+	/* Setup bulk transport OUT and IN endpoints */
+	Endpoint_ConfigureEndpoint(DFU_BULK_OUT_EPNUM, EP_TYPE_BULK,
+		                       ENDPOINT_DIR_OUT, DFU_BULK_EPSIZE,
+	                           ENDPOINT_BANK_SINGLE);
+
+	Endpoint_ConfigureEndpoint(DFU_BULK_IN_EPNUM, EP_TYPE_BULK,
+		                       ENDPOINT_DIR_IN, DFU_BULK_EPSIZE,
+	                           ENDPOINT_BANK_SINGLE);
+}
+
+/** Task to transfer the data of the current memory program or memory read block over the bulk transport endpoints,
+ *  once the host has selected the bulk transport and issued the corresponding command via a DFU_DNLOAD request.
+ */
+static void BulkTransport_Task(void)
+{
+	BulkBlockAborted = false;
+
+	/* Device must be configured with the bulk transport selected by the host to transfer data */
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(BulkTransport))
+	  return;
+
+	if (DFU_State == dfuDNLOAD_IDLE)
+	{
+		Endpoint_SelectEndpoint(DFU_BULK_OUT_EPNUM);
+		
+		/* Wait until the first packet of the block's data has been received from the host */
+		if (!(Endpoint_IsOUTReceived()))
+		  return;
+
+		/* Write the block's data into the selected memory */
+		WriteMemoryBlock();
+	}
+	else if (DFU_State == dfuUPLOAD_IDLE)
+	{
+		Endpoint_SelectEndpoint(DFU_BULK_IN_EPNUM);
+
+		/* Wait until the endpoint is ready for the first packet of the block's data */
+		if (!(Endpoint_IsINReady()))
+		  return;
+
+		/* Read the block's data out of the selected memory */
+		ReadMemoryBlock(DFU_BULK_EPSIZE);
+	}
+	else
+	{
+		return;
+	}
+
+	if (BulkBlockAborted)
+	{
+		/* Discard any partially filled flash page buffer and the remaining data of the aborted block */
+		boot_rww_enable();
+		Endpoint_ResetFIFO(DFU_BULK_OUT_EPNUM);
+		Endpoint_ResetFIFO(DFU_BULK_IN_EPNUM);
+	}
+	else if (DFU_State == dfuDNLOAD_IDLE)
+	{
+		/* Acknowledge the last packet of the block's data */
+		Endpoint_ClearOUT();
+	}
+	else
+	{
+		/* Send the last packet of the block's data */
+		Endpoint_ClearIN();
+	}
+
+	/* Block transfer complete, return to idle state */
+	DFU_State = dfuIDLE;
+}
+
+/** Services the control endpoint while a memory block transfer is waiting for the next packet of the block's data,
+ *  so that control requests from the host are not held off until a bulk transport block completes. Block data sent
+ *  over the control endpoint is transferred from within the control request handler, which cannot be re-entered,
+ *  so the control endpoint is only serviced while a bulk endpoint is selected.
+ *
+ *  \return Boolean true if the block transfer should continue, false if it has been aborted by the host
+ */
+static bool BulkTransport_ServiceControl(void)
+{
+	if (Endpoint_GetCurrentEndpoint() == ENDPOINT_CONTROLEP)
+	  return true;
+
+	/* The USB management task reselects the bulk endpoint once any control request has been processed */
+	USB_USBTask();
+
+	/* DFU_ABORT and DFU_CLRSTATUS requests return the device to the idle state, aborting the block */
+	if ((DFU_State != dfuDNLOAD_IDLE) && (DFU_State != dfuUPLOAD_IDLE))
+	  BulkBlockAborted = true;
+
+	return !(BulkBlockAborted);
+}
+
+/** Resets the bulk transport state when the device is reset or reconfigured by the host, abandoning any memory block
+ *  which was to be transferred over the bulk transport. The host must then reselect the bulk transport to use it again.
+ */
+static void BulkTransport_Reset(void)
+{
+	if (BulkTransport && ((DFU_State == dfuDNLOAD_IDLE) || (DFU_State == dfuUPLOAD_IDLE)))
+	  DFU_State = dfuIDLE;
+
+	BulkTransport    = false;
+	BulkBlockAborted = true;
+}
+#endif
+
 /** Event handler for the USB_UnhandledControlRequest event. This is used to catch standard and class specific
  *  control requests that are not handled internally by the USB library (including the DFU commands, which are
  *  all issued via the control endpoint), so that they can be handled appropriately for the application.
@@ -196,8 +359,12 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 				ProcessBootloaderCommand();
 			}
 			
-			/* Check if currently downloading firmware */
+			/* Check if currently downloading firmware - with the bulk transport the data is handled by its task instead */
+			#if defined(ENABLE_BULK_TRANSPORT)
+			if ((DFU_State == dfuDNLOAD_IDLE) && !(BulkTransport))
+			#else
 			if (DFU_State == dfuDNLOAD_IDLE)
+			#endif
 			{									
 				if (!(SentCommand.DataSize))
 				{
@@ -211,94 +378,9 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 					/* Throw away the packet alignment filler bytes before the start of the firmware */
 					DiscardFillerBytes(StartAddr % FIXED_CONTROL_ENDPOINT_SIZE);
 					
-					/* Calculate the number of bytes remaining to be written */
-					uint16_t BytesRemaining = ((EndAddr - StartAddr) + 1);
-					
-					if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x00))        // Write flash
-					{
-						/* Calculate the number of words to be written from the number of bytes to be written */
-						uint16_t WordsRemaining = (BytesRemaining >> 1);
-					
-						union
-						{
-							uint16_t Words[2];
-							uint32_t Long;
-						} CurrFlashAddress                 = {.Words = {StartAddr, Flash64KBPage}};
-						
-						uint32_t CurrFlashPageStartAddress = CurrFlashAddress.Long;
-						uint8_t  WordsInFlashPage          = 0;
-
-						while (WordsRemaining--)
-						{
-							/* Check if endpoint is empty - if so clear it and wait until ready for next packet */
-							if (!(Endpoint_BytesInEndpoint()))
-							{
-								Endpoint_ClearOUT();
-
-								while (!(Endpoint_IsOUTReceived()))
-								{				
-									if (USB_DeviceState == DEVICE_STATE_Unattached)
-									  return;
-								}
-							}
-
-							/* Write the next word into the current flash page */
-							boot_page_fill(CurrFlashAddress.Long, Endpoint_Read_Word_LE());
-
-							/* Adjust counters */
-							WordsInFlashPage      += 1;
-							CurrFlashAddress.Long += 2;
-
-							/* See if an entire page has been written to the flash page buffer */
-							if ((WordsInFlashPage == (SPM_PAGESIZE >> 1)) || !(WordsRemaining))
-							{
-								/* Commit the flash page to memory */
-								boot_page_write(CurrFlashPageStartAddress);
-								boot_spm_busy_wait();
-								
-								/* Check if programming incomplete */
-								if (WordsRemaining)
-								{
-									CurrFlashPageStartAddress = CurrFlashAddress.Long;
-									WordsInFlashPage          = 0;
-
-									/* Erase next page's temp buffer */
-									boot_page_erase(CurrFlashAddress.Long);
-									boot_spm_busy_wait();
-								}
-							}
-						}
-					
-						/* Once programming complete, start address equals the end address */
-						StartAddr = EndAddr;
-					
-						/* Re-enable the RWW section of flash */
-						boot_rww_enable();
-					}
-					else                                                   // Write EEPROM
-					{
-						while (BytesRemaining--)
-						{
-							/* Check if endpoint is empty - if so clear it and wait until ready for next packet */
-							if (!(Endpoint_BytesInEndpoint()))
-							{
-								Endpoint_ClearOUT();
-
-								while (!(Endpoint_IsOUTReceived()))
-								{				
-									if (USB_DeviceState == DEVICE_STATE_Unattached)
-									  return;
-								}
-							}
-
-							/* Read the byte from the USB interface and write to to the EEPROM */
-							eeprom_write_byte((uint8_t*)StartAddr, Endpoint_Read_Byte());
-							
-							/* Adjust counters */
-							StartAddr++;
-						}
-					}
-					
+					/* Write the block's data into the selected memory */
+					WriteMemoryBlock();
+
 					/* Throw away the currently unused DFU file suffix */
 					DiscardFillerBytes(DFU_FILE_SUFFIX_SIZE);
 				}
@@ -326,6 +408,13 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 					   that the memory isn't blank, and the host is requesting the first non-blank address */
 					Endpoint_Write_Word_LE(StartAddr);
 				}
+				#if defined(ENABLE_CRC32_COMMAND)
+				else if ((SentCommand.Command == COMMAND_DISP_DATA) && IS_ONEBYTE_COMMAND(SentCommand.Data, 0x03))  // CRC32 Flash
+				{
+					/* Flash CRC is calculated in the DFU_DNLOAD request - send the result to the host */
+					Endpoint_Write_DWord_LE(ResponseCRC32);
+				}
+				#endif
 				else
 				{
 					/* Idle state upload - send response to last issued command */
@@ -334,71 +423,8 @@ void EVENT_USB_Device_UnhandledControlRequest(void)
 			}
 			else
 			{
-				/* Determine the number of bytes remaining in the current block */
-				uint16_t BytesRemaining = ((EndAddr - StartAddr) + 1);
-
-				if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x00))            // Read FLASH
-				{
-					/* Calculate the number of words to be written from the number of bytes to be written */
-					uint16_t WordsRemaining = (BytesRemaining >> 1);
-
-					union
-					{
-						uint16_t Words[2];
-						uint32_t Long;
-					} CurrFlashAddress = {.Words = {StartAddr, Flash64KBPage}};
-
-					while (WordsRemaining--)
-					{
-						/* Check if endpoint is full - if so clear it and wait until ready for next packet */
-						if (Endpoint_BytesInEndpoint() == FIXED_CONTROL_ENDPOINT_SIZE)
-						{
-							Endpoint_ClearIN();
-
-							while (!(Endpoint_IsINReady()))
-							{				
-								if (USB_DeviceState == DEVICE_STATE_Unattached)
-								  return;
-							}
-						}
-
-						/* Read the flash word and send it via USB to the host */
-						#if (FLASHEND > 0xFFFF)
-							Endpoint_Write_Word_LE(pgm_read_word_far(CurrFlashAddress.Long));
-						#else
-							Endpoint_Write_Word_LE(pgm_read_word(CurrFlashAddress.Long));							
-						#endif
-
-						/* Adjust counters */
-						CurrFlashAddress.Long += 2;
-					}
-					
-					/* Once reading is complete, start address equals the end address */
-					StartAddr = EndAddr;
-				}
-				else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x02))       // Read EEPROM
-				{
-					while (BytesRemaining--)
-					{
-						/* Check if endpoint is full - if so clear it and wait until ready for next packet */
-						if (Endpoint_BytesInEndpoint() == FIXED_CONTROL_ENDPOINT_SIZE)
-						{
-							Endpoint_ClearIN();
-							
-							while (!(Endpoint_IsINReady()))
-							{				
-								if (USB_DeviceState == DEVICE_STATE_Unattached)
-								  return;
-							}
-						}
-
-						/* Read the EEPROM byte and send it via USB to the host */
-						Endpoint_Write_Byte(eeprom_read_byte((uint8_t*)StartAddr));
-
-						/* Adjust counters */
-						StartAddr++;
-					}
-				}
+				/* Read the block's data out of the selected memory */
+				ReadMemoryBlock(FIXED_CONTROL_ENDPOINT_SIZE);
 
 				/* Return to idle state */
 				DFU_State = dfuIDLE;
@@ -484,6 +510,222 @@ static void DiscardFillerBytes(uint8_t NumberOfBytes)
 	}
 }
 
+/** Writes the data of the current memory program block from the host into the FLASH or EEPROM memory selected
+ *  by the last issued Memory Program command. The data is read from the currently selected endpoint, which may be
+ *  either the control endpoint or the bulk OUT endpoint of the bulk transport.
+ */
+static void WriteMemoryBlock(void)
+{
+	/* Calculate the number of bytes remaining to be written */
+	uint16_t BytesRemaining = ((EndAddr - StartAddr) + 1);
+	
+	if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x00))        // Write flash
+	{
+		/* Calculate the number of words to be written from the number of bytes to be written */
+		uint16_t WordsRemaining = (BytesRemaining >> 1);
+	
+		union
+		{
+			uint16_t Words[2];
+			uint32_t Long;
+		} CurrFlashAddress                 = {.Words = {StartAddr, Flash64KBPage}};
+		
+		uint32_t CurrFlashPageStartAddress = (CurrFlashAddress.Long & ~((uint32_t)SPM_PAGESIZE - 1));
+
+		#if (SKIP_UNCHANGED_PAGES == true)
+		/* Words of a partially written first page which precede the start address are left blank */
+		bool PageChanged = (FindNonBlankFlashAddress(CurrFlashPageStartAddress, CurrFlashAddress.Long) != CurrFlashAddress.Long);
+		#endif
+
+		while (WordsRemaining--)
+		{
+			/* Check if endpoint is empty - if so clear it and wait until ready for next packet */
+			if (!(Endpoint_BytesInEndpoint()))
+			{
+				Endpoint_ClearOUT();
+
+				while (!(Endpoint_IsOUTReceived()))
+				{				
+					if (USB_DeviceState == DEVICE_STATE_Unattached)
+					  return;
+
+					#if defined(ENABLE_BULK_TRANSPORT)
+					if (!(BulkTransport_ServiceControl()))
+					  return;
+					#endif
+				}
+			}
+
+			uint16_t FlashWord = Endpoint_Read_Word_LE();
+
+			#if (SKIP_UNCHANGED_PAGES == true)
+			/* Compare the new word against the existing flash contents */
+			#if (FLASHEND > 0xFFFF)
+			if (pgm_read_word_far(CurrFlashAddress.Long) != FlashWord)
+			#else
+			if (pgm_read_word(CurrFlashAddress.Long) != FlashWord)
+			#endif
+			  PageChanged = true;
+			#endif
+
+			/* Write the next word into the current flash page */
+			boot_page_fill(CurrFlashAddress.Long, FlashWord);
+
+			/* Adjust counters */
+			CurrFlashAddress.Long += 2;
+
+			/* See if an entire page has been written to the flash page buffer */
+			if (!(CurrFlashAddress.Words[0] & (SPM_PAGESIZE - 1)) || !(WordsRemaining))
+			{
+				#if (SKIP_UNCHANGED_PAGES == true)
+				/* Words of a partially written last page which follow the end address are left blank */
+				if (!(PageChanged) && (FindNonBlankFlashAddress(CurrFlashAddress.Long, CurrFlashPageStartAddress + SPM_PAGESIZE) !=
+				                      (CurrFlashPageStartAddress + SPM_PAGESIZE)))
+				  PageChanged = true;
+
+				if (PageChanged)
+				#endif
+				{
+					/* Erase the flash page and commit the page buffer to memory */
+					boot_page_erase(CurrFlashPageStartAddress);
+					boot_spm_busy_wait();
+					boot_page_write(CurrFlashPageStartAddress);
+					boot_spm_busy_wait();
+				}
+				#if (SKIP_UNCHANGED_PAGES == true)
+				else
+				{
+					SkippedFlashPages++;
+				}
+
+				PageChanged = false;
+				#endif
+
+				/* Re-enable the RWW section of flash, clearing the page buffer for the next page */
+				boot_rww_enable();
+
+				CurrFlashPageStartAddress = CurrFlashAddress.Long;
+			}
+		}
+	
+		/* Once programming complete, start address equals the end address */
+		StartAddr = EndAddr;
+	}
+	else                                                   // Write EEPROM
+	{
+		while (BytesRemaining--)
+		{
+			/* Check if endpoint is empty - if so clear it and wait until ready for next packet */
+			if (!(Endpoint_BytesInEndpoint()))
+			{
+				Endpoint_ClearOUT();
+
+				while (!(Endpoint_IsOUTReceived()))
+				{				
+					if (USB_DeviceState == DEVICE_STATE_Unattached)
+					  return;
+
+					#if defined(ENABLE_BULK_TRANSPORT)
+					if (!(BulkTransport_ServiceControl()))
+					  return;
+					#endif
+				}
+			}
+
+			/* Read the byte from the USB interface and write to to the EEPROM */
+			eeprom_write_byte((uint8_t*)StartAddr, Endpoint_Read_Byte());
+			
+			/* Adjust counters */
+			StartAddr++;
+		}
+	}
+}
+
+/** Reads the data of the current memory read block from the FLASH or EEPROM memory selected by the last issued
+ *  Memory Read command, and sends it to the host. The data is written to the currently selected endpoint, which may
+ *  be either the control endpoint or the bulk IN endpoint of the bulk transport.
+ *
+ *  \param[in] EndpointSize  Size in bytes of the currently selected endpoint's bank
+ */
+static void ReadMemoryBlock(const uint8_t EndpointSize)
+{
+	/* Determine the number of bytes remaining in the current block */
+	uint16_t BytesRemaining = ((EndAddr - StartAddr) + 1);
+
+	if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x00))            // Read FLASH
+	{
+		/* Calculate the number of words to be written from the number of bytes to be written */
+		uint16_t WordsRemaining = (BytesRemaining >> 1);
+
+		union
+		{
+			uint16_t Words[2];
+			uint32_t Long;
+		} CurrFlashAddress = {.Words = {StartAddr, Flash64KBPage}};
+
+		while (WordsRemaining--)
+		{
+			/* Check if endpoint is full - if so clear it and wait until ready for next packet */
+			if (Endpoint_BytesInEndpoint() == EndpointSize)
+			{
+				Endpoint_ClearIN();
+
+				while (!(Endpoint_IsINReady()))
+				{				
+					if (USB_DeviceState == DEVICE_STATE_Unattached)
+					  return;
+
+					#if defined(ENABLE_BULK_TRANSPORT)
+					if (!(BulkTransport_ServiceControl()))
+					  return;
+					#endif
+				}
+			}
+
+			/* Read the flash word and send it via USB to the host */
+			#if (FLASHEND > 0xFFFF)
+				Endpoint_Write_Word_LE(pgm_read_word_far(CurrFlashAddress.Long));
+			#else
+				Endpoint_Write_Word_LE(pgm_read_word(CurrFlashAddress.Long));							
+			#endif
+
+			/* Adjust counters */
+			CurrFlashAddress.Long += 2;
+		}
+		
+		/* Once reading is complete, start address equals the end address */
+		StartAddr = EndAddr;
+	}
+	else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x02))       // Read EEPROM
+	{
+		while (BytesRemaining--)
+		{
+			/* Check if endpoint is full - if so clear it and wait until ready for next packet */
+			if (Endpoint_BytesInEndpoint() == EndpointSize)
+			{
+				Endpoint_ClearIN();
+				
+				while (!(Endpoint_IsINReady()))
+				{				
+					if (USB_DeviceState == DEVICE_STATE_Unattached)
+					  return;
+
+					#if defined(ENABLE_BULK_TRANSPORT)
+					if (!(BulkTransport_ServiceControl()))
+					  return;
+					#endif
+				}
+			}
+
+			/* Read the EEPROM byte and send it via USB to the host */
+			Endpoint_Write_Byte(eeprom_read_byte((uint8_t*)StartAddr));
+
+			/* Adjust counters */
+			StartAddr++;
+		}
+	}
+}
+
 /** Routine to process an issued command from the host, via a DFU_DNLOAD request wrapper. This routine ensures
  *  that the command is allowed based on the current secure mode flag value, and passes the command off to the
  *  appropriate handler function.
@@ -560,21 +802,7 @@ static void ProcessMemProgCommand(void)
 	{
 		/* Load in the start and ending read addresses */
 		LoadStartEndAddresses();
-		
-		/* If FLASH is being written to, we need to pre-erase the first page to write to */
-		if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x00))
-		{
-			union
-			{
-				uint16_t Words[2];
-				uint32_t Long;
-			} CurrFlashAddress = {.Words = {StartAddr, Flash64KBPage}};
-			
-			/* Erase the current page's temp buffer */
-			boot_page_erase(CurrFlashAddress.Long);
-			boot_spm_busy_wait();
-		}
-		
+
 		/* Set the state so that the next DNLOAD requests reads in the firmware */
 		DFU_State = dfuDNLOAD_IDLE;
 	}
@@ -597,31 +825,36 @@ static void ProcessMemReadCommand(void)
 	}
 	else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x01))                       // Blank check FLASH command
 	{
-		uint32_t CurrFlashAddress = 0;
+		uint32_t NonBlankFlashAddress = FindNonBlankFlashAddress(0, BOOT_START_ADDR);
 
-		while (CurrFlashAddress < BOOT_START_ADDR)
+		/* Check if a non-blank byte was found in the application section */
+		if (NonBlankFlashAddress != BOOT_START_ADDR)
 		{
-			/* Check if the current byte is not blank */
-			#if (FLASHEND > 0xFFFF)
-			if (pgm_read_byte_far(CurrFlashAddress) != 0xFF)
-			#else
-			if (pgm_read_byte(CurrFlashAddress) != 0xFF)
-			#endif
-			{
-				/* Save the location of the first non-blank byte for response back to the host */
-				Flash64KBPage = (CurrFlashAddress >> 16);
-				StartAddr     = CurrFlashAddress;
-			
-				/* Set state and status variables to the appropriate error values */
-				DFU_State  = dfuERROR;
-				DFU_Status = errCHECK_ERASED;
+			/* Save the location of the first non-blank byte for response back to the host */
+			Flash64KBPage = (NonBlankFlashAddress >> 16);
+			StartAddr     = NonBlankFlashAddress;
+		
+			/* Set state and status variables to the appropriate error values */
+			DFU_State  = dfuERROR;
+			DFU_Status = errCHECK_ERASED;
+		}
+	}
+	#if defined(ENABLE_CRC32_COMMAND)
+	else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x03))                       // CRC32 FLASH command
+	{
+		/* Load in the start and ending addresses of the range to check */
+		LoadStartEndAddresses();
 
-				break;
-			}
+		union
+		{
+			uint16_t Words[2];
+			uint32_t Long;
+		} FlashStartAddress = {.Words = {StartAddr, Flash64KBPage}},
+		  FlashEndAddress   = {.Words = {EndAddr,   Flash64KBPage}};
 
-			CurrFlashAddress++;
-		}
+		ResponseCRC32 = CalculateFlashCRC32(FlashStartAddress.Long, (FlashEndAddress.Long + 1));
 	}
+	#endif
 }
 
 /** Handler for a Data Write command issued by the host. This routine handles non-programming commands such as
@@ -683,7 +916,19 @@ static void ProcessWriteCommand(void)
 					
 		/* Memory has been erased, reset the security bit so that programming/reading is allowed */
 		IsSecure = false;
+
+		#if (SKIP_UNCHANGED_PAGES == true)
+		/* Reset the skipped page count for the next programming session */
+		SkippedFlashPages = 0;
+		#endif
+	}
+	#if defined(ENABLE_BULK_TRANSPORT)
+	else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x04))                      // Select data transport
+	{
+		/* Transfer subsequent memory block data via the bulk endpoints if requested, or the control endpoint otherwise */
+		BulkTransport = (SentCommand.Data[1] == 0x01);
 	}
+	#endif
 }
 
 /** Handler for a Data Read command issued by the host. This routine handles bootloader information retrieval
@@ -700,4 +945,69 @@ static void ProcessReadCommand(void)
 	  ResponseByte = BootloaderInfo[DataIndexToRead];
 	else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x01))                    // Read signature byte
 	  ResponseByte = SignatureInfo[DataIndexToRead - 0x30];
+	#if (SKIP_UNCHANGED_PAGES == true)
+	else if (IS_ONEBYTE_COMMAND(SentCommand.Data, 0x02))                    // Read skipped flash page count
+	  ResponseByte = (DataIndexToRead ? (SkippedFlashPages >> 8) : (SkippedFlashPages & 0xFF));
+	#endif
+}
+
+/** Locates the first non-blank (non 0xFF) byte within the given range of flash memory. Blank flash is skipped a double
+ *  word at a time, with only the final double word containing the non-blank data examined byte by byte.
+ *
+ *  \param[in] StartAddress  Address of the first flash byte to check
+ *  \param[in] EndAddress    Address immediately following the last flash byte to check
+ *
+ *  \return Address of the first non-blank byte in the range, or EndAddress if the entire range is blank
+ */
+static uint32_t FindNonBlankFlashAddress(uint32_t StartAddress, const uint32_t EndAddress)
+{
+	/* Skip over blank flash four bytes at a time */
+	#if (FLASHEND > 0xFFFF)
+	while (((EndAddress - StartAddress) >= 4) && (pgm_read_dword_far(StartAddress) == 0xFFFFFFFF))
+	#else
+	while (((EndAddress - StartAddress) >= 4) && (pgm_read_dword(StartAddress) == 0xFFFFFFFF))
+	#endif
+	  StartAddress += 4;
+
+	/* Find the exact non-blank byte in the remaining bytes, if any */
+	#if (FLASHEND > 0xFFFF)
+	while ((StartAddress < EndAddress) && (pgm_read_byte_far(StartAddress) == 0xFF))
+	#else
+	while ((StartAddress < EndAddress) && (pgm_read_byte(StartAddress) == 0xFF))
+	#endif
+	  StartAddress++;
+
+	return StartAddress;
+}
+
+#if defined(ENABLE_CRC32_COMMAND)
+/** Calculates the standard (IEEE 802.3) CRC32 of the given range of flash memory, so that the host can verify
+ *  the device's flash contents without reading them back in full.
+ *
+ *  \param[in] StartAddress  Address of the first flash byte to include in the CRC
+ *  \param[in] EndAddress    Address immediately following the last flash byte to include in the CRC
+ *
+ *  \return CRC32 of the given flash memory range
+ */
+static uint32_t CalculateFlashCRC32(uint32_t StartAddress, const uint32_t EndAddress)
+{
+	uint32_t CRC32 = 0xFFFFFFFF;
+
+	while (StartAddress < EndAddress)
+	{
+		#if (FLASHEND > 0xFFFF)
+		CRC32 ^= pgm_read_byte_far(StartAddress);
+		#else
+		CRC32 ^= pgm_read_byte(StartAddress);
+		#endif
+
+		/* Process the byte one nibble at a time via the lookup table */
+		CRC32 = ((CRC32 >> 4) ^ CRC32NibbleTable[CRC32 & 0x0F]);
+		CRC32 = ((CRC32 >> 4) ^ CRC32NibbleTable[CRC32 & 0x0F]);
+
+		StartAddress++;
+	}
+
+	return ~CRC32;
 }
+#endif
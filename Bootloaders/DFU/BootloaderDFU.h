@@ -58,6 +58,17 @@
 		 */
 		#define SECURE_MODE              false
 
+		/** Configuration define. Define this token to true to cause the bootloader to compare each incoming flash page
+		 *  against the existing flash contents, skipping the erase and write cycles of pages which are unchanged. This
+		 *  reduces programming time and flash wear when only part of an application changes between uploads, at the
+		 *  expense of a larger bootloader. When false, every page in the range sent by the host is erased and rewritten.
+		 */
+		#define SKIP_UNCHANGED_PAGES     false
+
+		#if defined(ENABLE_BULK_TRANSPORT) && defined(CONTROL_ONLY_DEVICE)
+			#error CONTROL_ONLY_DEVICE must be removed from the makefile LUFA_OPTS when ENABLE_BULK_TRANSPORT is defined.
+		#endif
+
 		/** Major bootloader version number. */
 		#define BOOTLOADER_VERSION_MINOR 2
 
@@ -193,15 +204,33 @@
 		void ResetHardware(void);
 
 		void EVENT_USB_Device_UnhandledControlRequest(void);
+		
+		#if defined(ENABLE_BULK_TRANSPORT)
+			void EVENT_USB_Device_Reset(void);
+			void EVENT_USB_Device_ConfigurationChanged(void);
+		#endif
 
 		#if defined(INCLUDE_FROM_BOOTLOADER_C)
 			static void DiscardFillerBytes(uint8_t NumberOfBytes);
+			static void WriteMemoryBlock(void);
+			static void ReadMemoryBlock(const uint8_t EndpointSize);
 			static void ProcessBootloaderCommand(void);
 			static void LoadStartEndAddresses(void);
 			static void ProcessMemProgCommand(void);
 			static void ProcessMemReadCommand(void);
 			static void ProcessWriteCommand(void);
 			static void ProcessReadCommand(void);
+			static uint32_t FindNonBlankFlashAddress(uint32_t StartAddress, const uint32_t EndAddress);
+
+			#if defined(ENABLE_CRC32_COMMAND)
+			static uint32_t CalculateFlashCRC32(uint32_t StartAddress, const uint32_t EndAddress);
+			#endif
+			
+			#if defined(ENABLE_BULK_TRANSPORT)
+			static void BulkTransport_Task(void);
+			static bool BulkTransport_ServiceControl(void);
+			static void BulkTransport_Reset(void);
+			#endif
 		#endif
 		
 #endif
@@ -76,7 +76,11 @@ USB_Descriptor_Configuration_t ConfigurationDescriptor =
 			.Header                   = {.Size = sizeof(USB_Descriptor_Configuration_Header_t), .Type = DTYPE_Configuration},
 
 			.TotalConfigurationSize   = sizeof(USB_Descriptor_Configuration_t),
+			#if defined(ENABLE_BULK_TRANSPORT)
+			.TotalInterfaces          = 2,
+			#else
 			.TotalInterfaces          = 1,
+			#endif
 
 			.ConfigurationNumber      = 1,
 			.ConfigurationStrIndex    = NO_DESCRIPTOR,
@@ -112,7 +116,45 @@ USB_Descriptor_Configuration_t ConfigurationDescriptor =
 			.TransferSize           = 0x0c00,
 		
 			.DFUSpecification       = VERSION_BCD(01.01)
-		}
+		},
+
+	#if defined(ENABLE_BULK_TRANSPORT)
+	.Bulk_Interface = 
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Interface_t), .Type = DTYPE_Interface},
+
+			.InterfaceNumber        = 1,
+			.AlternateSetting       = 0,
+			
+			.TotalEndpoints         = 2,
+				
+			.Class                  = 0xFF,
+			.SubClass               = 0x00,
+			.Protocol               = 0x00,
+
+			.InterfaceStrIndex      = NO_DESCRIPTOR
+		},
+
+	.Bulk_DataOutEndpoint = 
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Endpoint_t), .Type = DTYPE_Endpoint},
+										 
+			.EndpointAddress        = (ENDPOINT_DESCRIPTOR_DIR_OUT | DFU_BULK_OUT_EPNUM),
+			.Attributes             = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
+			.EndpointSize           = DFU_BULK_EPSIZE,
+			.PollingIntervalMS      = 0x00
+		},
+
+	.Bulk_DataInEndpoint = 
+		{
+			.Header                 = {.Size = sizeof(USB_Descriptor_Endpoint_t), .Type = DTYPE_Endpoint},
+										 
+			.EndpointAddress        = (ENDPOINT_DESCRIPTOR_DIR_IN | DFU_BULK_IN_EPNUM),
+			.Attributes             = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
+			.EndpointSize           = DFU_BULK_EPSIZE,
+			.PollingIntervalMS      = 0x00
+		},
+	#endif
 };
 
 /** Language descriptor structure. This descriptor, located in FLASH memory, is returned when the host requests
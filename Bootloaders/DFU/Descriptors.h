@@ -63,6 +63,17 @@
 		 */		
 		#define ATTR_CAN_DOWNLOAD                 (1 << 0)
 
+		#if defined(ENABLE_BULK_TRANSPORT) || defined(__DOXYGEN__)
+			/** Endpoint number of the bulk transport OUT endpoint, used to receive memory program block data from the host. */
+			#define DFU_BULK_OUT_EPNUM            1
+
+			/** Endpoint number of the bulk transport IN endpoint, used to send memory read block data to the host. */
+			#define DFU_BULK_IN_EPNUM             2
+
+			/** Size in bytes of the bulk transport OUT and IN endpoints. */
+			#define DFU_BULK_EPSIZE               64
+		#endif
+
 		#if defined(__AVR_AT90USB1287__)
 			#define PRODUCT_ID_CODE               0x2FFB
 			#define AVR_SIGNATURE_1               0x1E
@@ -163,6 +174,12 @@
 			USB_Descriptor_Configuration_Header_t Config;
 			USB_Descriptor_Interface_t            DFU_Interface;
 			USB_DFU_Functional_Descriptor_t       DFU_Functional;
+
+			#if defined(ENABLE_BULK_TRANSPORT)
+			USB_Descriptor_Interface_t            Bulk_Interface;
+			USB_Descriptor_Endpoint_t             Bulk_DataOutEndpoint;
+			USB_Descriptor_Endpoint_t             Bulk_DataInEndpoint;
+			#endif
 		} USB_Descriptor_Configuration_t;
 		
 	/* Function Prototypes: */
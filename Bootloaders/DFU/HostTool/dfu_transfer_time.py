@@ -0,0 +1,215 @@
+#!/usr/bin/env python
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2010.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#      www.fourwalledcubicle.com
+#
+
+# Host tool to measure the time taken to program (and optionally verify) a raw
+# binary flash image with the DFU bootloader, over the standard control endpoint
+# transport and/or the vendor specific bulk transport enabled by compiling the
+# bootloader with ENABLE_BULK_TRANSPORT. Requires PyUSB 1.0 or later, and the
+# bootloader to be bound to a libusb compatible driver.
+#
+# Usage: dfu_transfer_time.py [--pid PID] [--transport control|bulk|both]
+#                             [--verify none|readback|crc] IMAGE
+
+import argparse
+import binascii
+import struct
+import sys
+import time
+
+import usb.core
+import usb.util
+
+ATMEL_VID         = 0x03EB
+
+DFU_DNLOAD        = 0x01
+DFU_UPLOAD        = 0x02
+DFU_GETSTATUS     = 0x03
+DFU_CLRSTATUS     = 0x04
+
+REQTYPE_DFU_OUT   = 0x21
+REQTYPE_DFU_IN    = 0xA1
+
+BULK_INTERFACE    = 1
+BULK_OUT_EP       = 0x01
+BULK_IN_EP        = 0x82
+
+BLOCK_SIZE        = 2048
+FILLER_BYTES_SIZE = 26
+FILE_SUFFIX_SIZE  = 16
+CONTROL_EPSIZE    = 32
+
+USB_TIMEOUT_MS    = 5000
+
+class DFUDevice(object):
+    def __init__(self, pid):
+        self.dev = usb.core.find(idVendor=ATMEL_VID, idProduct=pid)
+        if self.dev is None:
+            raise IOError("DFU bootloader with PID 0x%04X not found" % pid)
+
+        self.dev.set_configuration()
+        self.has_bulk = (self.dev.get_active_configuration().bNumInterfaces > BULK_INTERFACE)
+
+        if self.has_bulk:
+            usb.util.claim_interface(self.dev, BULK_INTERFACE)
+
+    def dnload(self, data):
+        self.dev.ctrl_transfer(REQTYPE_DFU_OUT, DFU_DNLOAD, 0, 0, bytes(data), USB_TIMEOUT_MS)
+
+    def upload(self, length):
+        return bytes(self.dev.ctrl_transfer(REQTYPE_DFU_IN, DFU_UPLOAD, 0, 0, length, USB_TIMEOUT_MS))
+
+    def check_status(self):
+        (status, _, _, _, state, _) = struct.unpack("<BBHBBB", bytes(self.dev.ctrl_transfer(REQTYPE_DFU_IN, DFU_GETSTATUS,
+                                                                                             0, 0, 6, USB_TIMEOUT_MS)))
+        if status != 0:
+            self.dev.ctrl_transfer(REQTYPE_DFU_OUT, DFU_CLRSTATUS, 0, 0, None, USB_TIMEOUT_MS)
+            raise IOError("DFU command failed with status %u (state %u)" % (status, state))
+
+    def command(self, data):
+        self.dnload(data)
+        self.check_status()
+
+    def select_transport(self, bulk):
+        if bulk and not self.has_bulk:
+            raise IOError("bootloader was not compiled with ENABLE_BULK_TRANSPORT")
+
+        if self.has_bulk:
+            self.command([0x04, 0x04, 0x01 if bulk else 0x00])
+
+    def select_64kb_page(self, page):
+        self.command([0x06, 0x03, 0x00, page])
+
+    def erase(self):
+        self.command([0x04, 0x00, 0xFF])
+
+    def program_block(self, address, data, bulk):
+        start   = address & 0xFFFF
+        end     = start + len(data) - 1
+        command = [0x01, 0x00, start >> 8, start & 0xFF, end >> 8, end & 0xFF]
+
+        if bulk:
+            # Command is sent via the control endpoint, block data via the bulk OUT endpoint
+            self.dnload(command)
+            self.dev.write(BULK_OUT_EP, bytes(data), USB_TIMEOUT_MS)
+        else:
+            filler = bytes(FILLER_BYTES_SIZE + (start % CONTROL_EPSIZE))
+            self.dnload(bytes(command) + filler + bytes(data) + bytes(FILE_SUFFIX_SIZE))
+
+        self.check_status()
+
+    def read_block(self, address, length, bulk):
+        start = address & 0xFFFF
+        end   = start + length - 1
+
+        if bulk:
+            # The bootloader streams the block as soon as the command is received, so the data must be read
+            # from the bulk IN endpoint before the status of the command can be retrieved
+            self.dnload([0x03, 0x00, start >> 8, start & 0xFF, end >> 8, end & 0xFF])
+            data = bytes(self.dev.read(BULK_IN_EP, length, USB_TIMEOUT_MS))
+            self.check_status()
+            return data
+        else:
+            self.command([0x03, 0x00, start >> 8, start & 0xFF, end >> 8, end & 0xFF])
+            return self.upload(length)
+
+    def crc32_block(self, address, length):
+        start = address & 0xFFFF
+        end   = start + length - 1
+        self.command([0x03, 0x03, start >> 8, start & 0xFF, end >> 8, end & 0xFF])
+
+        response = self.upload(4)
+        if len(response) != 4:
+            raise IOError("bootloader was not compiled with ENABLE_CRC32_COMMAND")
+
+        return struct.unpack("<I", response)[0]
+
+def blocks(image):
+    # Blocks are aligned so that none crosses a 64KB flash page boundary
+    for address in range(0, len(image), BLOCK_SIZE):
+        yield (address, image[address : address + BLOCK_SIZE])
+
+def program(device, image, bulk):
+    device.select_transport(bulk)
+    current_page = None
+
+    for (address, data) in blocks(image):
+        if (address >> 16) != current_page:
+            current_page = (address >> 16)
+            device.select_64kb_page(current_page)
+
+        device.program_block(address, data, bulk)
+
+    # Zero length download ends the programming session
+    device.dnload([])
+
+def verify(device, image, bulk, method):
+    device.select_transport(bulk)
+    current_page = None
+
+    for (address, data) in blocks(image):
+        if (address >> 16) != current_page:
+            current_page = (address >> 16)
+            device.select_64kb_page(current_page)
+
+        if method == "crc":
+            matches = (device.crc32_block(address, len(data)) == (binascii.crc32(data) & 0xFFFFFFFF))
+        else:
+            matches = (device.read_block(address, len(data), bulk) == data)
+
+        if not matches:
+            raise IOError("verification failed in block at address 0x%05X" % address)
+
+def main():
+    parser = argparse.ArgumentParser(description="Measure DFU bootloader programming time over each data transport.")
+    parser.add_argument("--pid", type=lambda x: int(x, 0), default=0x2FFB, help="bootloader USB product ID")
+    parser.add_argument("--transport", choices=["control", "bulk", "both"], default="both", help="data transport(s) to measure")
+    parser.add_argument("--verify", choices=["none", "readback", "crc"], default="none", help="verification method")
+    parser.add_argument("--no-erase", action="store_true", help="don't erase the flash before each programming run")
+    parser.add_argument("image", help="raw binary flash image to program")
+    args = parser.parse_args()
+
+    image = bytearray(open(args.image, "rb").read())
+    if len(image) % 2:
+        image.append(0xFF)
+    image = bytes(image)
+
+    device     = DFUDevice(args.pid)
+    transports = ["control", "bulk"] if (args.transport == "both") else [args.transport]
+
+    for transport in transports:
+        bulk = (transport == "bulk")
+
+        if not args.no_erase:
+            device.select_transport(False)
+            device.erase()
+
+        start_time = time.time()
+        program(device, image, bulk)
+        program_time = time.time() - start_time
+
+        line = "%-7s  %6u bytes  program %7.3f s (%6.1f KB/s)" % (transport, len(image), program_time,
+                                                                 (len(image) / 1024.0) / program_time)
+
+        if args.verify != "none":
+            start_time = time.time()
+            verify(device, image, bulk, args.verify)
+            verify_time = time.time() - start_time
+
+            line += "  verify (%s) %7.3f s  total %7.3f s" % (args.verify, verify_time, program_time + verify_time)
+
+        print(line)
+
+    device.select_transport(False)
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (IOError, usb.core.USBError) as error:
+        sys.stderr.write("Error: %s\n" % error)
+        sys.exit(1)
@@ -0,0 +1,108 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Block device backend interface of the Mass Storage demo. Each Logical Unit of the device is served by a backend which
+ *  transfers whole blocks of \ref VIRTUAL_MEMORY_BLOCK_SIZE bytes between its storage medium and the Mass Storage data
+ *  endpoints, so that the SCSI command processing is independent of the medium being used.
+ */
+ 
+#ifndef _BLOCK_DEVICE_H_
+#define _BLOCK_DEVICE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+
+		#include <LUFA/Drivers/USB/USB.h>
+		#include <LUFA/Drivers/USB/Class/MassStorage.h>
+
+	/* Type Defines: */
+		/** Type define for a block device backend, holding the routines used by the SCSI command processing to access the
+		 *  storage medium of a Logical Unit. The block addresses passed to the routines are relative to the start of the
+		 *  Logical Unit, and have been checked against the total blocks reported by the backend.
+		 *
+		 *  Backends may leave an operation running when a routine returns, such as the program of written data into the
+		 *  medium, and complete it from the backend's task routine or at the start of its next transfer, so that the host
+		 *  does not have to wait for it before issuing the next command.
+		 */
+		typedef struct
+		{
+			/** Routine to retrieve the total number of blocks of the Logical Unit's storage medium.
+			 *
+			 *  \param[in] LUN  Index of the Logical Unit the backend is serving
+			 *
+			 *  \return Total number of blocks of the Logical Unit
+			 */
+			uint32_t (*GetTotalBlocks)(const uint8_t LUN);
+
+			/** Routine to read blocks from the storage medium, writing them to the data IN endpoint.
+			 *
+			 *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+			 *  \param[in] BlockAddress     Data block to start reading from
+			 *  \param[in] TotalBlocks      Number of blocks of data to read
+			 *
+			 *  \return Boolean true if the blocks were read successfully, false otherwise
+			 */
+			bool (*ReadBlocks)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                   const uint32_t BlockAddress,
+			                   uint32_t TotalBlocks);
+
+			/** Routine to write blocks read from the data OUT endpoint to the storage medium.
+			 *
+			 *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+			 *  \param[in] BlockAddress     Data block to start writing to
+			 *  \param[in] TotalBlocks      Number of blocks of data to write
+			 *
+			 *  \return Boolean true if the blocks were written successfully, false otherwise
+			 */
+			bool (*WriteBlocks)(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                    const uint32_t BlockAddress,
+			                    uint32_t TotalBlocks);
+
+			/** Routine to check that the storage medium is present and functioning, for the SCSI SEND DIAGNOSTIC command.
+			 *
+			 *  \return Boolean true if the medium is functioning correctly, false otherwise
+			 */
+			bool (*CheckOperation)(void);
+
+			/** Routine to commit any written data held in volatile storage by the backend to the storage medium, returning
+			 *  once it has been committed, or NULL if the backend does not hold written data between commands.
+			 */
+			void (*Flush)(void);
+
+			/** Routine called repeatedly from the main program loop to complete any operations left running by the
+			 *  backend, or NULL if the backend has no background processing.
+			 */
+			void (*Task)(void);
+		} BlockDevice_Backend_t;
+
+#endif
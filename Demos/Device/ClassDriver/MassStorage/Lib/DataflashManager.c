@@ -39,6 +39,58 @@
 #define  INCLUDE_FROM_DATAFLASHMANAGER_C
 #include "DataflashManager.h"
 
+/** Indicates if a Dataflash buffer holds written data which has not yet been programmed into main memory. */
+static bool     WritePending;
+
+/** Indicates which of the two Dataflash buffers of each Dataflash IC is to be filled with the next written page of that IC,
+ *  the other buffer possibly still being programmed into main memory. This is retained between commands, so that a page can
+ *  be written into one IC while the other IC or the other buffer of the same IC is still being programmed.
+ */
+static bool     UsingSecondBuffer[DATAFLASH_TOTALCHIPS];
+
+/** Dataflash page address of the page held in the pending write buffer. */
+static uint16_t PendingDFPage;
+
+/** Physical Dataflash page address the pending write buffer is to be programmed into, which differs from the page address
+ *  presented to the host when the flash translation layer is enabled.
+ */
+static uint16_t PendingPhysicalDFPage;
+
+/** Physical Dataflash page address holding the previous contents of the page held in the pending write buffer. */
+static uint16_t PendingReplacedDFPage;
+
+/** Number of 16 byte chunks of the pending write buffer filled by the last write command. */
+static uint8_t  PendingDFPageByteDiv16;
+
+/** Block address following the last block written, at which a new write command must start to continue filling the
+ *  pending write buffer.
+ */
+static uint32_t PendingNextBlockAddress;
+
+/** Number of milliseconds since the last write command, saturating at \ref DATAFLASH_WRITE_IDLE_TIMEOUT_MS. */
+static uint16_t WriteIdleTicks;
+
+#if (DATAFLASH_READ_CACHE_SLOTS > 0)
+/** Blocks held in RAM by the read cache, so that frequently read blocks are not re-read from the Dataflash. */
+static DataflashManager_CachedBlock_t ReadCache[DATAFLASH_READ_CACHE_SLOTS];
+
+/** Counter incremented on each read cache access, for the least recently used block replacement. */
+static uint16_t ReadCacheUseCount;
+#endif
+
+/** Block device backend serving Logical Units from the Dataflash, each Logical Unit being given its own equal portion of
+ *  \ref LUN_MEDIA_BLOCKS blocks of the Dataflash.
+ */
+const BlockDevice_Backend_t DataflashManager_Backend =
+	{
+		.GetTotalBlocks = DataflashManager_GetLUNBlocks,
+		.ReadBlocks     = DataflashManager_ReadLUNBlocks,
+		.WriteBlocks    = DataflashManager_WriteLUNBlocks,
+		.CheckOperation = DataflashManager_CheckDataflashOperation,
+		.Flush          = DataflashManager_SyncWrites,
+		.Task           = DataflashManager_Task,
+	};
+
 /** Writes blocks (OS blocks, not Dataflash pages) to the storage medium, the board Dataflash IC(s), from
  *  the pre-selected data OUT endpoint. This routine reads in OS sized blocks from the endpoint and writes
  *  them to the Dataflash in Dataflash page sized blocks.
@@ -51,32 +103,46 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
                                   const uint32_t BlockAddress,
                                   uint16_t TotalBlocks)
 {
-	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
-	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
-	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
-	bool     UsingSecondBuffer   = false;
+	uint32_t NextBlockAddress = (BlockAddress + TotalBlocks);
+	uint32_t CurrBlockAddress = BlockAddress;
+	uint16_t CurrDFPage;
+	uint8_t  CurrDFPageByteDiv16;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	if (WritePending && (BlockAddress == PendingNextBlockAddress))
+	{
+		/* Continue filling the pending write buffer, so that back-to-back sequential writes share page programs */
+		CurrDFPage          = PendingDFPage;
+		CurrDFPageByteDiv16 = PendingDFPageByteDiv16;
+
+		/* Select the Dataflash IC holding the pending write buffer, send the Dataflash buffer write command */
+		Dataflash_SelectChipFromPage(PendingPhysicalDFPage);
+		Dataflash_SendByte(UsingSecondBuffer[DATAFLASH_SELECTED_CHIP_INDEX()] ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+		Dataflash_SendAddressBytes(0, ((uint16_t)CurrDFPageByteDiv16 << 4));
+	}
+	else
+	{
+		/* Start the program of any pending write buffer, which may complete while the new page is written to another IC */
+		DataflashManager_FlushWrites();
 
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
-#endif
+		CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
+		CurrDFPageByteDiv16 = (((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE) >> 4);
 
-	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
-	Dataflash_SendAddressBytes(0, CurrDFPageByte);
+		/* Start writing the first page, copying over its existing contents if only part of the page is written */
+		DataflashManager_BeginPageWrite(CurrDFPage, CurrDFPageByteDiv16,
+		                                (CurrDFPageByteDiv16 || ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))));
+	}
 
 	/* Wait until endpoint is ready before continuing */
 	if (Endpoint_WaitUntilReady())
-	  return;
+	{
+		DataflashManager_AbortWrite();
+		return;
+	}
 
 	while (TotalBlocks)
 	{
-		uint8_t BytesInBlockDiv16 = 0;
+		uint8_t  BytesInBlockDiv16 = 0;
+		uint8_t* CachedBlockData   = DataflashManager_GetCachedBlockData(CurrBlockAddress);
 		
 		/* Write an endpoint packet sized data block to the Dataflash */
 		while (BytesInBlockDiv16 < (VIRTUAL_MEMORY_BLOCK_SIZE >> 4))
@@ -89,62 +155,33 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 				
 				/* Wait until the host has sent another packet */
 				if (Endpoint_WaitUntilReady())
-				  return;
+				{
+					DataflashManager_AbortWrite();
+					return;
+				}
 			}
 
 			/* Check if end of Dataflash page reached */
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
 				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				DataflashManager_EndPageWrite();
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Once all the Dataflash ICs have had their first buffers filled, switch buffers to maintain throughput */
-				if (Dataflash_GetSelectedChip() == DATAFLASH_CHIP_MASK(DATAFLASH_TOTALCHIPS))
-				  UsingSecondBuffer = !(UsingSecondBuffer);
-
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
-				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
-				{
-					/* Copy selected dataflash's current page contents to the Dataflash buffer */
-					Dataflash_WaitWhileBusy();
-					Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
-					Dataflash_SendAddressBytes(CurrDFPage, 0);
-					Dataflash_WaitWhileBusy();
-				}
-#endif
-
-				/* Send the Dataflash buffer write command */
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
-				Dataflash_SendAddressBytes(0, 0);				
+				/* Start writing the next page, if less than one Dataflash page remaining copy over the existing page to
+				 * preserve trailing data */
+				DataflashManager_BeginPageWrite(CurrDFPage, 0,
+				                                ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4)));
 			}
 
-			/* Write one 16-byte chunk of data to the Dataflash */
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
-			Dataflash_SendByte(Endpoint_Read_Byte());
+			/* Write one 16-byte chunk of data to the Dataflash, updating any cached copy of the block to keep it coherent */
+			DataflashManager_WriteChunkFromEndpoint(CachedBlockData);
+
+			if (CachedBlockData != NULL)
+			  CachedBlockData += 16;
 			
 			/* Increment the Dataflash page 16 byte block counter */
 			CurrDFPageByteDiv16++;
@@ -154,18 +191,22 @@ void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceIn
 
 			/* Check if the current command is being aborted by the host */
 			if (MSInterfaceInfo->State.IsMassStoreReset)
-			  return;			
+			{
+				DataflashManager_AbortWrite();
+				return;
+			}
 		}
 			
-		/* Decrement the blocks remaining counter and reset the sub block counter */
+		/* Decrement the blocks remaining counter and reset the sub block counter, advance to the next block */
 		TotalBlocks--;
+		CurrBlockAddress++;
 	}
 
-	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
-	Dataflash_WaitWhileBusy();
+	/* Leave the last page in the Dataflash buffer, to be programmed once it is full or the media is next accessed */
+	WritePending            = true;
+	PendingDFPageByteDiv16  = CurrDFPageByteDiv16;
+	PendingNextBlockAddress = NextBlockAddress;
+	WriteIdleTicks          = 0;
 
 	/* If the endpoint is empty, clear it ready for the next packet from the host */
 	if (!(Endpoint_IsReadWriteAllowed()))
@@ -187,28 +228,57 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
                                  const uint32_t BlockAddress,
                                  uint16_t TotalBlocks)
 {
-	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
-	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
-	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+	uint32_t CurrBlockAddress    = BlockAddress;
+	uint16_t CurrDFPage          = 0;
+	uint8_t  CurrDFPageByteDiv16 = 0;
+	uint16_t LastDFPage          = ((((BlockAddress + TotalBlocks) * VIRTUAL_MEMORY_BLOCK_SIZE) - 1) / DATAFLASH_PAGE_SIZE);
+	bool     PageReadStarted     = false;
+	bool     PageMapped          = false;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	/* Short reads are most likely of filesystem structures which will be read again, longer reads bypass the read cache so
+	 * that streamed file data does not evict the cached blocks */
+	bool     CacheBlocks         = (TotalBlocks <= DATAFLASH_READ_CACHE_BLOCKS);
 
-	/* Send the Dataflash main memory page read command */
-	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	
 	/* Wait until endpoint is ready before continuing */
 	if (Endpoint_WaitUntilReady())
 	  return;
 	
 	while (TotalBlocks)
 	{
-		uint8_t BytesInBlockDiv16 = 0;
+		uint8_t  BytesInBlockDiv16 = 0;
+		uint8_t* CachedBlockData   = DataflashManager_GetCachedBlockData(CurrBlockAddress);
+		bool     CacheHit          = (CachedBlockData != NULL);
+
+		DataflashManager_CachedBlock_t* FillBlock = NULL;
+
+		if (!(CacheHit))
+		{
+			/* Start a new Dataflash page read at the current block if the previous block was not read from the Dataflash */
+			if (!(PageReadStarted))
+			{
+				CurrDFPage          = ((CurrBlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
+				CurrDFPageByteDiv16 = (((CurrBlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE) >> 4);
+
+				/* If the pending write buffer holds one of the requested pages, it must be programmed before the page can be read */
+				if (WritePending && (PendingDFPage >= CurrDFPage) && (PendingDFPage <= LastDFPage))
+				  DataflashManager_FlushWrites();
+
+				PageMapped      = DataflashManager_BeginPageRead(CurrDFPage, ((uint16_t)CurrDFPageByteDiv16 << 4));
+				PageReadStarted = true;
+			}
+
+			/* Copy the block into the read cache as it is read, if it is to be cached */
+			if (CacheBlocks || (CurrBlockAddress < DATAFLASH_READ_CACHE_PINNED_BLOCKS))
+			  FillBlock = DataflashManager_AllocateCachedBlock();
+
+			if (FillBlock != NULL)
+			  CachedBlockData = FillBlock->Data;
+		}
+		else
+		{
+			/* The Dataflash page read must be restarted at the next block not held in the read cache */
+			PageReadStarted = false;
+		}
 		
 		/* Write an endpoint packet sized data block to the Dataflash */
 		while (BytesInBlockDiv16 < (VIRTUAL_MEMORY_BLOCK_SIZE >> 4))
@@ -224,45 +294,48 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 				  return;
 			}
 			
-			/* Check if end of Dataflash page reached */
-			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
+			if (!(CacheHit))
 			{
-				/* Reset the Dataflash buffer counter, increment the page counter */
-				CurrDFPageByteDiv16 = 0;
-				CurrDFPage++;
+				/* Check if end of Dataflash page reached */
+				if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
+				{
+					/* Reset the Dataflash buffer counter, increment the page counter */
+					CurrDFPageByteDiv16 = 0;
+					CurrDFPage++;
 
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-				
-				/* Send the Dataflash main memory page read command */
-				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-			}	
+					/* Start reading the next page from its first byte */
+					PageMapped = DataflashManager_BeginPageRead(CurrDFPage, 0);
+				}
 
-			/* Read one 16-byte chunk of data from the Dataflash */
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			Endpoint_Write_Byte(Dataflash_ReceiveByte());
-			
-			/* Increment the Dataflash page 16 byte block counter */
-			CurrDFPageByteDiv16++;
+				/* Increment the Dataflash page 16 byte block counter */
+				CurrDFPageByteDiv16++;
+			}
+
+			if (CacheHit)
+			{
+				/* Send one 16-byte chunk of data from the read cache */
+				for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+				  Endpoint_Write_Byte(*(CachedBlockData++));
+			}
+			else if (PageMapped)
+			{
+				/* Read one 16-byte chunk of data from the Dataflash, copying it into the read cache if the block is being cached */
+				DataflashManager_ReadChunkToEndpoint(CachedBlockData);
+
+				if (CachedBlockData != NULL)
+				  CachedBlockData += 16;
+			}
+			else
+			{
+				/* Pages which have never been written read as erased, as there is no Dataflash page holding their contents */
+				for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+				{
+					Endpoint_Write_Byte(0xFF);
+
+					if (CachedBlockData != NULL)
+					  *(CachedBlockData++) = 0xFF;
+				}
+			}
 			
 			/* Increment the block 16 byte block counter */
 			BytesInBlockDiv16++;
@@ -271,9 +344,14 @@ void DataflashManager_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInf
 			if (MSInterfaceInfo->State.IsMassStoreReset)
 			  return;
 		}
-		
-		/* Decrement the blocks remaining counter */
+
+		/* Once a block read into the read cache is complete, it can be retrieved from the cache */
+		if (FillBlock != NULL)
+		  DataflashManager_InsertCachedBlock(FillBlock, CurrBlockAddress);
+
+		/* Decrement the blocks remaining counter, advance to the next block */
 		TotalBlocks--;
+		CurrBlockAddress++;
 	}
 	
 	/* If the endpoint is full, send its contents to the host */
@@ -300,21 +378,16 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
-	bool     UsingSecondBuffer   = false;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	/* Start the program of any pending write buffer, which may complete while the new page is written to another IC */
+	DataflashManager_FlushWrites();
 
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-	/* Copy selected dataflash's current page contents to the Dataflash buffer */
-	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
-	Dataflash_SendAddressBytes(CurrDFPage, 0);
-	Dataflash_WaitWhileBusy();
-#endif
+	/* Discard any cached copies of the blocks being written, so that they are re-read once written */
+	DataflashManager_InvalidateCachedBlocks(BlockAddress, TotalBlocks);
 
-	/* Send the Dataflash buffer write command */
-	Dataflash_SendByte(DF_CMD_BUFF1WRITE);
-	Dataflash_SendAddressBytes(0, CurrDFPageByte);
+	/* Start writing the first page, copying over its existing contents if only part of the page is written */
+	DataflashManager_BeginPageWrite(CurrDFPage, CurrDFPageByteDiv16,
+	                                (CurrDFPageByteDiv16 || ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))));
 	
 	while (TotalBlocks)
 	{
@@ -327,37 +400,16 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 			if (CurrDFPageByteDiv16 == (DATAFLASH_PAGE_SIZE >> 4))
 			{
 				/* Write the Dataflash buffer contents back to the Dataflash page */
-				Dataflash_WaitWhileBusy();
-				Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
+				DataflashManager_EndPageWrite();
 
 				/* Reset the Dataflash buffer counter, increment the page counter */
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Once all the Dataflash ICs have had their first buffers filled, switch buffers to maintain throughput */
-				if (Dataflash_GetSelectedChip() == DATAFLASH_CHIP_MASK(DATAFLASH_TOTALCHIPS))
-				  UsingSecondBuffer = !(UsingSecondBuffer);
-
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-
-#if (DATAFLASH_PAGE_SIZE > VIRTUAL_MEMORY_BLOCK_SIZE)
-				/* If less than one Dataflash page remaining, copy over the existing page to preserve trailing data */
-				if ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4))
-				{
-					/* Copy selected dataflash's current page contents to the Dataflash buffer */
-					Dataflash_WaitWhileBusy();
-					Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
-					Dataflash_SendAddressBytes(CurrDFPage, 0);
-					Dataflash_WaitWhileBusy();
-				}
-#endif
-
-				/* Send the Dataflash buffer write command */
-				Dataflash_ToggleSelectedChipCS();
-				Dataflash_SendByte(DF_CMD_BUFF1WRITE);
-				Dataflash_SendAddressBytes(0, 0);
+				/* Start writing the next page, if less than one Dataflash page remaining copy over the existing page to
+				 * preserve trailing data */
+				DataflashManager_BeginPageWrite(CurrDFPage, 0,
+				                                ((TotalBlocks * (VIRTUAL_MEMORY_BLOCK_SIZE >> 4)) < (DATAFLASH_PAGE_SIZE >> 4)));
 			}
 			
 			/* Write one 16-byte chunk of data to the Dataflash */
@@ -376,10 +428,8 @@ void DataflashManager_WriteBlocks_RAM(const uint32_t BlockAddress,
 	}
 
 	/* Write the Dataflash buffer contents back to the Dataflash page */
-	Dataflash_WaitWhileBusy();
-	Dataflash_SendByte(UsingSecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
-	Dataflash_SendAddressBytes(CurrDFPage, 0x00);
-	Dataflash_WaitWhileBusy();
+	DataflashManager_EndPageWrite();
+	DataflashManager_WaitWhileAllBusy();
 
 	/* Deselect all Dataflash chips */
 	Dataflash_DeselectChip();
@@ -401,17 +451,13 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	uint16_t CurrDFPage          = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) / DATAFLASH_PAGE_SIZE);
 	uint16_t CurrDFPageByte      = ((BlockAddress * VIRTUAL_MEMORY_BLOCK_SIZE) % DATAFLASH_PAGE_SIZE);
 	uint8_t  CurrDFPageByteDiv16 = (CurrDFPageByte >> 4);
+	bool     PageMapped;
 
-	/* Select the correct starting Dataflash IC for the block requested */
-	Dataflash_SelectChipFromPage(CurrDFPage);
+	/* Program any pending write buffer so that it can be read back */
+	DataflashManager_FlushWrites();
 
-	/* Send the Dataflash main memory page read command */
-	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-	Dataflash_SendAddressBytes(CurrDFPage, CurrDFPageByte);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
-	Dataflash_SendByte(0x00);
+	/* Start reading the first page from the requested starting byte */
+	PageMapped = DataflashManager_BeginPageRead(CurrDFPage, CurrDFPageByte);
 
 	while (TotalBlocks)
 	{
@@ -427,21 +473,13 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 				CurrDFPageByteDiv16 = 0;
 				CurrDFPage++;
 
-				/* Select the next Dataflash chip based on the new Dataflash page index */
-				Dataflash_SelectChipFromPage(CurrDFPage);
-				
-				/* Send the Dataflash main memory page read command */
-				Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
-				Dataflash_SendAddressBytes(CurrDFPage, 0);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
-				Dataflash_SendByte(0x00);
+				/* Start reading the next page from its first byte */
+				PageMapped = DataflashManager_BeginPageRead(CurrDFPage, 0);
 			}	
 
 			/* Read one 16-byte chunk of data from the Dataflash */
 			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
-			  *(BufferPtr++) = Dataflash_ReceiveByte();
+			  *(BufferPtr++) = (PageMapped ? Dataflash_ReceiveByte() : 0xFF);
 			
 			/* Increment the Dataflash page 16 byte block counter */
 			CurrDFPageByteDiv16++;
@@ -458,6 +496,332 @@ void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 	Dataflash_DeselectChip();
 }
 
+/** Programs the pending write buffer left by the last write command into the Dataflash main memory, if any. The program
+ *  operation is started but not waited on, so that it can complete in the background while the host sends its next command.
+ */
+void DataflashManager_FlushWrites(void)
+{
+	if (!(WritePending))
+	  return;
+
+	/* Select the Dataflash IC holding the pending write buffer, start the program of the buffer into the Dataflash page
+	 * which completes once the chip is deselected */
+	Dataflash_SelectChipFromPage(PendingPhysicalDFPage);
+	DataflashManager_EndPageWrite();
+	Dataflash_DeselectChip();
+
+	WritePending = false;
+}
+
+/** Programs the pending write buffer left by the last write command into the Dataflash main memory if any, and waits until
+ *  all page programs have completed, so that all written data is held in non-volatile memory when the function returns.
+ */
+void DataflashManager_SyncWrites(void)
+{
+	DataflashManager_FlushWrites();
+	DataflashManager_WaitWhileAllBusy();
+}
+
+/** Programs the pending write buffer once no write command has continued filling it for \ref DATAFLASH_WRITE_IDLE_TIMEOUT_MS
+ *  milliseconds, so that written data is not held indefinitely in the volatile Dataflash buffers. Once the pending write
+ *  buffer has been programmed, idle time is given to the flash translation layer's background maintenance if it is enabled.
+ *  This should be called continuously from the main program loop, with Timer 0 running in CTC mode with a 1ms period.
+ */
+void DataflashManager_Task(void)
+{
+	/* Count idle milliseconds from the Timer 0 compare flag, which unlike the USB frame number keeps running while the bus is
+	 * suspended and does not wrap */
+	if (TIFR0 & (1 << OCF0A))
+	{
+		TIFR0 |= (1 << OCF0A);
+
+		if (WriteIdleTicks < DATAFLASH_WRITE_IDLE_TIMEOUT_MS)
+		  WriteIdleTicks++;
+	}
+
+	if (WriteIdleTicks < DATAFLASH_WRITE_IDLE_TIMEOUT_MS)
+	  return;
+
+	if (WritePending)
+	  DataflashManager_FlushWrites();
+	else
+	  FTL_Task();
+}
+
+/** Programs the partially filled write buffer of a write command aborted by the host, so that the data of earlier completed
+ *  write commands sharing the buffer is not lost.
+ */
+static void DataflashManager_AbortWrite(void)
+{
+	WritePending = true;
+
+	DataflashManager_FlushWrites();
+}
+
+/** Starts writing a Dataflash page into the current Dataflash buffer of the IC holding it, leaving the buffer write command
+ *  in progress ready for the page data. When the flash translation layer is enabled, the page is written to a newly
+ *  allocated physical page rather than its own page address.
+ *
+ *  \param[in] CurrDFPage           Dataflash page address of the page to write
+ *  \param[in] CurrDFPageByteDiv16  Offset within the page, in 16 byte chunks, of the first byte to write
+ *  \param[in] PreloadPage          Indicates if the existing page contents must be copied into the buffer first, to
+ *                                  preserve the bytes of the page which are not written
+ */
+static void DataflashManager_BeginPageWrite(const uint16_t CurrDFPage,
+                                            const uint8_t CurrDFPageByteDiv16,
+                                            const bool PreloadPage)
+{
+	PendingDFPage         = CurrDFPage;
+	PendingReplacedDFPage = FTL_GetPhysicalPage(CurrDFPage);
+	PendingPhysicalDFPage = FTL_AllocatePage(CurrDFPage);
+
+	/* Select the Dataflash IC holding the page, which is the same for the page and its physical page */
+	Dataflash_SelectChipFromPage(PendingPhysicalDFPage);
+
+	/* Write into the IC's buffer which is not being programmed, the other buffer is only reused once its program completes */
+	bool SecondBuffer = UsingSecondBuffer[DATAFLASH_SELECTED_CHIP_INDEX()];
+
+	if (PreloadPage)
+	{
+#if defined(USE_DATAFLASH_FTL)
+		/* Pages which have never been written have no existing contents to copy, fill the buffer as an erased page */
+		if (PendingReplacedDFPage == FTL_UNMAPPED_PAGE)
+		{
+			Dataflash_SendByte(SecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+			Dataflash_SendAddressBytes(0, 0);
+
+			for (uint16_t PageByte = 0; PageByte < DATAFLASH_PAGE_SIZE; PageByte++)
+			  Dataflash_SendByte(0xFF);
+
+			Dataflash_ToggleSelectedChipCS();
+		}
+		else
+#endif
+		{
+			/* Copy selected dataflash's current page contents to the Dataflash buffer once the IC is free to do so */
+			Dataflash_WaitWhileBusy();
+			Dataflash_SendByte(SecondBuffer ? DF_CMD_MAINMEMTOBUFF2 : DF_CMD_MAINMEMTOBUFF1);
+			Dataflash_SendAddressBytes(PendingReplacedDFPage, 0);
+			Dataflash_WaitWhileBusy();
+		}
+	}
+
+	/* Send the Dataflash buffer write command */
+	Dataflash_SendByte(SecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, ((uint16_t)CurrDFPageByteDiv16 << 4));
+}
+
+/** Starts the program of the current Dataflash buffer into the page started by \ref DataflashManager_BeginPageWrite(), once
+ *  any program of the IC's other buffer has completed. The Dataflash IC holding the page must be selected, and the program
+ *  operation is started but not waited on. The IC's other buffer is used for its next page, so that the next page can be
+ *  written while this one is programmed.
+ */
+static void DataflashManager_EndPageWrite(void)
+{
+	uint8_t ChipIndex    = DATAFLASH_SELECTED_CHIP_INDEX();
+	bool    SecondBuffer = UsingSecondBuffer[ChipIndex];
+
+	/* Tag the page contents with the page address if the flash translation layer is enabled */
+	FTL_WritePageTag(PendingDFPage, SecondBuffer);
+
+	/* Write the Dataflash buffer contents back to the Dataflash page */
+	Dataflash_WaitWhileBusy();
+	Dataflash_SendByte(SecondBuffer ? DF_CMD_BUFF2TOMAINMEMWITHERASE : DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(PendingPhysicalDFPage, 0);
+
+	UsingSecondBuffer[ChipIndex] = !(SecondBuffer);
+
+	/* Map the page to its new physical page if the flash translation layer is enabled */
+	FTL_CommitPage(PendingDFPage, PendingPhysicalDFPage, PendingReplacedDFPage);
+}
+
+/** Starts reading a Dataflash page, leaving the main memory page read command in progress ready for the page data to be
+ *  received. When the flash translation layer is enabled, the page is read from the physical page it is mapped to.
+ *
+ *  \param[in] CurrDFPage      Dataflash page address of the page to read
+ *  \param[in] CurrDFPageByte  Offset within the page of the first byte to read
+ *
+ *  \return Boolean true if the page read was started, false if the page has never been written and reads as erased
+ */
+static bool DataflashManager_BeginPageRead(const uint16_t CurrDFPage,
+                                           const uint16_t CurrDFPageByte)
+{
+	uint16_t PhysicalDFPage = FTL_GetPhysicalPage(CurrDFPage);
+
+	if (PhysicalDFPage == FTL_UNMAPPED_PAGE)
+	{
+		Dataflash_DeselectChip();
+		return false;
+	}
+
+	/* Select the Dataflash IC holding the page, wait for any page program to complete */
+	Dataflash_SelectChipFromPage(PhysicalDFPage);
+	Dataflash_WaitWhileBusy();
+
+	/* Send the Dataflash main memory page read command */
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PhysicalDFPage, CurrDFPageByte);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+
+	return true;
+}
+
+/** Writes one 16-byte chunk of data from the selected data OUT endpoint to the selected Dataflash IC, which must be accepting
+ *  buffer write data. Each byte is read from the endpoint while the previous byte is still being shifted out over the SPI
+ *  bus, so that the endpoint access and loop overhead are hidden behind the SPI transfer time.
+ *
+ *  \param[in,out] CachedBlockData  Pointer to the cached copy of the chunk to update with the written data, or NULL if none
+ */
+static inline void DataflashManager_WriteChunkFromEndpoint(uint8_t* CachedBlockData)
+{
+	uint8_t DataByte = Endpoint_Read_Byte();
+
+	for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+	{
+		Dataflash_BeginTransferByte(DataByte);
+
+		if (CachedBlockData != NULL)
+		  *(CachedBlockData++) = DataByte;
+
+		/* Fetch the next byte of the chunk while the current byte is being sent */
+		if (ByteNum < 15)
+		  DataByte = Endpoint_Read_Byte();
+
+		Dataflash_EndTransferByte();
+	}
+}
+
+/** Reads one 16-byte chunk of data from the selected Dataflash IC into the selected data IN endpoint, the IC must be in the
+ *  middle of a page read. Each byte is written to the endpoint while the next byte is already being shifted in over the SPI
+ *  bus, so that the endpoint access and loop overhead are hidden behind the SPI transfer time.
+ *
+ *  \param[in,out] CachedBlockData  Pointer to the cache entry data to copy the chunk into, or NULL if the block is not cached
+ */
+static inline void DataflashManager_ReadChunkToEndpoint(uint8_t* CachedBlockData)
+{
+	Dataflash_BeginTransferByte(0x00);
+
+	for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+	{
+		uint8_t DataByte = Dataflash_EndTransferByte();
+
+		/* Start receiving the next byte of the chunk before the current byte is stored */
+		if (ByteNum < 15)
+		  Dataflash_BeginTransferByte(0x00);
+
+		Endpoint_Write_Byte(DataByte);
+
+		if (CachedBlockData != NULL)
+		  *(CachedBlockData++) = DataByte;
+	}
+}
+
+/** Waits until all the Dataflash ICs have completed any page program operations, so that both buffers of each IC are free. */
+static void DataflashManager_WaitWhileAllBusy(void)
+{
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_WaitWhileBusy();
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_WaitWhileBusy();
+	#endif
+
+	Dataflash_DeselectChip();
+}
+
+#if (DATAFLASH_READ_CACHE_SLOTS > 0)
+/** Retrieves the data of the given block from the read cache, marking it as the most recently used cached block.
+ *
+ *  \param[in] BlockAddress  Address of the block to retrieve
+ *
+ *  \return Pointer to the cached block data if the block is cached, NULL otherwise
+ */
+static uint8_t* DataflashManager_GetCachedBlockData(const uint32_t BlockAddress)
+{
+	for (uint8_t CacheSlot = 0; CacheSlot < DATAFLASH_READ_CACHE_SLOTS; CacheSlot++)
+	{
+		DataflashManager_CachedBlock_t* CachedBlock = &ReadCache[CacheSlot];
+
+		if (CachedBlock->InUse && (CachedBlock->BlockAddress == BlockAddress))
+		{
+			CachedBlock->LastUsed = ++ReadCacheUseCount;
+			return CachedBlock->Data;
+		}
+	}
+
+	return NULL;
+}
+
+/** Selects a read cache entry to read a new block into, which is a free entry if one exists or otherwise the least recently
+ *  used entry not holding a pinned block. The selected entry is discarded until \ref DataflashManager_InsertCachedBlock()
+ *  is called once the new block data has been completely read into it.
+ *
+ *  \return Pointer to the selected read cache entry
+ */
+static DataflashManager_CachedBlock_t* DataflashManager_AllocateCachedBlock(void)
+{
+	DataflashManager_CachedBlock_t* LRUBlock = NULL;
+
+	for (uint8_t CacheSlot = 0; CacheSlot < DATAFLASH_READ_CACHE_SLOTS; CacheSlot++)
+	{
+		DataflashManager_CachedBlock_t* CachedBlock = &ReadCache[CacheSlot];
+
+		if (!(CachedBlock->InUse))
+		{
+			LRUBlock = CachedBlock;
+			break;
+		}
+
+		/* Pinned blocks are never replaced, there is always an unpinned entry as there are more entries than pinned blocks */
+		if (CachedBlock->BlockAddress < DATAFLASH_READ_CACHE_PINNED_BLOCKS)
+		  continue;
+
+		if ((LRUBlock == NULL) ||
+		    ((uint16_t)(ReadCacheUseCount - CachedBlock->LastUsed) > (uint16_t)(ReadCacheUseCount - LRUBlock->LastUsed)))
+		{
+			LRUBlock = CachedBlock;
+		}
+	}
+
+	LRUBlock->InUse = false;
+	return LRUBlock;
+}
+
+/** Adds a block read into a read cache entry selected by \ref DataflashManager_AllocateCachedBlock() to the read cache.
+ *
+ *  \param[in, out] CachedBlock   Pointer to the read cache entry holding the block data
+ *  \param[in]      BlockAddress  Address of the block held in the read cache entry
+ */
+static void DataflashManager_InsertCachedBlock(DataflashManager_CachedBlock_t* const CachedBlock,
+                                               const uint32_t BlockAddress)
+{
+	CachedBlock->BlockAddress = BlockAddress;
+	CachedBlock->LastUsed     = ++ReadCacheUseCount;
+	CachedBlock->InUse        = true;
+}
+
+/** Discards any cached copies of the given range of blocks from the read cache, for writes which do not update them.
+ *
+ *  \param[in] BlockAddress  Address of the first block to discard
+ *  \param[in] TotalBlocks   Number of blocks to discard
+ */
+static void DataflashManager_InvalidateCachedBlocks(const uint32_t BlockAddress,
+                                                    const uint16_t TotalBlocks)
+{
+	for (uint8_t CacheSlot = 0; CacheSlot < DATAFLASH_READ_CACHE_SLOTS; CacheSlot++)
+	{
+		DataflashManager_CachedBlock_t* CachedBlock = &ReadCache[CacheSlot];
+
+		if ((CachedBlock->BlockAddress - BlockAddress) < TotalBlocks)
+		  CachedBlock->InUse = false;
+	}
+}
+#endif
+
 /** Disables the Dataflash memory write protection bits on the board Dataflash ICs, if enabled. */
 void DataflashManager_ResetDataflashProtections(void)
 {
@@ -507,6 +871,9 @@ bool DataflashManager_CheckDataflashOperation(void)
 {
 	uint8_t ReturnByte;
 
+	/* Wait for any page program started by an earlier write to complete */
+	DataflashManager_WaitWhileAllBusy();
+
 	/* Test first Dataflash IC is present and responding to commands */
 	Dataflash_SelectChip(DATAFLASH_CHIP1);
 	Dataflash_SendByte(DF_CMD_READMANUFACTURERDEVICEINFO);
@@ -531,3 +898,54 @@ bool DataflashManager_CheckDataflashOperation(void)
 	
 	return true;
 }
+
+/** Retrieves the total number of blocks of a Logical Unit served by the Dataflash backend.
+ *
+ *  \param[in] LUN  Index of the Logical Unit the backend is serving
+ *
+ *  \return Total number of blocks of the Logical Unit's portion of the Dataflash
+ */
+static uint32_t DataflashManager_GetLUNBlocks(const uint8_t LUN)
+{
+	return LUN_MEDIA_BLOCKS;
+}
+
+/** Reads blocks of a Logical Unit's portion of the Dataflash, for the Dataflash block device backend. The Logical Unit is
+ *  taken from the command being processed.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] BlockAddress     Data block to start reading from, relative to the start of the Logical Unit
+ *  \param[in] TotalBlocks      Number of blocks of data to read, at most \ref LUN_MEDIA_BLOCKS
+ *
+ *  \return Boolean true if the blocks were read, false if the transfer was aborted by the host
+ */
+static bool DataflashManager_ReadLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                           const uint32_t BlockAddress,
+                                           uint32_t TotalBlocks)
+{
+	uint32_t LUNStartBlock = ((uint32_t)MSInterfaceInfo->State.CommandBlock.LUN * LUN_MEDIA_BLOCKS);
+
+	DataflashManager_ReadBlocks(MSInterfaceInfo, (LUNStartBlock + BlockAddress), TotalBlocks);
+
+	return !(MSInterfaceInfo->State.IsMassStoreReset);
+}
+
+/** Writes blocks to a Logical Unit's portion of the Dataflash, for the Dataflash block device backend. The Logical Unit is
+ *  taken from the command being processed.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] BlockAddress     Data block to start writing to, relative to the start of the Logical Unit
+ *  \param[in] TotalBlocks      Number of blocks of data to write, at most \ref LUN_MEDIA_BLOCKS
+ *
+ *  \return Boolean true if the blocks were written, false if the transfer was aborted by the host
+ */
+static bool DataflashManager_WriteLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                            const uint32_t BlockAddress,
+                                            uint32_t TotalBlocks)
+{
+	uint32_t LUNStartBlock = ((uint32_t)MSInterfaceInfo->State.CommandBlock.LUN * LUN_MEDIA_BLOCKS);
+
+	DataflashManager_WriteBlocks(MSInterfaceInfo, (LUNStartBlock + BlockAddress), TotalBlocks);
+
+	return !(MSInterfaceInfo->State.IsMassStoreReset);
+}
@@ -47,14 +47,18 @@
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 		#include <LUFA/Drivers/Board/Dataflash.h>
 
-	/* Preprocessor Checks: */
-		#if (DATAFLASH_PAGE_SIZE % 16)
-			#error Dataflash page size must be a multiple of 16 bytes.
-		#endif
+		#include "BlockDevice.h"
+		#include "FlashTranslationLayer.h"
 
 	/* Defines: */
-		/** Total number of bytes of the storage medium, comprised of one or more Dataflash ICs. */
-		#define VIRTUAL_MEMORY_BYTES                ((uint32_t)DATAFLASH_PAGES * DATAFLASH_PAGE_SIZE * DATAFLASH_TOTALCHIPS)
+		#if !defined(USE_DATAFLASH_FTL) || defined(__DOXYGEN__)
+			/** Total number of bytes of the storage medium, comprised of one or more Dataflash ICs. When the flash
+			 *  translation layer is enabled, this excludes the pages held in reserve by the translation layer.
+			 */
+			#define VIRTUAL_MEMORY_BYTES            ((uint32_t)DATAFLASH_PAGES * DATAFLASH_PAGE_SIZE * DATAFLASH_TOTALCHIPS)
+		#else
+			#define VIRTUAL_MEMORY_BYTES            ((uint32_t)FTL_LOGICAL_PAGES * DATAFLASH_PAGE_SIZE)
+		#endif
 
 		/** Block size of the device. This is kept at 512 to remain compatible with the OS despite the underlying
 		 *  storage media (Dataflash) using a different native block size. Do not change this value.
@@ -65,6 +69,58 @@
 		 *  change this value; change VIRTUAL_MEMORY_BYTES instead to alter the media size.
 		 */
 		#define VIRTUAL_MEMORY_BLOCKS               (VIRTUAL_MEMORY_BYTES / VIRTUAL_MEMORY_BLOCK_SIZE)
+
+		#if !defined(DATAFLASH_WRITE_IDLE_TIMEOUT_MS) || defined(__DOXYGEN__)
+			/** Time in milliseconds after the last write command that the partially filled Dataflash buffer left by the command
+			 *  is programmed into the Dataflash, if not first filled by a following sequential write command. Until then, the
+			 *  data is held in the volatile Dataflash buffer and will be lost if the device loses power. The timeout is counted
+			 *  on Timer 0 from the main program loop, so time spent processing commands is not counted towards it.
+			 */
+			#define DATAFLASH_WRITE_IDLE_TIMEOUT_MS 100
+		#endif
+
+		#if !defined(DATAFLASH_READ_CACHE_BLOCKS) || defined(__DOXYGEN__)
+			/** Number of blocks held in RAM by the least recently used read cache, from which repeated reads of the same
+			 *  blocks are served without reading the Dataflash. Only blocks read by read commands of up to this many blocks
+			 *  are cached, so that long reads of file data do not replace the cached filesystem structures. Each cached block
+			 *  requires slightly over \ref VIRTUAL_MEMORY_BLOCK_SIZE bytes of RAM; set to zero to disable the read cache on
+			 *  devices with little RAM.
+			 */
+			#define DATAFLASH_READ_CACHE_BLOCKS       4
+		#endif
+
+		#if !defined(DATAFLASH_READ_CACHE_PINNED_BLOCKS) || defined(__DOXYGEN__)
+			/** Number of blocks at the start of the storage medium, typically holding the filesystem's boot sector and
+			 *  allocation tables, which are always read into the read cache and never replaced once cached. These are held in
+			 *  addition to the \ref DATAFLASH_READ_CACHE_BLOCKS least recently used blocks.
+			 */
+			#define DATAFLASH_READ_CACHE_PINNED_BLOCKS 0
+		#endif
+
+		/** Total number of blocks held in RAM by the read cache. */
+		#define DATAFLASH_READ_CACHE_SLOTS          (DATAFLASH_READ_CACHE_BLOCKS + DATAFLASH_READ_CACHE_PINNED_BLOCKS)
+
+	/* Preprocessor Checks: */
+		#if (DATAFLASH_PAGE_SIZE % 16)
+			#error Dataflash page size must be a multiple of 16 bytes.
+		#endif
+
+		#if (DATAFLASH_READ_CACHE_PINNED_BLOCKS && !(DATAFLASH_READ_CACHE_BLOCKS))
+			#error DATAFLASH_READ_CACHE_BLOCKS must be non-zero when read cache blocks are pinned.
+		#endif
+
+	/* Type Defines: */
+		/** Type define for an entry of the read cache, holding a copy of one block of the storage medium. */
+		typedef struct
+		{
+			uint32_t BlockAddress; /**< Address of the cached block */
+			uint16_t LastUsed; /**< Value of the read cache use counter when the block was last accessed */
+			bool     InUse; /**< Indicates if the entry holds a cached block */
+			uint8_t  Data[VIRTUAL_MEMORY_BLOCK_SIZE]; /**< Cached copy of the block data */
+		} DataflashManager_CachedBlock_t;
+
+	/* External Variables: */
+		extern const BlockDevice_Backend_t DataflashManager_Backend;
 		
 	/* Function Prototypes: */
 		void DataflashManager_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
@@ -79,7 +135,55 @@
 		void DataflashManager_ReadBlocks_RAM(const uint32_t BlockAddress,
 		                                     uint16_t TotalBlocks,
 		                                     uint8_t* BufferPtr) ATTR_NON_NULL_PTR_ARG(3);
+		void DataflashManager_FlushWrites(void);
+		void DataflashManager_SyncWrites(void);
+		void DataflashManager_Task(void);
 		void DataflashManager_ResetDataflashProtections(void);
 		bool DataflashManager_CheckDataflashOperation(void);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if (DATAFLASH_TOTALCHIPS == 2)
+				#define DATAFLASH_SELECTED_CHIP_INDEX()   ((Dataflash_GetSelectedChip() == DATAFLASH_CHIP2) ? 1 : 0)
+			#else
+				#define DATAFLASH_SELECTED_CHIP_INDEX()   0
+			#endif
+	#endif
+
+	/* Function Prototypes: */
+		#if defined(INCLUDE_FROM_DATAFLASHMANAGER_C)
+			static void DataflashManager_AbortWrite(void);
+			static void DataflashManager_WaitWhileAllBusy(void);
+			static void DataflashManager_BeginPageWrite(const uint16_t CurrDFPage,
+			                                            const uint8_t CurrDFPageByteDiv16,
+			                                            const bool PreloadPage);
+			static void DataflashManager_EndPageWrite(void);
+			static bool DataflashManager_BeginPageRead(const uint16_t CurrDFPage,
+			                                           const uint16_t CurrDFPageByte);
+			static inline void DataflashManager_WriteChunkFromEndpoint(uint8_t* CachedBlockData) ATTR_ALWAYS_INLINE;
+			static inline void DataflashManager_ReadChunkToEndpoint(uint8_t* CachedBlockData) ATTR_ALWAYS_INLINE;
+			static uint32_t DataflashManager_GetLUNBlocks(const uint8_t LUN);
+			static bool DataflashManager_ReadLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                           const uint32_t BlockAddress,
+			                                           uint32_t TotalBlocks);
+			static bool DataflashManager_WriteLUNBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                            const uint32_t BlockAddress,
+			                                            uint32_t TotalBlocks);
+
+			#if (DATAFLASH_READ_CACHE_SLOTS > 0)
+				static uint8_t* DataflashManager_GetCachedBlockData(const uint32_t BlockAddress);
+				static DataflashManager_CachedBlock_t* DataflashManager_AllocateCachedBlock(void);
+				static void DataflashManager_InsertCachedBlock(DataflashManager_CachedBlock_t* const CachedBlock,
+				                                               const uint32_t BlockAddress);
+				static void DataflashManager_InvalidateCachedBlocks(const uint32_t BlockAddress,
+				                                                    const uint16_t TotalBlocks);
+			#else
+				#define DataflashManager_GetCachedBlockData(BlockAddress)                 NULL
+				#define DataflashManager_AllocateCachedBlock()                            NULL
+				#define DataflashManager_InsertCachedBlock(CachedBlock, BlockAddress)     MACROS{ }MACROE
+				#define DataflashManager_InvalidateCachedBlocks(BlockAddress, TotalBlocks) MACROS{ }MACROE
+			#endif
+		#endif
 		
 #endif
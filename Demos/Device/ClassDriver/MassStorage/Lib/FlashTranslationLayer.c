@@ -0,0 +1,576 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Flash translation layer for the Dataflash storage medium. Rather than storing each logical page presented to the host
+ *  in the physical Dataflash page of the same address, each new page write is placed in the next free physical page of a
+ *  circular log on the page's Dataflash IC, so that page programs are spread evenly over the whole medium instead of
+ *  repeatedly wearing the pages holding frequently rewritten FAT and directory sectors.
+ *
+ *  The physical page holding each logical page is recorded in map pages, which are themselves written into the logs.
+ *  Remappings are collected in a small RAM journal and applied to the map pages in one pass once the journal is full or
+ *  the device is idle, so that each map page is rewritten once for many data page writes. The spare bytes following the
+ *  data area of each physical page hold a tag recording the logical page stored in it and a global write sequence number,
+ *  from which the map locations and any remappings not yet written to the map are recovered at startup.
+ *
+ *  The translation layer is enabled by defining USE_DATAFLASH_FTL in the project makefile and passing it to the compiler
+ *  via the -D switch. The Dataflash ICs must be configured for their default page size, so that the spare bytes used to
+ *  store the page tags are present.
+ */
+
+#define  INCLUDE_FROM_FLASHTRANSLATIONLAYER_C
+#include "FlashTranslationLayer.h"
+
+#if defined(USE_DATAFLASH_FTL)
+
+/** Bitmap of the physical pages which currently hold the live contents of a logical or map page. */
+static uint8_t            ValidPages[FTL_PHYSICAL_PAGES / 8];
+
+/** Physical page address of each map page, or \ref FTL_UNMAPPED_PAGE if the map page has not yet been written. */
+static uint16_t           MapLocations[FTL_MAP_PAGES];
+
+/** Journal of logical pages remapped since their map page was last written. */
+static FTL_JournalEntry_t Journal[FTL_JOURNAL_ENTRIES];
+
+/** Number of entries currently held in the remapping journal. */
+static uint8_t            JournalEntries;
+
+/** First logical page of the map entries held in the lookup cache, or \ref FTL_UNMAPPED_PAGE if the cache is empty. */
+static uint16_t           LookupCacheStart = FTL_UNMAPPED_PAGE;
+
+/** Map entries of \ref FTL_LOOKUP_CACHE_ENTRIES consecutive logical pages, read from their map page. */
+static uint16_t           LookupCache[FTL_LOOKUP_CACHE_ENTRIES];
+
+/** Next physical page to be considered for writing in the circular log of each Dataflash IC. */
+static uint16_t           WriteHeads[DATAFLASH_TOTALCHIPS];
+
+/** Global page write sequence counter, stored in the tag of each written page. */
+static uint32_t           WriteSequence;
+
+/** Number of valid pages skipped over by the write heads since static data was last moved. */
+static uint16_t           SkippedValidPages;
+
+/** Most recently skipped valid physical page, moved once \ref FTL_WEAR_LEVEL_INTERVAL valid pages have been skipped. */
+static uint16_t           LastSkippedPage = FTL_UNMAPPED_PAGE;
+
+/** Initializes the flash translation layer, scanning the page tags of the whole medium to recover the map page locations,
+ *  the remappings not yet written to the map, the set of valid pages and the write head of each Dataflash IC. This must be
+ *  called after the Dataflash has been initialized and before any other translation layer function is used.
+ */
+void FTL_Init(void)
+{
+	uint32_t MapSequences[FTL_MAP_PAGES];
+	uint32_t HeadSequences[DATAFLASH_TOTALCHIPS];
+	bool     HeadFound[DATAFLASH_TOTALCHIPS];
+
+	memset(MapLocations, 0xFF, sizeof(MapLocations));
+	memset(HeadFound, false, sizeof(HeadFound));
+
+	/* First pass - locate the most recently written copy of each map page and the most recently written page of each IC */
+	for (uint16_t PhysicalPage = 0; PhysicalPage < FTL_PHYSICAL_PAGES; PhysicalPage++)
+	{
+		FTL_PageTag_t Tag;
+		uint8_t       Chip = (PhysicalPage % DATAFLASH_TOTALCHIPS);
+
+		FTL_ReadPageTag(PhysicalPage, &Tag);
+
+		if (Tag.LogicalPage == FTL_UNMAPPED_PAGE)
+		  continue;
+
+		if (Tag.Sequence >= WriteSequence)
+		  WriteSequence = (Tag.Sequence + 1);
+
+		if (!(HeadFound[Chip]) || (Tag.Sequence > HeadSequences[Chip]))
+		{
+			HeadFound[Chip]     = true;
+			HeadSequences[Chip] = Tag.Sequence;
+			WriteHeads[Chip]    = PhysicalPage;
+		}
+
+		if (Tag.LogicalPage >= FTL_LOGICAL_PAGES)
+		{
+			uint16_t MapPage = (Tag.LogicalPage - FTL_LOGICAL_PAGES);
+
+			if ((MapLocations[MapPage] == FTL_UNMAPPED_PAGE) || (Tag.Sequence > MapSequences[MapPage]))
+			{
+				MapLocations[MapPage] = PhysicalPage;
+				MapSequences[MapPage] = Tag.Sequence;
+			}
+		}
+	}
+
+	/* Second pass - mark the pages referenced by the map as valid, journal pages written after their map page was written */
+	for (uint16_t PhysicalPage = 0; PhysicalPage < FTL_PHYSICAL_PAGES; PhysicalPage++)
+	{
+		FTL_PageTag_t Tag;
+
+		FTL_ReadPageTag(PhysicalPage, &Tag);
+
+		if (Tag.LogicalPage == FTL_UNMAPPED_PAGE)
+		  continue;
+
+		if (Tag.LogicalPage >= FTL_LOGICAL_PAGES)
+		{
+			if (MapLocations[Tag.LogicalPage - FTL_LOGICAL_PAGES] == PhysicalPage)
+			  FTL_SetPageValid(PhysicalPage, true);
+
+			continue;
+		}
+
+		uint16_t MapPage = (Tag.LogicalPage / FTL_MAP_ENTRIES_PER_PAGE);
+
+		if ((MapLocations[MapPage] != FTL_UNMAPPED_PAGE) && (Tag.Sequence < MapSequences[MapPage]))
+		{
+			if (FTL_GetMappedPage(Tag.LogicalPage) == PhysicalPage)
+			  FTL_SetPageValid(PhysicalPage, true);
+
+			continue;
+		}
+
+		/* Page was written after its map page, keep only the most recently written copy of each logical page */
+		uint8_t EntryIndex;
+
+		for (EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+		{
+			if (Journal[EntryIndex].LogicalPage == Tag.LogicalPage)
+			  break;
+		}
+
+		if (EntryIndex < JournalEntries)
+		{
+			FTL_PageTag_t JournalTag;
+
+			FTL_ReadPageTag(Journal[EntryIndex].PhysicalPage, &JournalTag);
+
+			if (JournalTag.Sequence < Tag.Sequence)
+			  Journal[EntryIndex].PhysicalPage = PhysicalPage;
+		}
+		else if (JournalEntries < FTL_JOURNAL_ENTRIES)
+		{
+			Journal[JournalEntries].LogicalPage  = Tag.LogicalPage;
+			Journal[JournalEntries].PhysicalPage = PhysicalPage;
+			JournalEntries++;
+		}
+	}
+
+	/* Journalled pages replace the pages given in the map, which were marked as valid by the second pass */
+	for (uint8_t EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+	{
+		uint16_t ReplacedPage = FTL_GetMappedPage(Journal[EntryIndex].LogicalPage);
+
+		if (ReplacedPage != FTL_UNMAPPED_PAGE)
+		{
+			FTL_PageTag_t Tag;
+
+			FTL_ReadPageTag(ReplacedPage, &Tag);
+
+			if (Tag.LogicalPage == Journal[EntryIndex].LogicalPage)
+			  FTL_SetPageValid(ReplacedPage, false);
+		}
+
+		FTL_SetPageValid(Journal[EntryIndex].PhysicalPage, true);
+	}
+
+	/* Continue each IC's log after its most recently written page */
+	for (uint8_t Chip = 0; Chip < DATAFLASH_TOTALCHIPS; Chip++)
+	{
+		if (!(HeadFound[Chip]))
+		  WriteHeads[Chip] = Chip;
+		else if ((WriteHeads[Chip] += DATAFLASH_TOTALCHIPS) >= FTL_PHYSICAL_PAGES)
+		  WriteHeads[Chip] = Chip;
+	}
+
+	/* Write any recovered remappings to the map, so that they do not need to be recovered again */
+	if (JournalEntries)
+	  FTL_FlushMap();
+}
+
+/** Retrieves the physical page currently holding the contents of the given logical page.
+ *
+ *  \param[in] LogicalPage  Logical page whose physical page is to be retrieved
+ *
+ *  \return Physical page address, or \ref FTL_UNMAPPED_PAGE if the logical page has never been written
+ */
+uint16_t FTL_GetPhysicalPage(const uint16_t LogicalPage)
+{
+	/* Journalled remappings take precedence over those stored in the map pages */
+	for (uint8_t EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+	{
+		if (Journal[EntryIndex].LogicalPage == LogicalPage)
+		  return Journal[EntryIndex].PhysicalPage;
+	}
+
+	return FTL_GetMappedPage(LogicalPage);
+}
+
+/** Reserves a free physical page to write the new contents of the given logical page to. The returned page lies on the
+ *  same Dataflash IC as the logical page address would, so that the ICs continue to be interleaved as without the
+ *  translation layer. Once the new contents have been programmed, \ref FTL_CommitPage() must be called to remap the
+ *  logical page to the reserved page.
+ *
+ *  \param[in] LogicalPage  Logical page which is to be written
+ *
+ *  \return Physical page address reserved for the new page contents
+ */
+uint16_t FTL_AllocatePage(const uint16_t LogicalPage)
+{
+	return FTL_AllocatePhysicalPage(LogicalPage % DATAFLASH_TOTALCHIPS);
+}
+
+/** Writes the tag identifying the given logical page into the spare bytes of the selected Dataflash IC's buffer, ready for
+ *  the buffer to be programmed into the page reserved by \ref FTL_AllocatePage(). Any command in progress on the selected
+ *  Dataflash IC is ended.
+ *
+ *  \param[in] LogicalPage      Logical page whose contents are held in the buffer
+ *  \param[in] UseSecondBuffer  Indicates if the page contents are held in the second rather than the first buffer
+ */
+void FTL_WritePageTag(const uint16_t LogicalPage,
+                      const bool UseSecondBuffer)
+{
+	FTL_PageTag_t Tag;
+	uint8_t*      TagBytes = (uint8_t*)&Tag;
+
+	Tag.LogicalPage = LogicalPage;
+	Tag.Sequence    = WriteSequence++;
+	Tag.Check       = FTL_TAG_CHECK_SEED;
+
+	for (uint8_t TagByte = 0; TagByte < offsetof(FTL_PageTag_t, Check); TagByte++)
+	  Tag.Check ^= TagBytes[TagByte];
+
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(UseSecondBuffer ? DF_CMD_BUFF2WRITE : DF_CMD_BUFF1WRITE);
+	Dataflash_SendAddressBytes(0, DATAFLASH_PAGE_SIZE);
+
+	for (uint8_t TagByte = 0; TagByte < sizeof(FTL_PageTag_t); TagByte++)
+	  Dataflash_SendByte(TagBytes[TagByte]);
+}
+
+/** Remaps a logical page to the physical page its new contents have been programmed into, releasing the physical page
+ *  holding its previous contents. If the remapping journal becomes full, the affected map pages are rewritten, which
+ *  requires all the Dataflash buffers to be free once any page program in progress has completed.
+ *
+ *  \param[in] LogicalPage   Logical page which has been written
+ *  \param[in] PhysicalPage  Physical page reserved by \ref FTL_AllocatePage() which the new contents were programmed into
+ *  \param[in] ReplacedPage  Physical page previously holding the logical page, or \ref FTL_UNMAPPED_PAGE if none
+ */
+void FTL_CommitPage(const uint16_t LogicalPage,
+                    const uint16_t PhysicalPage,
+                    const uint16_t ReplacedPage)
+{
+	uint8_t EntryIndex;
+
+	if (ReplacedPage != FTL_UNMAPPED_PAGE)
+	  FTL_SetPageValid(ReplacedPage, false);
+
+	for (EntryIndex = 0; EntryIndex < JournalEntries; EntryIndex++)
+	{
+		if (Journal[EntryIndex].LogicalPage == LogicalPage)
+		  break;
+	}
+
+	Journal[EntryIndex].LogicalPage  = LogicalPage;
+	Journal[EntryIndex].PhysicalPage = PhysicalPage;
+
+	if ((EntryIndex == JournalEntries) && (++JournalEntries == FTL_JOURNAL_ENTRIES))
+	  FTL_FlushMap();
+}
+
+/** Writes all journalled remappings into their map pages, rewriting each affected map page once. This waits for any page
+ *  program in progress to complete, and uses the first buffer of each Dataflash IC, which is free again on return.
+ */
+void FTL_FlushMap(void)
+{
+	FTL_WaitWhileAllBusy();
+
+	while (JournalEntries)
+	{
+		uint8_t  MapPage      = (Journal[0].LogicalPage / FTL_MAP_ENTRIES_PER_PAGE);
+		uint16_t ReplacedPage = MapLocations[MapPage];
+		uint16_t PhysicalPage = FTL_AllocatePhysicalPage((FTL_LOGICAL_PAGES + MapPage) % DATAFLASH_TOTALCHIPS);
+
+		Dataflash_SelectChipFromPage(PhysicalPage);
+		Dataflash_WaitWhileBusy();
+
+		/* Load the current map page contents into the buffer, or an empty map if the map page has not yet been written */
+		if (ReplacedPage != FTL_UNMAPPED_PAGE)
+		{
+			Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
+			Dataflash_SendAddressBytes(ReplacedPage, 0);
+			Dataflash_WaitWhileBusy();
+		}
+		else
+		{
+			Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+			Dataflash_SendAddressBytes(0, 0);
+
+			for (uint16_t MapByte = 0; MapByte < DATAFLASH_PAGE_SIZE; MapByte++)
+			  Dataflash_SendByte(0xFF);
+		}
+
+		/* Update the map entries of all journalled remappings held in the map page, removing them from the journal */
+		for (uint8_t EntryIndex = 0; EntryIndex < JournalEntries;)
+		{
+			uint16_t LogicalPage = Journal[EntryIndex].LogicalPage;
+
+			if ((LogicalPage / FTL_MAP_ENTRIES_PER_PAGE) != MapPage)
+			{
+				EntryIndex++;
+				continue;
+			}
+
+			Dataflash_ToggleSelectedChipCS();
+			Dataflash_SendByte(DF_CMD_BUFF1WRITE);
+			Dataflash_SendAddressBytes(0, ((LogicalPage % FTL_MAP_ENTRIES_PER_PAGE) * sizeof(uint16_t)));
+			Dataflash_SendByte(Journal[EntryIndex].PhysicalPage & 0xFF);
+			Dataflash_SendByte(Journal[EntryIndex].PhysicalPage >> 8);
+
+			Journal[EntryIndex] = Journal[--JournalEntries];
+		}
+
+		/* Program the updated map page into its new location */
+		FTL_WritePageTag(FTL_LOGICAL_PAGES + MapPage, false);
+		Dataflash_ToggleSelectedChipCS();
+		Dataflash_SendByte(DF_CMD_BUFF1TOMAINMEMWITHERASE);
+		Dataflash_SendAddressBytes(PhysicalPage, 0);
+		Dataflash_DeselectChip();
+
+		MapLocations[MapPage] = PhysicalPage;
+
+		if (ReplacedPage != FTL_UNMAPPED_PAGE)
+		  FTL_SetPageValid(ReplacedPage, false);
+	}
+
+	/* Map entries read before the map was updated are now stale */
+	LookupCacheStart = FTL_UNMAPPED_PAGE;
+
+	/* Wait for the last map page program to complete, so that the caller may reuse any Dataflash buffer */
+	FTL_WaitWhileAllBusy();
+}
+
+/** Performs background maintenance of the translation layer while the device is idle, writing any journalled remappings
+ *  into the map and moving static data so that its pages rejoin the free page pool. This should only be called while no
+ *  Dataflash buffer holds data waiting to be programmed.
+ */
+void FTL_Task(void)
+{
+	if (JournalEntries)
+	{
+		FTL_FlushMap();
+		return;
+	}
+
+	if (SkippedValidPages < FTL_WEAR_LEVEL_INTERVAL)
+	  return;
+
+	uint16_t StaticPage = LastSkippedPage;
+
+	SkippedValidPages = 0;
+
+	if ((StaticPage == FTL_UNMAPPED_PAGE) || !(FTL_IsPageValid(StaticPage)))
+	  return;
+
+	FTL_PageTag_t Tag;
+
+	/* Map pages are moved each time they are rewritten, only static logical pages need to be moved */
+	FTL_ReadPageTag(StaticPage, &Tag);
+
+	if (Tag.LogicalPage >= FTL_LOGICAL_PAGES)
+	  return;
+
+	uint16_t PhysicalPage = FTL_AllocatePage(Tag.LogicalPage);
+
+	FTL_WaitWhileAllBusy();
+
+	/* Copy the page contents into a new physical page through the Dataflash buffer, with a new tag */
+	Dataflash_SelectChipFromPage(PhysicalPage);
+	Dataflash_SendByte(DF_CMD_MAINMEMTOBUFF1);
+	Dataflash_SendAddressBytes(StaticPage, 0);
+	Dataflash_WaitWhileBusy();
+
+	FTL_WritePageTag(Tag.LogicalPage, false);
+	Dataflash_ToggleSelectedChipCS();
+	Dataflash_SendByte(DF_CMD_BUFF1TOMAINMEMWITHERASE);
+	Dataflash_SendAddressBytes(PhysicalPage, 0);
+	Dataflash_DeselectChip();
+
+	FTL_CommitPage(Tag.LogicalPage, PhysicalPage, StaticPage);
+
+	/* Wait for the page program to complete, as the Dataflash manager may next write into either buffer of the IC */
+	FTL_WaitWhileAllBusy();
+}
+
+/** Advances the write head of the given Dataflash IC to its next free physical page, and reserves it.
+ *
+ *  \param[in] Chip  Index of the Dataflash IC whose write head is to be advanced
+ *
+ *  \return Physical page address of the reserved page
+ */
+static uint16_t FTL_AllocatePhysicalPage(const uint8_t Chip)
+{
+	for (;;)
+	{
+		uint16_t PhysicalPage = WriteHeads[Chip];
+
+		if ((WriteHeads[Chip] += DATAFLASH_TOTALCHIPS) >= FTL_PHYSICAL_PAGES)
+		  WriteHeads[Chip] = Chip;
+
+		/* Reserved pages guarantee that each IC has free pages, so the head will always find one */
+		if (!(FTL_IsPageValid(PhysicalPage)))
+		{
+			FTL_SetPageValid(PhysicalPage, true);
+			return PhysicalPage;
+		}
+
+		SkippedValidPages++;
+		LastSkippedPage = PhysicalPage;
+	}
+}
+
+/** Retrieves the physical page given for a logical page in its map page, ignoring the journal.
+ *
+ *  \param[in] LogicalPage  Logical page whose map entry is to be retrieved
+ *
+ *  \return Physical page address, or \ref FTL_UNMAPPED_PAGE if no mapping has been written to the map
+ */
+static uint16_t FTL_GetMappedPage(const uint16_t LogicalPage)
+{
+	/* Cached blocks of map entries are aligned, so that an empty cache's start page never matches a requested entry's block */
+	if ((LogicalPage & ~(FTL_LOOKUP_CACHE_ENTRIES - 1)) != LookupCacheStart)
+	{
+		uint16_t MapLocation = MapLocations[LogicalPage / FTL_MAP_ENTRIES_PER_PAGE];
+
+		LookupCacheStart = (LogicalPage & ~(FTL_LOOKUP_CACHE_ENTRIES - 1));
+
+		if (MapLocation == FTL_UNMAPPED_PAGE)
+		{
+			memset(LookupCache, 0xFF, sizeof(LookupCache));
+		}
+		else
+		{
+			/* Read in the block of map entries containing the requested entry */
+			Dataflash_SelectChipFromPage(MapLocation);
+			Dataflash_WaitWhileBusy();
+			Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+			Dataflash_SendAddressBytes(MapLocation, ((LookupCacheStart % FTL_MAP_ENTRIES_PER_PAGE) * sizeof(uint16_t)));
+			Dataflash_SendByte(0x00);
+			Dataflash_SendByte(0x00);
+			Dataflash_SendByte(0x00);
+			Dataflash_SendByte(0x00);
+
+			for (uint8_t EntryIndex = 0; EntryIndex < FTL_LOOKUP_CACHE_ENTRIES; EntryIndex++)
+			{
+				uint8_t EntryLow = Dataflash_ReceiveByte();
+
+				LookupCache[EntryIndex] = (((uint16_t)Dataflash_ReceiveByte() << 8) | EntryLow);
+			}
+
+			Dataflash_DeselectChip();
+		}
+	}
+
+	return LookupCache[LogicalPage & (FTL_LOOKUP_CACHE_ENTRIES - 1)];
+}
+
+/** Reads the tag of the given physical page. Tags which fail the check byte test, such as those of erased pages or pages
+ *  written without the translation layer, are returned with a logical page of \ref FTL_UNMAPPED_PAGE.
+ *
+ *  \param[in]  PhysicalPage  Physical page whose tag is to be read
+ *  \param[out] Tag           Pointer to the location where the read tag is to be stored
+ */
+static void FTL_ReadPageTag(const uint16_t PhysicalPage,
+                            FTL_PageTag_t* const Tag)
+{
+	uint8_t* TagBytes = (uint8_t*)Tag;
+	uint8_t  Check    = FTL_TAG_CHECK_SEED;
+
+	Dataflash_SelectChipFromPage(PhysicalPage);
+	Dataflash_WaitWhileBusy();
+	Dataflash_SendByte(DF_CMD_MAINMEMPAGEREAD);
+	Dataflash_SendAddressBytes(PhysicalPage, DATAFLASH_PAGE_SIZE);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+	Dataflash_SendByte(0x00);
+
+	for (uint8_t TagByte = 0; TagByte < sizeof(FTL_PageTag_t); TagByte++)
+	{
+		TagBytes[TagByte] = Dataflash_ReceiveByte();
+
+		if (TagByte < offsetof(FTL_PageTag_t, Check))
+		  Check ^= TagBytes[TagByte];
+	}
+
+	Dataflash_DeselectChip();
+
+	if ((Check != Tag->Check) || (Tag->LogicalPage >= (FTL_LOGICAL_PAGES + FTL_MAP_PAGES)))
+	  Tag->LogicalPage = FTL_UNMAPPED_PAGE;
+}
+
+/** Determines if the given physical page holds the live contents of a logical or map page, or is reserved for new contents.
+ *
+ *  \param[in] PhysicalPage  Physical page to check
+ *
+ *  \return Boolean true if the page is in use, false if it is free
+ */
+static bool FTL_IsPageValid(const uint16_t PhysicalPage)
+{
+	return ((ValidPages[PhysicalPage / 8] & (1 << (PhysicalPage % 8))) ? true : false);
+}
+
+/** Marks the given physical page as being in use or free.
+ *
+ *  \param[in] PhysicalPage  Physical page to mark
+ *  \param[in] Valid         Indicates if the page is in use rather than free
+ */
+static void FTL_SetPageValid(const uint16_t PhysicalPage,
+                             const bool Valid)
+{
+	if (Valid)
+	  ValidPages[PhysicalPage / 8] |=  (1 << (PhysicalPage % 8));
+	else
+	  ValidPages[PhysicalPage / 8] &= ~(1 << (PhysicalPage % 8));
+}
+
+/** Waits until all the Dataflash ICs have completed any page program operations, so that both buffers of each IC are free. */
+static void FTL_WaitWhileAllBusy(void)
+{
+	Dataflash_SelectChip(DATAFLASH_CHIP1);
+	Dataflash_WaitWhileBusy();
+
+	#if (DATAFLASH_TOTALCHIPS == 2)
+	Dataflash_SelectChip(DATAFLASH_CHIP2);
+	Dataflash_WaitWhileBusy();
+	#endif
+
+	Dataflash_DeselectChip();
+}
+
+#endif
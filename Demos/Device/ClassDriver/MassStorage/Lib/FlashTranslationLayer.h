@@ -0,0 +1,146 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for FlashTranslationLayer.c.
+ */
+ 
+#ifndef _FLASH_TRANSLATION_LAYER_H_
+#define _FLASH_TRANSLATION_LAYER_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+		#include <string.h>
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/Board/Dataflash.h>
+
+	/* Macros: */
+		/** Page address value indicating that a logical page has no physical page mapped to it. */
+		#define FTL_UNMAPPED_PAGE               0xFFFF
+
+		#if defined(USE_DATAFLASH_FTL) || defined(__DOXYGEN__)
+			/** Total number of physical pages of the storage medium, comprised of one or more Dataflash ICs. */
+			#define FTL_PHYSICAL_PAGES          ((uint16_t)DATAFLASH_PAGES * DATAFLASH_TOTALCHIPS)
+
+			/** Number of logical to physical page map entries stored in each map page. */
+			#define FTL_MAP_ENTRIES_PER_PAGE    (DATAFLASH_PAGE_SIZE / sizeof(uint16_t))
+
+			/** Total number of logical pages presented to the host. One eighth of the physical pages are held in
+			 *  reserve, so that each Dataflash IC always has free pages to write new page contents to.
+			 */
+			#define FTL_LOGICAL_PAGES           ((((FTL_PHYSICAL_PAGES / 8) * 7) / FTL_MAP_ENTRIES_PER_PAGE) * FTL_MAP_ENTRIES_PER_PAGE)
+
+			/** Total number of map pages, each storing the physical page addresses of \ref FTL_MAP_ENTRIES_PER_PAGE logical pages. */
+			#define FTL_MAP_PAGES               (FTL_LOGICAL_PAGES / FTL_MAP_ENTRIES_PER_PAGE)
+
+			#if !defined(FTL_JOURNAL_ENTRIES) || defined(__DOXYGEN__)
+				/** Number of logical page remappings which are held in RAM before the affected map pages are rewritten. Each
+				 *  map page is rewritten once for all the journal entries it holds, so larger values reduce the number of map
+				 *  page programs at the cost of four bytes of RAM per entry.
+				 */
+				#define FTL_JOURNAL_ENTRIES     32
+			#endif
+
+			#if !defined(FTL_LOOKUP_CACHE_ENTRIES) || defined(__DOXYGEN__)
+				/** Number of consecutive map entries read from a map page into RAM at once, so that sequential accesses do not
+				 *  need to read the map page for each page. This must be a power of two.
+				 */
+				#define FTL_LOOKUP_CACHE_ENTRIES 16
+			#endif
+
+			#if !defined(FTL_WEAR_LEVEL_INTERVAL) || defined(__DOXYGEN__)
+				/** Number of valid pages skipped over by the write heads after which a page of static data is moved, so that
+				 *  pages holding data which is never rewritten are eventually returned to the free page pool.
+				 */
+				#define FTL_WEAR_LEVEL_INTERVAL 1024
+			#endif
+
+			/** Seed value for the check byte of each page tag, so that erased or non-FTL page contents are not mistaken
+			 *  for valid page tags.
+			 */
+			#define FTL_TAG_CHECK_SEED          0x5A
+		#else
+			#define FTL_GetPhysicalPage(LogicalPage)                          (LogicalPage)
+			#define FTL_AllocatePage(LogicalPage)                             (LogicalPage)
+			#define FTL_WritePageTag(LogicalPage, UseSecondBuffer)            MACROS{ }MACROE
+			#define FTL_CommitPage(LogicalPage, PhysicalPage, ReplacedPage)   MACROS{ }MACROE
+			#define FTL_Init()                                                MACROS{ }MACROE
+			#define FTL_FlushMap()                                            MACROS{ }MACROE
+			#define FTL_Task()                                                MACROS{ }MACROE
+		#endif
+
+	/* Type Defines: */
+		/** Type define for the tag stored in the spare bytes following the data area of each physical page, identifying
+		 *  the logical page stored in it and the order in which it was written.
+		 */
+		typedef struct
+		{
+			uint16_t LogicalPage; /**< Logical page stored in the physical page, or a map page index added to \ref FTL_LOGICAL_PAGES */
+			uint32_t Sequence; /**< Value of the global write sequence counter when the page was written */
+			uint8_t  Check; /**< XOR of the preceding tag bytes and \ref FTL_TAG_CHECK_SEED */
+		} FTL_PageTag_t;
+
+		/** Type define for an entry in the RAM journal of logical pages remapped since their map page was last written. */
+		typedef struct
+		{
+			uint16_t LogicalPage; /**< Remapped logical page */
+			uint16_t PhysicalPage; /**< Physical page now holding the logical page's contents */
+		} FTL_JournalEntry_t;
+
+	/* Function Prototypes: */
+		#if defined(USE_DATAFLASH_FTL) || defined(__DOXYGEN__)
+			void     FTL_Init(void);
+			uint16_t FTL_GetPhysicalPage(const uint16_t LogicalPage);
+			uint16_t FTL_AllocatePage(const uint16_t LogicalPage);
+			void     FTL_WritePageTag(const uint16_t LogicalPage,
+			                          const bool UseSecondBuffer);
+			void     FTL_CommitPage(const uint16_t LogicalPage,
+			                        const uint16_t PhysicalPage,
+			                        const uint16_t ReplacedPage);
+			void     FTL_FlushMap(void);
+			void     FTL_Task(void);
+		#endif
+
+		#if defined(INCLUDE_FROM_FLASHTRANSLATIONLAYER_C)
+			static uint16_t FTL_AllocatePhysicalPage(const uint8_t Chip);
+			static uint16_t FTL_GetMappedPage(const uint16_t LogicalPage);
+			static void     FTL_ReadPageTag(const uint16_t PhysicalPage,
+			                                FTL_PageTag_t* const Tag);
+			static bool     FTL_IsPageValid(const uint16_t PhysicalPage);
+			static void     FTL_SetPageValid(const uint16_t PhysicalPage,
+			                                 const bool Valid);
+			static void     FTL_WaitWhileAllBusy(void);
+		#endif
+
+#endif
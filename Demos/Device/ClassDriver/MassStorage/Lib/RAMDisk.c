@@ -0,0 +1,178 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Block device backend storing the disk contents in RAM, rather than the board Dataflash IC(s). This serves the first
+ *  Logical Unit of the device when USE_RAMDISK is defined in the project makefile and passed to the compiler via the -D
+ *  switch, so that the throughput of the USB and SCSI command processing can be measured without the Dataflash access
+ *  times. The contents are lost when the device is reset.
+ */
+
+#define  INCLUDE_FROM_RAMDISK_C
+#include "RAMDisk.h"
+
+#if defined(USE_RAMDISK)
+
+/** Contents of the RAM disk. */
+static uint8_t RAMDiskData[RAMDISK_BLOCKS][VIRTUAL_MEMORY_BLOCK_SIZE];
+
+/** Block device backend serving a Logical Unit from the RAM disk. */
+const BlockDevice_Backend_t RAMDisk_Backend =
+	{
+		.GetTotalBlocks = RAMDisk_GetTotalBlocks,
+		.ReadBlocks     = RAMDisk_ReadBlocks,
+		.WriteBlocks    = RAMDisk_WriteBlocks,
+		.CheckOperation = RAMDisk_CheckOperation,
+		.Flush          = NULL,
+		.Task           = NULL,
+	};
+
+/** Retrieves the total number of blocks of the RAM disk.
+ *
+ *  \param[in] LUN  Index of the Logical Unit the RAM disk is serving
+ *
+ *  \return Total number of blocks of the RAM disk
+ */
+static uint32_t RAMDisk_GetTotalBlocks(const uint8_t LUN)
+{
+	return RAMDISK_BLOCKS;
+}
+
+/** Reads blocks from the RAM disk, and writes them to the host via the Mass Storage data IN endpoint.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] BlockAddress     Data block to start reading from
+ *  \param[in] TotalBlocks      Number of blocks of data to read
+ *
+ *  \return Boolean true if the blocks were read, false if the transfer was aborted
+ */
+static bool RAMDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                               const uint32_t BlockAddress,
+                               uint32_t TotalBlocks)
+{
+	uint8_t* DataPtr = RAMDiskData[BlockAddress];
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return false;
+
+	while (TotalBlocks--)
+	{
+		for (uint8_t BytesInBlockDiv16 = 0; BytesInBlockDiv16 < (VIRTUAL_MEMORY_BLOCK_SIZE >> 4); BytesInBlockDiv16++)
+		{
+			/* Check if the endpoint is currently full */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the endpoint bank to send its contents to the host */
+				Endpoint_ClearIN();
+
+				/* Wait until the endpoint is ready for more data */
+				if (Endpoint_WaitUntilReady())
+				  return false;
+			}
+
+			/* Send one 16-byte chunk of data from the RAM disk */
+			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+			  Endpoint_Write_Byte(*(DataPtr++));
+
+			/* Check if the current command is being aborted by the host */
+			if (MSInterfaceInfo->State.IsMassStoreReset)
+			  return false;
+		}
+	}
+
+	/* If the endpoint is full, send its contents to the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearIN();
+
+	return true;
+}
+
+/** Writes blocks read from the host via the Mass Storage data OUT endpoint to the RAM disk.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to a structure containing a Mass Storage Class configuration and state
+ *  \param[in] BlockAddress     Data block to start writing to
+ *  \param[in] TotalBlocks      Number of blocks of data to write
+ *
+ *  \return Boolean true if the blocks were written, false if the transfer was aborted
+ */
+static bool RAMDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                const uint32_t BlockAddress,
+                                uint32_t TotalBlocks)
+{
+	uint8_t* DataPtr = RAMDiskData[BlockAddress];
+
+	/* Wait until endpoint is ready before continuing */
+	if (Endpoint_WaitUntilReady())
+	  return false;
+
+	while (TotalBlocks--)
+	{
+		for (uint8_t BytesInBlockDiv16 = 0; BytesInBlockDiv16 < (VIRTUAL_MEMORY_BLOCK_SIZE >> 4); BytesInBlockDiv16++)
+		{
+			/* Check if the endpoint is currently empty */
+			if (!(Endpoint_IsReadWriteAllowed()))
+			{
+				/* Clear the current endpoint bank */
+				Endpoint_ClearOUT();
+
+				/* Wait until the host has sent another packet */
+				if (Endpoint_WaitUntilReady())
+				  return false;
+			}
+
+			/* Store one 16-byte chunk of data in the RAM disk */
+			for (uint8_t ByteNum = 0; ByteNum < 16; ByteNum++)
+			  *(DataPtr++) = Endpoint_Read_Byte();
+
+			/* Check if the current command is being aborted by the host */
+			if (MSInterfaceInfo->State.IsMassStoreReset)
+			  return false;
+		}
+	}
+
+	/* If the endpoint is empty, clear it ready for the next packet from the host */
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  Endpoint_ClearOUT();
+
+	return true;
+}
+
+/** Checks the RAM disk for the SCSI SEND DIAGNOSTIC command, which always succeeds as there is no medium to fail.
+ *
+ *  \return Boolean true in all cases
+ */
+static bool RAMDisk_CheckOperation(void)
+{
+	return true;
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for RAMDisk.c.
+ */
+ 
+#ifndef _RAM_DISK_H_
+#define _RAM_DISK_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+
+		#include "MassStorage.h"
+		#include "BlockDevice.h"
+		#include "DataflashManager.h"
+
+		#include <LUFA/Common/Common.h>
+		#include <LUFA/Drivers/USB/USB.h>
+		#include <LUFA/Drivers/USB/Class/MassStorage.h>
+
+	/* Defines: */
+		#if defined(USE_RAMDISK) || defined(__DOXYGEN__)
+			#if !defined(RAMDISK_BLOCKS) || defined(__DOXYGEN__)
+				/** Total number of blocks of the RAM disk, each \ref VIRTUAL_MEMORY_BLOCK_SIZE bytes of RAM. */
+				#define RAMDISK_BLOCKS            8
+			#endif
+		#endif
+
+	/* External Variables: */
+		#if defined(USE_RAMDISK) || defined(__DOXYGEN__)
+			extern const BlockDevice_Backend_t RAMDisk_Backend;
+		#endif
+
+	/* Function Prototypes: */
+		#if defined(INCLUDE_FROM_RAMDISK_C) && defined(USE_RAMDISK)
+			static uint32_t RAMDisk_GetTotalBlocks(const uint8_t LUN);
+			static bool     RAMDisk_ReadBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                   const uint32_t BlockAddress,
+			                                   uint32_t TotalBlocks);
+			static bool     RAMDisk_WriteBlocks(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                    const uint32_t BlockAddress,
+			                                    uint32_t TotalBlocks);
+			static bool     RAMDisk_CheckOperation(void);
+		#endif
+
+#endif
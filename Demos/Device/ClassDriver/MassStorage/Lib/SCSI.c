@@ -104,14 +104,25 @@ bool SCSI_DecodeSCSICommand(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 		case SCSI_CMD_READ_CAPACITY_10:
 			CommandSuccess = SCSI_Command_Read_Capacity_10(MSInterfaceInfo);			
 			break;
+		case SCSI_CMD_SERVICE_ACTION_IN_16:
+			CommandSuccess = SCSI_Command_Read_Capacity_16(MSInterfaceInfo);
+			break;
 		case SCSI_CMD_SEND_DIAGNOSTIC:
 			CommandSuccess = SCSI_Command_Send_Diagnostic(MSInterfaceInfo);
 			break;
+		case SCSI_CMD_SYNCHRONIZE_CACHE_10:
+		case SCSI_CMD_START_STOP_UNIT:
+			CommandSuccess = SCSI_Command_Synchronize_Cache(MSInterfaceInfo);
+			break;
 		case SCSI_CMD_WRITE_10:
-			CommandSuccess = SCSI_Command_ReadWrite_10(MSInterfaceInfo, DATA_WRITE);
+		case SCSI_CMD_WRITE_12:
+		case SCSI_CMD_WRITE_16:
+			CommandSuccess = SCSI_Command_ReadWrite(MSInterfaceInfo, DATA_WRITE);
 			break;
 		case SCSI_CMD_READ_10:
-			CommandSuccess = SCSI_Command_ReadWrite_10(MSInterfaceInfo, DATA_READ);
+		case SCSI_CMD_READ_12:
+		case SCSI_CMD_READ_16:
+			CommandSuccess = SCSI_Command_ReadWrite(MSInterfaceInfo, DATA_READ);
 			break;
 		case SCSI_CMD_TEST_UNIT_READY:
 		case SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL:
@@ -215,7 +226,8 @@ static bool SCSI_Command_Request_Sense(USB_ClassInfo_MS_Device_t* const MSInterf
  */
 static bool SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
 {
-	uint32_t LastBlockAddressInLUN = (LUN_MEDIA_BLOCKS - 1);
+	uint8_t  LUN                   = MSInterfaceInfo->State.CommandBlock.LUN;
+	uint32_t LastBlockAddressInLUN = (LUNBackends[LUN]->GetTotalBlocks(LUN) - 1);
 	uint32_t MediaBlockSize        = VIRTUAL_MEMORY_BLOCK_SIZE;
 
 	Endpoint_Write_Stream_BE(&LastBlockAddressInLUN, sizeof(LastBlockAddressInLUN), NO_STREAM_CALLBACK);
@@ -228,9 +240,52 @@ static bool SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* const MSInt
 	return true;
 }
 
-/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the Dataflash ICs on the
- *  board, and indicates if they are present and functioning correctly. Only the Self-Test portion of the diagnostic command is
- *  supported.
+/** Command processing for an issued SCSI READ CAPACITY (16) command, issued as a SERVICE ACTION IN (16) command. This command
+ *  returns the same information as the READ CAPACITY (10) command, with the 64-bit last block address used by hosts for media
+ *  larger than 2TB. No protection information or logical block provisioning is supported.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+ *
+ *  \return Boolean true if the command completed successfully, false otherwise.
+ */
+static bool SCSI_Command_Read_Capacity_16(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	uint8_t* CommandData = MSInterfaceInfo->State.CommandBlock.SCSICommandData;
+	uint8_t  LUN         = MSInterfaceInfo->State.CommandBlock.LUN;
+
+	/* Check that the service action is READ CAPACITY (16), the only supported SERVICE ACTION IN (16) command */
+	if ((CommandData[1] & 0x1F) != SCSI_SERVICE_ACTION_READ_CAPACITY_16)
+	{
+		/* Unsupported service action - update the SENSE key and fail the request */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		               SCSI_ASENSE_INVALID_FIELD_IN_CDB,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return false;
+	}
+
+	uint32_t AllocationLength = SwapEndian_32(*(uint32_t*)&CommandData[10]);
+	uint8_t  CapacityData[32];
+
+	/* Build the response, with the upper 32 bits of the last block address and all the unsupported fields cleared */
+	memset(CapacityData, 0x00, sizeof(CapacityData));
+	*(uint32_t*)&CapacityData[4] = SwapEndian_32(LUNBackends[LUN]->GetTotalBlocks(LUN) - 1);
+	*(uint32_t*)&CapacityData[8] = SwapEndian_32(VIRTUAL_MEMORY_BLOCK_SIZE);
+
+	uint8_t BytesTransferred = (AllocationLength < sizeof(CapacityData)) ? AllocationLength : sizeof(CapacityData);
+
+	Endpoint_Write_Stream_LE(CapacityData, BytesTransferred, NO_STREAM_CALLBACK);
+	Endpoint_ClearIN();
+
+	/* Succeed the command and update the bytes transferred counter */
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= BytesTransferred;
+
+	return true;
+}
+
+/** Command processing for an issued SCSI SEND DIAGNOSTIC command. This command performs a quick check of the storage medium of
+ *  the selected Logical Unit, and indicates if it is present and functioning correctly. Only the Self-Test portion of the
+ *  diagnostic command is supported.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
  *
@@ -249,8 +304,8 @@ static bool SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* const MSInte
 		return false;
 	}
 	
-	/* Check to see if all attached Dataflash ICs are functional */
-	if (!(DataflashManager_CheckDataflashOperation()))
+	/* Check to see if the storage medium of the Logical Unit is functional */
+	if (!(LUNBackends[MSInterfaceInfo->State.CommandBlock.LUN]->CheckOperation()))
 	{
 		/* Update SENSE key with a hardware error condition and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_HARDWARE_ERROR,
@@ -266,29 +321,70 @@ static bool SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* const MSInte
 	return true;
 }
 
-/** Command processing for an issued SCSI READ (10) or WRITE (10) command. This command reads in the block start address
- *  and total number of blocks to process, then calls the appropriate low-level Dataflash routine to handle the actual
+/** Command processing for an issued SCSI SYNCHRONIZE CACHE (10) or START STOP UNIT command. This commits any written data
+ *  still held in volatile storage by the Logical Unit's backend to the storage medium, as the host issues these commands
+ *  before it relies on the written data persisting, such as before the device is ejected or powered down.
+ *
+ *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
+ *
+ *  \return Boolean true if the command completed successfully, false otherwise.
+ */
+static bool SCSI_Command_Synchronize_Cache(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo)
+{
+	const BlockDevice_Backend_t* Backend = LUNBackends[MSInterfaceInfo->State.CommandBlock.LUN];
+
+	if (Backend->Flush != NULL)
+	  Backend->Flush();
+
+	/* Succeed the command and update the bytes transferred counter */
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength = 0;
+	
+	return true;
+}
+
+/** Command processing for an issued SCSI READ (10), READ (12), READ (16), WRITE (10), WRITE (12) or WRITE (16) command. This
+ *  command reads in the block start address and total number of blocks to process, checks them against the capacity of the
+ *  Logical Unit and the data transfer the host expects, then calls the Logical Unit's block device backend to handle the actual
  *  reading and writing of the data.
  *
  *  \param[in] MSInterfaceInfo  Pointer to the Mass Storage class interface structure that the command is associated with
- *  \param[in] IsDataRead  Indicates if the command is a READ (10) command or WRITE (10) command (DATA_READ or DATA_WRITE)
+ *  \param[in] IsDataRead  Indicates if the command is a READ command or WRITE command (DATA_READ or DATA_WRITE)
  *
  *  \return Boolean true if the command completed successfully, false otherwise.
  */
-static bool SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
-                                      const bool IsDataRead)
+static bool SCSI_Command_ReadWrite(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+                                   const bool IsDataRead)
 {
+	uint8_t* CommandData = MSInterfaceInfo->State.CommandBlock.SCSICommandData;
+	uint8_t  LUN         = MSInterfaceInfo->State.CommandBlock.LUN;
 	uint32_t BlockAddress;
-	uint16_t TotalBlocks;
+	uint32_t TotalBlocks;
 	
-	/* Load in the 32-bit block address (SCSI uses big-endian, so have to reverse the byte order) */
-	BlockAddress = SwapEndian_32(*(uint32_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[2]);
+	/* Load in the block address and total blocks (SCSI uses big-endian, so have to reverse the byte order) */
+	switch (CommandData[0])
+	{
+		case SCSI_CMD_READ_16:
+		case SCSI_CMD_WRITE_16:
+			/* Block addresses which do not fit in 32 bits are past the end of any medium, clamp them to fail the range check */
+			BlockAddress = (*(uint32_t*)&CommandData[2]) ? 0xFFFFFFFF : SwapEndian_32(*(uint32_t*)&CommandData[6]);
+			TotalBlocks  = SwapEndian_32(*(uint32_t*)&CommandData[10]);
+			break;
+		case SCSI_CMD_READ_12:
+		case SCSI_CMD_WRITE_12:
+			BlockAddress = SwapEndian_32(*(uint32_t*)&CommandData[2]);
+			TotalBlocks  = SwapEndian_32(*(uint32_t*)&CommandData[6]);
+			break;
+		default:
+			BlockAddress = SwapEndian_32(*(uint32_t*)&CommandData[2]);
+			TotalBlocks  = SwapEndian_16(*(uint16_t*)&CommandData[7]);
+			break;
+	}
 
-	/* Load in the 16-bit total blocks (SCSI uses big-endian, so have to reverse the byte order) */
-	TotalBlocks  = SwapEndian_16(*(uint16_t*)&MSInterfaceInfo->State.CommandBlock.SCSICommandData[7]);
-	
-	/* Check if the block address is outside the maximum allowable value for the LUN */
-	if (BlockAddress >= LUN_MEDIA_BLOCKS)
+	const BlockDevice_Backend_t* Backend     = LUNBackends[LUN];
+	uint32_t                     MediaBlocks = Backend->GetTotalBlocks(LUN);
+
+	/* Check if any of the requested blocks are outside the maximum allowable value for the LUN */
+	if ((BlockAddress >= MediaBlocks) || (TotalBlocks > (MediaBlocks - BlockAddress)))
 	{
 		/* Block address is invalid, update SENSE key and return command fail */
 		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
@@ -298,19 +394,44 @@ static bool SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* const MSInterfa
 		return false;
 	}
 
-	#if (TOTAL_LUNS > 1)
-	/* Adjust the given block address to the real media address based on the selected LUN */
-	BlockAddress += ((uint32_t)MSInterfaceInfo->State.CommandBlock.LUN * LUN_MEDIA_BLOCKS);
-	#endif
-	
-	/* Determine if the packet is a READ (10) or WRITE (10) command, call appropriate function */
+	/* A transfer length of zero transfers no blocks */
+	if (!(TotalBlocks))
+	  return true;
+
+	bool     HostExpectsDataIn  = ((MSInterfaceInfo->State.CommandBlock.Flags & MS_COMMAND_DIR_DATA_IN) != 0);
+	uint32_t HostExpectedBlocks = (MSInterfaceInfo->State.CommandBlock.DataTransferLength / VIRTUAL_MEMORY_BLOCK_SIZE);
+
+	/* Check if the host expects the data in the other direction, or fewer bytes than the blocks to be transferred */
+	if ((HostExpectsDataIn != IsDataRead) || (TotalBlocks > HostExpectedBlocks))
+	{
+		/* Command does not match the Command Block Wrapper, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_ILLEGAL_REQUEST,
+		               SCSI_ASENSE_INVALID_FIELD_IN_CDB,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return false;
+	}
+
+	bool TransferSuccess;
+
+	/* Determine if the packet is a READ or WRITE command, call the appropriate backend function */
 	if (IsDataRead == DATA_READ)
-	  DataflashManager_ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  TransferSuccess = Backend->ReadBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
 	else
-	  DataflashManager_WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+	  TransferSuccess = Backend->WriteBlocks(MSInterfaceInfo, BlockAddress, TotalBlocks);
+
+	if (!(TransferSuccess))
+	{
+		/* Medium access failed or was aborted, update SENSE key and return command fail */
+		SCSI_SET_SENSE(SCSI_SENSE_KEY_MEDIUM_ERROR,
+		               SCSI_ASENSE_NO_ADDITIONAL_INFORMATION,
+		               SCSI_ASENSEQ_NO_QUALIFIER);
+
+		return false;
+	}
 
 	/* Update the bytes transferred counter and succeed the command */
-	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= ((uint32_t)TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
+	MSInterfaceInfo->State.CommandBlock.DataTransferLength -= (TotalBlocks * VIRTUAL_MEMORY_BLOCK_SIZE);
 	
 	return true;
 }
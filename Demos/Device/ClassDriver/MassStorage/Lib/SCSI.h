@@ -45,6 +45,7 @@
 
 		#include "MassStorage.h"
 		#include "Descriptors.h"
+		#include "BlockDevice.h"
 		#include "DataflashManager.h"
 	
 	/* Macros: */
@@ -60,10 +61,10 @@
 		                                                   SenseData.AdditionalSenseCode      = (Acode); \
 		                                                   SenseData.AdditionalSenseQualifier = (Aqual); }MACROE
 
-		/** Macro for the \ref SCSI_Command_ReadWrite_10() function, to indicate that data is to be read from the storage medium. */
+		/** Macro for the \ref SCSI_Command_ReadWrite() function, to indicate that data is to be read from the storage medium. */
 		#define DATA_READ           true
 
-		/** Macro for the \ref SCSI_Command_ReadWrite_10() function, to indicate that data is to be written to the storage medium. */
+		/** Macro for the \ref SCSI_Command_ReadWrite() function, to indicate that data is to be written to the storage medium. */
 		#define DATA_WRITE          false
 
 		/** Value for the DeviceType entry in the SCSI_Inquiry_Response_t enum, indicating a Block Media device. */
@@ -79,9 +80,11 @@
 			static bool SCSI_Command_Inquiry(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
 			static bool SCSI_Command_Request_Sense(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
 			static bool SCSI_Command_Read_Capacity_10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
+			static bool SCSI_Command_Read_Capacity_16(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
 			static bool SCSI_Command_Send_Diagnostic(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
-			static bool SCSI_Command_ReadWrite_10(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
-			                                      const bool IsDataRead);
+			static bool SCSI_Command_Synchronize_Cache(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo);
+			static bool SCSI_Command_ReadWrite(USB_ClassInfo_MS_Device_t* const MSInterfaceInfo,
+			                                   const bool IsDataRead);
 		#endif
 		
 #endif
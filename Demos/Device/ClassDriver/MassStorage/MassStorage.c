@@ -58,6 +58,24 @@ USB_ClassInfo_MS_Device_t Disk_MS_Interface =
 			},
 	};
 
+/** Block device backend serving each Logical Unit of the device, indexed by LUN. All Logical Units are served from the
+ *  Dataflash, except for the first which is served from RAM when USE_RAMDISK is defined.
+ */
+const BlockDevice_Backend_t* const LUNBackends[TOTAL_LUNS] =
+	{
+		[0 ... (TOTAL_LUNS - 1)] = &DataflashManager_Backend,
+
+		#if defined(USE_RAMDISK)
+		[0]                      = &RAMDisk_Backend,
+		#endif
+	};
+
+/** Flag to indicate that the written data held by the block device backends is to be committed to their storage media, set
+ *  by the USB bus events which may precede a loss of power. As the events are raised from the USB interrupt while the main
+ *  program loop may be part way through a Dataflash transfer, the backends are flushed from the main program loop.
+ */
+static volatile bool FlushRequested;
+
 /** Main program entry point. This routine contains the overall program flow, including initial
  *  setup of all components and the main program loop.
  */
@@ -71,6 +89,24 @@ int main(void)
 	for (;;)
 	{
 		MS_Device_USBTask(&Disk_MS_Interface);
+
+		for (uint8_t LUN = 0; LUN < TOTAL_LUNS; LUN++)
+		{
+			if (LUNBackends[LUN]->Task != NULL)
+			  LUNBackends[LUN]->Task();
+		}
+
+		if (FlushRequested)
+		{
+			FlushRequested = false;
+
+			for (uint8_t LUN = 0; LUN < TOTAL_LUNS; LUN++)
+			{
+				if (LUNBackends[LUN]->Flush != NULL)
+				  LUNBackends[LUN]->Flush();
+			}
+		}
+
 		USB_USBTask();
 	}
 }
@@ -89,10 +125,20 @@ void SetupHardware(void)
 	LEDs_Init();
 	SPI_Init(SPI_SPEED_FCPU_DIV_2 | SPI_ORDER_MSB_FIRST | SPI_SCK_LEAD_FALLING | SPI_SAMPLE_TRAILING | SPI_MODE_MASTER);
 	Dataflash_Init();
-	USB_Init();
 
 	/* Clear Dataflash sector protections, if enabled */
 	DataflashManager_ResetDataflashProtections();
+
+	/* Recover the flash translation layer's page map from the Dataflash, if enabled - this must complete before the USB
+	 * interface is started, as the host may issue commands as soon as the device enumerates */
+	FTL_Init();
+
+	/* Millisecond timebase for the Dataflash write idle timeout, polled from the main program loop */
+	OCR0A  = ((F_CPU / 64 / 1000) - 1);
+	TCCR0A = (1 << WGM01);                // CTC mode
+	TCCR0B = ((1 << CS01) | (1 << CS00)); // Fcpu/64 speed
+
+	USB_Init();
 }
 
 /** Event handler for the library USB Connection event. */
@@ -105,6 +151,20 @@ void EVENT_USB_Device_Connect(void)
 void EVENT_USB_Device_Disconnect(void)
 {
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
+
+	FlushRequested = true;
+}
+
+/** Event handler for the library USB Suspend event. */
+void EVENT_USB_Device_Suspend(void)
+{
+	FlushRequested = true;
+}
+
+/** Event handler for the library USB Reset event. */
+void EVENT_USB_Device_Reset(void)
+{
+	FlushRequested = true;
 }
 
 /** Event handler for the library USB Configuration Changed event. */
@@ -46,7 +46,9 @@
 		#include "Descriptors.h"
 
 		#include "Lib/SCSI.h"
+		#include "Lib/BlockDevice.h"
 		#include "Lib/DataflashManager.h"
+		#include "Lib/RAMDisk.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
@@ -72,14 +74,21 @@
 		/** Total number of logical drives within the device - must be non-zero. */
 		#define TOTAL_LUNS                1
 		
-		/** Blocks in each LUN, calculated from the total capacity divided by the total number of Logical Units in the device. */
+		/** Blocks in each LUN served from the Dataflash, calculated from the total capacity divided by the total number of Logical
+		 *  Units in the device.
+		 */
 		#define LUN_MEDIA_BLOCKS         (VIRTUAL_MEMORY_BLOCKS / TOTAL_LUNS)
+
+	/* External Variables: */
+		extern const BlockDevice_Backend_t* const LUNBackends[TOTAL_LUNS];
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
+		void EVENT_USB_Device_Suspend(void);
+		void EVENT_USB_Device_Reset(void);
 		void EVENT_USB_Device_ConfigurationChanged(void);
 		void EVENT_USB_Device_UnhandledControlRequest(void);
 
@@ -35,11 +35,18 @@
  *  device.
  */
  
+#define  INCLUDE_FROM_ARP_C
 #include "ARP.h"
 
+/** ARP cache, holding the MAC addresses of the hosts the device has most recently communicated with. Entries are kept
+ *  in most recently used order, so that the last entry is the one replaced when a new host's address must be cached.
+ */
+ARP_CacheEntry_t ARPCache[ARP_CACHE_ENTRIES];
+
+
 /** Processes an ARP packet inside an Ethernet frame, and writes the appropriate response
  *  to the output Ethernet frame if the host is requesting the IP or MAC address of the
- *  virtual server device on the network.
+ *  virtual server device on the network. The sender's address is recorded in the ARP cache.
  *
  *  \param[in] InDataStart   Pointer to the start of the incoming packet's ARP header
  *  \param[out] OutDataStart  Pointer to the start of the outgoing packet's ARP header
@@ -54,9 +61,16 @@ int16_t ARP_ProcessARPPacket(void* InDataStart,
 	ARP_Header_t* ARPHeaderIN  = (ARP_Header_t*)InDataStart;
 	ARP_Header_t* ARPHeaderOUT = (ARP_Header_t*)OutDataStart;
 
-	/* Ensure that the ARP request is a IPv4 request packet */
-	if ((SwapEndian_16(ARPHeaderIN->ProtocolType) == ETHERTYPE_IPV4) &&
-	    (SwapEndian_16(ARPHeaderIN->Operation) == ARP_OPERATION_REQUEST))
+	/* Only IPv4 address translations are supported */
+	if (SwapEndian_16(ARPHeaderIN->ProtocolType) != ETHERTYPE_IPV4)
+	  return NO_RESPONSE;
+
+	/* Update the sender's cached MAC address from any request or reply, including gratuitous ARP announcements, and only
+	 * add a new entry for the sender if the packet is addressed to the virtual webserver, as per RFC 826 */
+	ARP_UpdateCache(&ARPHeaderIN->SPA, &ARPHeaderIN->SHA, IP_COMPARE(&ARPHeaderIN->TPA, &ServerIPAddress));
+
+	/* Ensure that the ARP packet is a request packet */
+	if (SwapEndian_16(ARPHeaderIN->Operation) == ARP_OPERATION_REQUEST)
 	{
 		/* If the ARP packet is requesting the MAC or IP of the virtual webserver, return the response */
 		if (IP_COMPARE(&ARPHeaderIN->TPA, &ServerIPAddress) || 
@@ -84,3 +98,176 @@ int16_t ARP_ProcessARPPacket(void* InDataStart,
 	
 	return NO_RESPONSE;
 }
+
+/** Updates the ARP cache entry of a host with the host's current MAC address, resolving any pending request for the
+ *  host's address. The host's entry is refreshed and becomes the most recently used entry in the cache.
+ *
+ *  \param[in] IPAddress   Protocol IP address of the host
+ *  \param[in] MACAddress  Physical MAC address of the host
+ *  \param[in] AddEntry    If true, an entry is created for the host if it is not already in the cache
+ */
+void ARP_UpdateCache(const IP_Address_t* const IPAddress,
+                     const MAC_Address_t* const MACAddress,
+                     const bool AddEntry)
+{
+	/* Never cache the unspecified address used by unconfigured hosts, or entries claiming the webserver's own address */
+	if (!(IPAddress->Octets[0] | IPAddress->Octets[1] | IPAddress->Octets[2] | IPAddress->Octets[3]) ||
+	    IP_COMPARE(IPAddress, &ServerIPAddress))
+	{
+		return;
+	}
+
+	uint8_t CacheEntry = ARP_FindCacheEntry(IPAddress);
+
+	if (CacheEntry == ARP_CACHE_ENTRIES)
+	{
+		if (!(AddEntry))
+		  return;
+
+		/* Reuse the least recently used entry, unless a free entry is available */
+		CacheEntry = (ARP_CACHE_ENTRIES - 1);
+		
+		for (uint8_t FreeEntry = 0; FreeEntry < ARP_CACHE_ENTRIES; FreeEntry++)
+		{
+			if (ARPCache[FreeEntry].State == ARP_Entry_Free)
+			{
+				CacheEntry = FreeEntry;
+				break;
+			}
+		}
+		
+		ARPCache[CacheEntry].IPAddress = *IPAddress;
+	}
+
+	ARPCache[CacheEntry].MACAddress = *MACAddress;
+	ARPCache[CacheEntry].State      = ARP_Entry_Resolved;
+	ARPCache[CacheEntry].Timer      = ARP_CACHE_LIFETIME;
+	
+	ARP_MoveToFront(CacheEntry);
+}
+
+/** Retrieves the MAC address of a host on the network from the ARP cache. If the host's address is not known, an ARP
+ *  request for the address is written to the given output frame, unless one has already been sent within the last
+ *  \ref ARP_REQUEST_INTERVAL seconds. Data for the host should be held back until its address has been resolved.
+ *
+ *  \param[out] FrameOUT   Pointer to a free output Ethernet frame, for any ARP request that needs to be sent
+ *  \param[in]  IPAddress  Protocol IP address of the host whose MAC address is to be retrieved
+ *  \param[out] MACAddress Pointer to where the host's MAC address is to be stored
+ *
+ *  \return Boolean true if the host's MAC address is known, false otherwise
+ */
+bool ARP_ResolveAddress(Ethernet_Frame_Info_t* const FrameOUT,
+                        const IP_Address_t* const IPAddress,
+                        MAC_Address_t* const MACAddress)
+{
+	uint8_t CacheEntry = ARP_FindCacheEntry(IPAddress);
+
+	if (CacheEntry == ARP_CACHE_ENTRIES)
+	{
+		/* Create a pending entry for the host in place of the least recently used entry */
+		CacheEntry = (ARP_CACHE_ENTRIES - 1);
+
+		ARPCache[CacheEntry].IPAddress = *IPAddress;
+		ARPCache[CacheEntry].State     = ARP_Entry_Pending;
+		ARPCache[CacheEntry].Timer     = 0;
+	}
+	
+	ARP_MoveToFront(CacheEntry);
+	
+	if (ARPCache[0].State == ARP_Entry_Resolved)
+	{
+		*MACAddress = ARPCache[0].MACAddress;
+		return true;
+	}
+	
+	/* Request the host's address again once the request interval has elapsed since the last request */
+	if (!(ARPCache[0].Timer))
+	{
+		ARP_SendRequest(FrameOUT, IPAddress);
+		ARPCache[0].Timer = ARP_REQUEST_INTERVAL;
+	}
+
+	return false;
+}
+
+/** Ages the entries of the ARP cache, freeing resolved entries which have not been confirmed by their host within the last
+ *  \ref ARP_CACHE_LIFETIME seconds. This must be called once each second.
+ */
+void ARP_Tick(void)
+{
+	for (uint8_t CacheEntry = 0; CacheEntry < ARP_CACHE_ENTRIES; CacheEntry++)
+	{
+		ARP_CacheEntry_t* Entry = &ARPCache[CacheEntry];
+		
+		if ((Entry->State == ARP_Entry_Free) || !(Entry->Timer))
+		  continue;
+		
+		if (!(--Entry->Timer) && (Entry->State == ARP_Entry_Resolved))
+		  Entry->State = ARP_Entry_Free;
+	}
+}
+
+/** Searches the ARP cache for the entry of the given host.
+ *
+ *  \param[in] IPAddress  Protocol IP address of the host to search for
+ *
+ *  \return Index of the host's entry in the ARP cache, or ARP_CACHE_ENTRIES if the host is not in the cache
+ */
+static uint8_t ARP_FindCacheEntry(const IP_Address_t* const IPAddress)
+{
+	for (uint8_t CacheEntry = 0; CacheEntry < ARP_CACHE_ENTRIES; CacheEntry++)
+	{
+		if ((ARPCache[CacheEntry].State != ARP_Entry_Free) && IP_COMPARE(&ARPCache[CacheEntry].IPAddress, IPAddress))
+		  return CacheEntry;
+	}
+	
+	return ARP_CACHE_ENTRIES;
+}
+
+/** Moves the given ARP cache entry to the start of the cache, marking it as the most recently used entry.
+ *
+ *  \param[in] CacheEntry  Index of the entry in the ARP cache to move
+ */
+static void ARP_MoveToFront(const uint8_t CacheEntry)
+{
+	ARP_CacheEntry_t Entry = ARPCache[CacheEntry];
+
+	memmove(&ARPCache[1], &ARPCache[0], (CacheEntry * sizeof(ARP_CacheEntry_t)));
+	ARPCache[0] = Entry;
+}
+
+/** Constructs a complete Ethernet frame containing a broadcast ARP request for the MAC address of the given host, and
+ *  marks it ready for transmission.
+ *
+ *  \param[out] FrameOUT   Pointer to a free output Ethernet frame
+ *  \param[in]  IPAddress  Protocol IP address of the host whose MAC address is to be requested
+ */
+static void ARP_SendRequest(Ethernet_Frame_Info_t* const FrameOUT,
+                            const IP_Address_t* const IPAddress)
+{
+	Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT->FrameData;
+	ARP_Header_t*            ARPHeaderOUT   = (ARP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t)];
+
+	/* Fill out the ARP request header, with an unknown target MAC address */
+	ARPHeaderOUT->HardwareType = SwapEndian_16(ARP_HARDWARE_TYPE_ETHERNET);
+	ARPHeaderOUT->ProtocolType = SwapEndian_16(ETHERTYPE_IPV4);
+	ARPHeaderOUT->HLEN         = sizeof(MAC_Address_t);
+	ARPHeaderOUT->PLEN         = sizeof(IP_Address_t);
+	ARPHeaderOUT->Operation    = SwapEndian_16(ARP_OPERATION_REQUEST);
+	ARPHeaderOUT->SHA          = ServerMACAddress;
+	ARPHeaderOUT->SPA          = ServerIPAddress;
+	ARPHeaderOUT->TPA          = *IPAddress;
+
+	memset(&ARPHeaderOUT->THA, 0x00, sizeof(MAC_Address_t));
+
+	/* Fill out the request Ethernet frame header, broadcast to all hosts on the network */
+	FrameOUTHeader->Source      = ServerMACAddress;
+	FrameOUTHeader->Destination = BroadcastMACAddress;
+	FrameOUTHeader->EtherType   = SwapEndian_16(ETHERTYPE_ARP);
+
+	/* Set the request length in the buffer and indicate that it is ready to be sent */
+	FrameOUT->FrameLength       = (sizeof(Ethernet_Frame_Header_t) + sizeof(ARP_Header_t));
+	FrameOUT->FrameInBuffer     = true;
+
+	PROTOCOL_TRACE(PROTOCOL_TRACE_TX, false, FrameOUT->FrameLength, ETHERTYPE_ARP);
+}
@@ -38,6 +38,7 @@
 
 	/* Includes: */
 		#include <avr/io.h>
+		#include <stdbool.h>
 		#include <string.h>
 		
 		#include "EthernetProtocols.h"
@@ -51,6 +52,35 @@
 		/** ARP header operation constant, indicating a reply from a host giving an address translation. */
 		#define ARP_OPERATION_REPLY              2
 
+		/** ARP header hardware type constant, indicating Ethernet hardware addresses. */
+		#define ARP_HARDWARE_TYPE_ETHERNET       1
+
+		#if !defined(ARP_CACHE_ENTRIES) || defined(__DOXYGEN__)
+			/** Number of entries in the ARP cache, which holds the MAC addresses of the most recently used hosts on the network. */
+			#define ARP_CACHE_ENTRIES            4
+		#endif
+
+		#if !defined(ARP_CACHE_LIFETIME) || defined(__DOXYGEN__)
+			/** Time in seconds for which a resolved ARP cache entry remains valid after it was last confirmed by the host, up
+			 *  to a maximum of 255 seconds.
+			 */
+			#define ARP_CACHE_LIFETIME           120
+		#endif
+
+		#if !defined(ARP_REQUEST_INTERVAL) || defined(__DOXYGEN__)
+			/** Minimum time in seconds between repeated ARP requests for an address which has not yet been resolved. */
+			#define ARP_REQUEST_INTERVAL         1
+		#endif
+
+	/* Enums: */
+		/** Enum for the possible states of an ARP cache entry. */
+		enum ARP_CacheEntryStates_t
+		{
+			ARP_Entry_Free                   = 0, /**< Entry is unused */
+			ARP_Entry_Pending                = 1, /**< Entry IP address has been requested, but no reply has been received */
+			ARP_Entry_Resolved               = 2, /**< Entry IP address has been resolved to a MAC address */
+		};
+
 	/* Type Defines: */
 		/** Type define for an ARP packet inside an Ethernet frame. */
 		typedef struct
@@ -67,9 +97,32 @@
 			MAC_Address_t THA; /**< Target's hardware address */
 			IP_Address_t  TPA; /**< Target's protocol address */
 		} ARP_Header_t;
+
+		/** Type define for an ARP cache entry, mapping a host's IP address to its MAC address. */
+		typedef struct
+		{
+			IP_Address_t  IPAddress; /**< Protocol IP address of the host */
+			MAC_Address_t MACAddress; /**< Physical MAC address of the host, valid only if the entry is resolved */
+			uint8_t       State; /**< Current entry state, a value from the ARP_CacheEntryStates_t enum */
+			uint8_t       Timer; /**< Seconds until a resolved entry expires, or until a pending entry may be requested again */
+		} ARP_CacheEntry_t;
 		
 	/* Function Prototypes: */
 		int16_t ARP_ProcessARPPacket(void* InDataStart,
 		                             void* OutDataStart);
+		void    ARP_UpdateCache(const IP_Address_t* const IPAddress,
+		                        const MAC_Address_t* const MACAddress,
+		                        const bool AddEntry);
+		bool    ARP_ResolveAddress(Ethernet_Frame_Info_t* const FrameOUT,
+		                           const IP_Address_t* const IPAddress,
+		                           MAC_Address_t* const MACAddress);
+		void    ARP_Tick(void);
+
+		#if defined(INCLUDE_FROM_ARP_C)
+			static uint8_t ARP_FindCacheEntry(const IP_Address_t* const IPAddress);
+			static void    ARP_MoveToFront(const uint8_t CacheEntry);
+			static void    ARP_SendRequest(Ethernet_Frame_Info_t* const FrameOUT,
+			                               const IP_Address_t* const IPAddress);
+		#endif
 
 #endif
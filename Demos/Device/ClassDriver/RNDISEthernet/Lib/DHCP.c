@@ -59,19 +59,47 @@ int16_t DHCP_ProcessDHCPPacket(void* IPHeaderInStart,
 
 	DecodeDHCPHeader(DHCPHeaderInStart);
 
+	uint8_t MessageType = 0;
+
+	/* Find the Message Type DHCP option before the packet is altered, to determine the type of DHCP packet */
+	while (DHCPOptionsINStart[0] != DHCP_OPTION_END)
+	{	
+		if (DHCPOptionsINStart[0] == DHCP_OPTION_MESSAGETYPE)
+		{
+			MessageType = DHCPOptionsINStart[2];
+			break;
+		}
+		
+		/* Go to the next DHCP option - skip one byte if option is a padding byte, else skip the complete option's size */
+		DHCPOptionsINStart += ((DHCPOptionsINStart[0] == DHCP_OPTION_PAD) ? 1 : (DHCPOptionsINStart[1] + 2));
+	}
+
+	/* Only DHCP DISCOVER and REQUEST packets need a response */
+	if ((MessageType != DHCP_MESSAGETYPE_DISCOVER) && (MessageType != DHCP_MESSAGETYPE_REQUEST))
+	  return NO_RESPONSE;
+
+	/* Save the fields echoed back to the host, as the response may be built over the incoming packet */
+	uint8_t       HardwareType          = DHCPHeaderIN->HardwareType;
+	uint8_t       HardwareAddressLength = DHCPHeaderIN->HardwareAddressLength;
+	uint32_t      TransactionID         = DHCPHeaderIN->TransactionID;
+	uint16_t      Flags                 = DHCPHeaderIN->Flags;
+	MAC_Address_t ClientHardwareAddress;
+	
+	memcpy(&ClientHardwareAddress, &DHCPHeaderIN->ClientHardwareAddress, sizeof(MAC_Address_t));
+
 	/* Zero out the response DHCP packet, as much of it legacy and left at 0 */
 	memset(DHCPHeaderOUT, 0, sizeof(DHCP_Header_t));
 
 	/* Fill out the response DHCP packet */
-	DHCPHeaderOUT->HardwareType          = DHCPHeaderIN->HardwareType;
+	DHCPHeaderOUT->HardwareType          = HardwareType;
 	DHCPHeaderOUT->Operation             = DHCP_OP_BOOTREPLY;
-	DHCPHeaderOUT->HardwareAddressLength = DHCPHeaderIN->HardwareAddressLength;
+	DHCPHeaderOUT->HardwareAddressLength = HardwareAddressLength;
 	DHCPHeaderOUT->Hops                  = 0;
-	DHCPHeaderOUT->TransactionID         = DHCPHeaderIN->TransactionID;
+	DHCPHeaderOUT->TransactionID         = TransactionID;
 	DHCPHeaderOUT->ElapsedSeconds        = 0;
-	DHCPHeaderOUT->Flags                 = DHCPHeaderIN->Flags;
+	DHCPHeaderOUT->Flags                 = Flags;
 	DHCPHeaderOUT->YourIP                = ClientIPAddress;
-	memmove(&DHCPHeaderOUT->ClientHardwareAddress, &DHCPHeaderIN->ClientHardwareAddress, sizeof(MAC_Address_t));
+	memcpy(&DHCPHeaderOUT->ClientHardwareAddress, &ClientHardwareAddress, sizeof(MAC_Address_t));
 	DHCPHeaderOUT->Cookie                = SwapEndian_32(DHCP_MAGIC_COOKIE);
 	
 	/* Alter the incoming IP packet header so that the corrected IP source and destinations are used - this means that
@@ -79,42 +107,24 @@ int16_t DHCP_ProcessDHCPPacket(void* IPHeaderInStart,
 	IPHeaderIN->SourceAddress      = ClientIPAddress;
 	IPHeaderIN->DestinationAddress = ServerIPAddress;
 
-	/* Process the incoming DHCP packet options */
-	while (DHCPOptionsINStart[0] != DHCP_OPTION_END)
-	{	
-		/* Find the Message Type DHCP option, to determine the type of DHCP packet */
-		if (DHCPOptionsINStart[0] == DHCP_OPTION_MESSAGETYPE)
-		{
-			if ((DHCPOptionsINStart[2] == DHCP_MESSAGETYPE_DISCOVER) || (DHCPOptionsINStart[2] == DHCP_MESSAGETYPE_REQUEST))
-			{
-				/* Fill out the response DHCP packet options for a DHCP OFFER or ACK response */
-
-				*(DHCPOptionsOUTStart++) = DHCP_OPTION_MESSAGETYPE;
-				*(DHCPOptionsOUTStart++) = 1;
-				*(DHCPOptionsOUTStart++) = (DHCPOptionsINStart[2] == DHCP_MESSAGETYPE_DISCOVER) ? DHCP_MESSAGETYPE_OFFER
-																								: DHCP_MESSAGETYPE_ACK;
-
-				*(DHCPOptionsOUTStart++) = DHCP_OPTION_SUBNETMASK;
-				*(DHCPOptionsOUTStart++) = 4;
-				*(DHCPOptionsOUTStart++) = 0xFF;
-				*(DHCPOptionsOUTStart++) = 0xFF;
-				*(DHCPOptionsOUTStart++) = 0xFF;
-				*(DHCPOptionsOUTStart++) = 0x00;
-
-				*(DHCPOptionsOUTStart++) = DHCP_OPTION_DHCPSERVER;
-				*(DHCPOptionsOUTStart++) = sizeof(IP_Address_t);
-				memcpy(DHCPOptionsOUTStart, &ServerIPAddress, sizeof(IP_Address_t));
-				DHCPOptionsOUTStart     += sizeof(IP_Address_t);
-
-				*(DHCPOptionsOUTStart++) = DHCP_OPTION_END;
-				
-				return (sizeof(DHCP_Header_t) + 12 + sizeof(IP_Address_t));
-			}
-		}
-		
-		/* Go to the next DHCP option - skip one byte if option is a padding byte, else skip the complete option's size */
-		DHCPOptionsINStart += ((DHCPOptionsINStart[0] == DHCP_OPTION_PAD) ? 1 : (DHCPOptionsINStart[1] + 2));
-	}
+	/* Fill out the response DHCP packet options for a DHCP OFFER or ACK response */
+	*(DHCPOptionsOUTStart++) = DHCP_OPTION_MESSAGETYPE;
+	*(DHCPOptionsOUTStart++) = 1;
+	*(DHCPOptionsOUTStart++) = (MessageType == DHCP_MESSAGETYPE_DISCOVER) ? DHCP_MESSAGETYPE_OFFER : DHCP_MESSAGETYPE_ACK;
+
+	*(DHCPOptionsOUTStart++) = DHCP_OPTION_SUBNETMASK;
+	*(DHCPOptionsOUTStart++) = 4;
+	*(DHCPOptionsOUTStart++) = 0xFF;
+	*(DHCPOptionsOUTStart++) = 0xFF;
+	*(DHCPOptionsOUTStart++) = 0xFF;
+	*(DHCPOptionsOUTStart++) = 0x00;
+
+	*(DHCPOptionsOUTStart++) = DHCP_OPTION_DHCPSERVER;
+	*(DHCPOptionsOUTStart++) = sizeof(IP_Address_t);
+	memcpy(DHCPOptionsOUTStart, &ServerIPAddress, sizeof(IP_Address_t));
+	DHCPOptionsOUTStart     += sizeof(IP_Address_t);
+
+	*(DHCPOptionsOUTStart++) = DHCP_OPTION_END;
 	
-	return NO_RESPONSE;
+	return (sizeof(DHCP_Header_t) + 12 + sizeof(IP_Address_t));
 }
@@ -53,58 +53,65 @@ const IP_Address_t  BroadcastIPAddress  = {BROADCAST_IP_ADDRESS};
 const IP_Address_t  ClientIPAddress     = {CLIENT_IP_ADDRESS};
 
 
-/** Processes an incoming Ethernet frame, and writes the appropriate response to the output Ethernet
- *  frame buffer if the sub protocol handlers create a valid response.
+/** Processes an incoming Ethernet frame, and overwrites it with the appropriate response if the sub protocol handlers
+ *  create a valid response. Each protocol handler is given the same buffer for its incoming and outgoing packets, and
+ *  rewrites the headers in place so that packet payloads such as ICMP echo data never need to be copied. Responses are
+ *  sent to the host directly from the frame's receive buffer by the RNDIS class driver.
+ *
+ *  \param[in,out] Frame  Pointer to the received Ethernet frame to process
  */
-void Ethernet_ProcessPacket(Ethernet_Frame_Info_t* const FrameIN,
-                            Ethernet_Frame_Info_t* const FrameOUT)
+void Ethernet_ProcessPacket(Ethernet_Frame_Info_t* const Frame)
 {
-	DecodeEthernetFrameHeader(FrameIN);
+	DecodeEthernetFrameHeader(Frame);
 
-	/* Cast the incoming Ethernet frame to the Ethernet header type */
-	Ethernet_Frame_Header_t* FrameINHeader  = (Ethernet_Frame_Header_t*)&FrameIN->FrameData;
-	Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT->FrameData;
+	/* Cast the Ethernet frame to the Ethernet header type */
+	Ethernet_Frame_Header_t* FrameHeader = (Ethernet_Frame_Header_t*)&Frame->FrameData;
 	
-	int16_t                  RetSize        = NO_RESPONSE;
+	int16_t                  RetSize     = NO_RESPONSE;
 	
 	/* Ensure frame is addressed to either all (broadcast) or the virtual webserver, and is a type II frame */
-	if ((MAC_COMPARE(&FrameINHeader->Destination, &ServerMACAddress) ||
-	     MAC_COMPARE(&FrameINHeader->Destination, &BroadcastMACAddress)) &&
-		 (SwapEndian_16(FrameIN->FrameLength) > ETHERNET_VER2_MINSIZE))
+	if ((MAC_COMPARE(&FrameHeader->Destination, &ServerMACAddress) ||
+	     MAC_COMPARE(&FrameHeader->Destination, &BroadcastMACAddress)) &&
+		 (SwapEndian_16(Frame->FrameLength) > ETHERNET_VER2_MINSIZE))
 	{
 		/* Process the packet depending on its protocol */
-		switch (SwapEndian_16(FrameINHeader->EtherType))
+		switch (SwapEndian_16(FrameHeader->EtherType))
 		{
 			case ETHERTYPE_ARP:
-				RetSize = ARP_ProcessARPPacket(&FrameIN->FrameData[sizeof(Ethernet_Frame_Header_t)],
-				                               &FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t)]);
+				RetSize = ARP_ProcessARPPacket(&Frame->FrameData[sizeof(Ethernet_Frame_Header_t)],
+				                               &Frame->FrameData[sizeof(Ethernet_Frame_Header_t)]);
 				break;		
 			case ETHERTYPE_IPV4:
-				RetSize = IP_ProcessIPPacket(FrameIN,
-				                             &FrameIN->FrameData[sizeof(Ethernet_Frame_Header_t)],
-				                             &FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t)]);
+				/* Refresh the sender's ARP cache entry, so that the entries of active hosts do not expire */
+				ARP_UpdateCache(&((IP_Header_t*)&Frame->FrameData[sizeof(Ethernet_Frame_Header_t)])->SourceAddress,
+				                &FrameHeader->Source, false);
+
+				RetSize = IP_ProcessIPPacket(Frame,
+				                             &Frame->FrameData[sizeof(Ethernet_Frame_Header_t)],
+				                             &Frame->FrameData[sizeof(Ethernet_Frame_Header_t)]);
 				break;
 		}
 		
 		/* Protocol processing routine has filled a response, complete the ethernet frame header */
 		if (RetSize > 0)
 		{
-			/* Fill out the response Ethernet frame header */
-			FrameOUTHeader->Source          = ServerMACAddress;
-			FrameOUTHeader->Destination     = FrameINHeader->Source;
-			FrameOUTHeader->EtherType       = FrameINHeader->EtherType;
+			/* Fill out the response Ethernet frame header - the sender becomes the destination, so must be copied first */
+			FrameHeader->Destination = FrameHeader->Source;
+			FrameHeader->Source      = ServerMACAddress;
 			
-			/* Set the response length in the buffer and indicate that a response is ready to be sent */
-			FrameOUT->FrameLength           = (sizeof(Ethernet_Frame_Header_t) + RetSize);
-			FrameOUT->FrameInBuffer         = true;
+			/* Set the response length in the buffer and indicate that the response is ready to be sent in place */
+			Frame->FrameLength       = (sizeof(Ethernet_Frame_Header_t) + RetSize);
+			Frame->FrameSendInPlace  = true;
+
+			PROTOCOL_TRACE(PROTOCOL_TRACE_TX, true, Frame->FrameLength, SwapEndian_16(FrameHeader->EtherType));
 		}
 	}
 
 	/* Check if the packet was processed */
 	if (RetSize != NO_PROCESS)
 	{
-		/* Clear the frame buffer */
-		FrameIN->FrameInBuffer = false;
+		/* Release the frame buffer, once any response has been sent */
+		Frame->FrameInBuffer = false;
 	}
 }
 
@@ -119,14 +126,125 @@ void Ethernet_ProcessPacket(Ethernet_Frame_Info_t* const FrameIN,
 uint16_t Ethernet_Checksum16(void* Data,
                              uint16_t Bytes)
 {
-	uint16_t* Words    = (uint16_t*)Data;
-	uint32_t  Checksum = 0;
+	return Ethernet_ChecksumFold16(Ethernet_ChecksumPartial(Data, Bytes, 0));
+}
+
+/** Adds the words of the given buffer to a partial Ethernet checksum, without folding the carries back into the
+ *  lower 16 bits. Partial checksums of consecutive buffers may be chained together, as long as all but the last
+ *  buffer are an even number of bytes in length, and converted to the final checksum via \ref Ethernet_ChecksumFold16().
+ *
+ *  \param[in] Data      Pointer to the buffer data to add to the checksum
+ *  \param[in] Bytes     Number of bytes in the data buffer to process
+ *  \param[in] Checksum  Partial checksum to add the buffer's words to, or zero to start a new checksum
+ *
+ *  \return Updated partial checksum value
+ */
+uint32_t Ethernet_ChecksumPartial(const void* Data,
+                                  uint16_t Bytes,
+                                  uint32_t Checksum)
+{
+	const uint16_t* Words = (const uint16_t*)Data;
+
+	/* Sum four words per iteration to reduce loop overhead - carries are folded once at the end instead of per word */
+	for (uint16_t WordBlocks = (Bytes >> 3); WordBlocks; WordBlocks--)
+	{
+		Checksum += Words[0];
+		Checksum += Words[1];
+		Checksum += Words[2];
+		Checksum += Words[3];
+		
+		Words += 4;
+	}
+	
+	for (uint8_t WordsRem = ((Bytes >> 1) & 0x03); WordsRem; WordsRem--)
+	  Checksum += *(Words++);
+
+	/* A trailing odd byte is treated as the upper byte of a zero-padded network order word */
+	if (Bytes & 0x01)
+	  Checksum += *((const uint8_t*)Words);
+
+	return Checksum;
+}
+
+/** Copies the given buffer into a destination buffer, adding the copied words to a partial Ethernet checksum at
+ *  the same time. This allows the checksum of a packet's payload to be calculated as it is copied into the frame,
+ *  rather than in a second pass over the frame data.
+ *
+ *  \param[out] Destination  Pointer to the destination buffer to copy the data to
+ *  \param[in]  Source       Pointer to the source buffer to copy the data from
+ *  \param[in]  Bytes        Number of bytes to copy
+ *  \param[in]  Checksum     Partial checksum to add the buffer's words to, or zero to start a new checksum
+ *
+ *  \return Updated partial checksum value
+ */
+uint32_t Ethernet_ChecksumCopy(void* Destination,
+                               const void* Source,
+                               uint16_t Bytes,
+                               uint32_t Checksum)
+{
+	uint16_t*       DestWords   = (uint16_t*)Destination;
+	const uint16_t* SourceWords = (const uint16_t*)Source;
+
+	for (uint16_t WordBlocks = (Bytes >> 3); WordBlocks; WordBlocks--)
+	{
+		uint16_t Word;
+		
+		Word = SourceWords[0]; DestWords[0] = Word; Checksum += Word;
+		Word = SourceWords[1]; DestWords[1] = Word; Checksum += Word;
+		Word = SourceWords[2]; DestWords[2] = Word; Checksum += Word;
+		Word = SourceWords[3]; DestWords[3] = Word; Checksum += Word;
+
+		SourceWords += 4;
+		DestWords   += 4;
+	}
+	
+	for (uint8_t WordsRem = ((Bytes >> 1) & 0x03); WordsRem; WordsRem--)
+	{
+		uint16_t Word = *(SourceWords++);
+
+		*(DestWords++) = Word;
+		Checksum      += Word;
+	}
+
+	if (Bytes & 0x01)
+	{
+		uint8_t Byte = *((const uint8_t*)SourceWords);
+
+		*((uint8_t*)DestWords) = Byte;
+		Checksum += Byte;
+	}
+
+	return Checksum;
+}
 
-	for (uint16_t CurrWord = 0; CurrWord < (Bytes >> 1); CurrWord++)
-	  Checksum += Words[CurrWord];
-	  
+/** Folds the carries of a partial Ethernet checksum back into its lower 16 bits, and compliments the result to
+ *  give the final checksum value.
+ *
+ *  \param[in] Checksum  Partial checksum value to complete
+ *
+ *  \return A 16-bit Ethernet checksum value
+ */
+uint16_t Ethernet_ChecksumFold16(uint32_t Checksum)
+{
 	while (Checksum & 0xFFFF0000)
 	  Checksum = ((Checksum & 0xFFFF) + (Checksum >> 16));
 	
 	return ~Checksum;
 }
+
+/** Incrementally updates an existing Ethernet checksum to reflect a change of a single word within the checksummed
+ *  data, as described in RFC1624. This avoids a full recalculation when only a header field has been modified.
+ *
+ *  \param[in] Checksum  Existing checksum value of the data
+ *  \param[in] OldWord   Previous value of the modified word, as stored in the data
+ *  \param[in] NewWord   New value of the modified word, as stored in the data
+ *
+ *  \return Updated 16-bit Ethernet checksum value
+ */
+uint16_t Ethernet_ChecksumAdjust16(const uint16_t Checksum,
+                                   const uint16_t OldWord,
+                                   const uint16_t NewWord)
+{
+	/* RFC1624 Eqn. 3 - HC' = ~(~HC + ~m + m') */
+	return Ethernet_ChecksumFold16((uint32_t)(uint16_t)~Checksum + (uint16_t)~OldWord + NewWord);
+}
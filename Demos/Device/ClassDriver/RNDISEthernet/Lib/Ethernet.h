@@ -96,9 +96,19 @@
 		extern const IP_Address_t  ClientIPAddress;
 		
 	/* Function Prototypes: */
-		void     Ethernet_ProcessPacket(Ethernet_Frame_Info_t* const FrameIN,
-		                                Ethernet_Frame_Info_t* const FrameOUT);
+		void     Ethernet_ProcessPacket(Ethernet_Frame_Info_t* const Frame);
 		uint16_t Ethernet_Checksum16(void* Data,
 		                             uint16_t Bytes);
+		uint32_t Ethernet_ChecksumPartial(const void* Data,
+		                                  uint16_t Bytes,
+		                                  uint32_t Checksum);
+		uint32_t Ethernet_ChecksumCopy(void* Destination,
+		                               const void* Source,
+		                               uint16_t Bytes,
+		                               uint32_t Checksum);
+		uint16_t Ethernet_ChecksumFold16(uint32_t Checksum);
+		uint16_t Ethernet_ChecksumAdjust16(const uint16_t Checksum,
+		                                   const uint16_t OldWord,
+		                                   const uint16_t NewWord);
 		
 #endif
@@ -58,21 +58,30 @@ int16_t ICMP_ProcessICMPPacket(Ethernet_Frame_Info_t* const FrameIN,
 	/* Determine if the ICMP packet is an echo request (ping) */
 	if (ICMPHeaderIN->Type == ICMP_TYPE_ECHOREQUEST)
 	{
+		/* Save the request's type/code word and checksum, so that the reply checksum can be derived from them */
+		uint16_t RequestTypeCode = *((uint16_t*)&ICMPHeaderIN->Type);
+		uint16_t RequestChecksum = ICMPHeaderIN->Checksum;
+
 		/* Fill out the ICMP response packet */
 		ICMPHeaderOUT->Type     = ICMP_TYPE_ECHOREPLY;
 		ICMPHeaderOUT->Code     = 0;
-		ICMPHeaderOUT->Checksum = 0;
 		ICMPHeaderOUT->Id       = ICMPHeaderIN->Id;
 		ICMPHeaderOUT->Sequence = ICMPHeaderIN->Sequence;
 		
 		intptr_t DataSize = FrameIN->FrameLength - ((((intptr_t)InDataStart + sizeof(ICMP_Header_t)) - (intptr_t)FrameIN->FrameData));
 		
-		/* Copy the remaining payload to the response - echo requests should echo back any sent data */
-		memmove(&((uint8_t*)OutDataStart)[sizeof(ICMP_Header_t)],
-		        &((uint8_t*)InDataStart)[sizeof(ICMP_Header_t)],
-			    DataSize);
+		/* Copy the remaining payload to the response - echo requests should echo back any sent data, which is already
+		   in place when the reply is built over the request */
+		if (OutDataStart != InDataStart)
+		{
+			memmove(&((uint8_t*)OutDataStart)[sizeof(ICMP_Header_t)],
+			        &((uint8_t*)InDataStart)[sizeof(ICMP_Header_t)],
+			        DataSize);
+		}
 
-		ICMPHeaderOUT->Checksum = Ethernet_Checksum16(ICMPHeaderOUT, (DataSize + sizeof(ICMP_Header_t)));
+		/* Only the type and code differ from the echoed request, so update the request checksum rather than re-summing the payload */
+		ICMPHeaderOUT->Checksum = Ethernet_ChecksumAdjust16(RequestChecksum, RequestTypeCode,
+		                                                    *((uint16_t*)&ICMPHeaderOUT->Type));
 
 		/* Return the size of the response so far */
 		return (DataSize + sizeof(ICMP_Header_t));
@@ -67,7 +67,31 @@ int16_t IP_ProcessIPPacket(Ethernet_Frame_Info_t* const FrameIN,
 	{
 		return NO_RESPONSE;
 	}
+
+	/* Discard malformed packets whose header or total length do not fit within the received frame, so that the sub-protocol
+	   handlers can trust the lengths in the IP header */
+	if ((HeaderLengthBytes < sizeof(IP_Header_t)) || (SwapEndian_16(IPHeaderIN->TotalLength) < HeaderLengthBytes) ||
+	    (SwapEndian_16(IPHeaderIN->TotalLength) > (FrameIN->FrameLength - sizeof(Ethernet_Frame_Header_t))))
+	{
+		return NO_RESPONSE;
+	}
 	
+	/* Strip any IP options when responding in place, moving the payload up against the fixed length header so that the
+	   sub-protocol handlers read and write their headers at the same location */
+	if ((InDataStart == OutDataStart) && (HeaderLengthBytes != sizeof(IP_Header_t)))
+	{
+		uint16_t OptionsLength = (HeaderLengthBytes - sizeof(IP_Header_t));
+		uint16_t PayloadLength = (SwapEndian_16(IPHeaderIN->TotalLength) - HeaderLengthBytes);
+		
+		memmove(&((uint8_t*)InDataStart)[sizeof(IP_Header_t)], &((uint8_t*)InDataStart)[HeaderLengthBytes], PayloadLength);
+
+		IPHeaderIN->HeaderLength = (sizeof(IP_Header_t) / sizeof(uint32_t));
+		IPHeaderIN->TotalLength  = SwapEndian_16(sizeof(IP_Header_t) + PayloadLength);
+		FrameIN->FrameLength    -= OptionsLength;
+
+		HeaderLengthBytes        = sizeof(IP_Header_t);
+	}
+
 	/* Pass off the IP payload to the appropriate protocol processing routine */
 	switch (IPHeaderIN->Protocol)
 	{
@@ -91,6 +115,10 @@ int16_t IP_ProcessIPPacket(Ethernet_Frame_Info_t* const FrameIN,
 	/* Check to see if the protocol processing routine has filled out a response */
 	if (RetSize > 0)
 	{
+		/* Save the incoming addresses before they are swapped, as the response header may overwrite the incoming header */
+		IP_Address_t SourceAddress      = IPHeaderIN->SourceAddress;
+		IP_Address_t DestinationAddress = IPHeaderIN->DestinationAddress;
+
 		/* Fill out the response IP packet header */
 		IPHeaderOUT->TotalLength        = SwapEndian_16(sizeof(IP_Header_t) + RetSize);
 		IPHeaderOUT->TypeOfService      = 0;
@@ -102,8 +130,8 @@ int16_t IP_ProcessIPPacket(Ethernet_Frame_Info_t* const FrameIN,
 		IPHeaderOUT->HeaderChecksum     = 0;
 		IPHeaderOUT->Protocol           = IPHeaderIN->Protocol;
 		IPHeaderOUT->TTL                = DEFAULT_TTL;
-		IPHeaderOUT->SourceAddress      = IPHeaderIN->DestinationAddress;
-		IPHeaderOUT->DestinationAddress = IPHeaderIN->SourceAddress;
+		IPHeaderOUT->SourceAddress      = DestinationAddress;
+		IPHeaderOUT->DestinationAddress = SourceAddress;
 		
 		IPHeaderOUT->HeaderChecksum     = Ethernet_Checksum16(IPHeaderOUT, sizeof(IP_Header_t));
 						
@@ -34,6 +34,9 @@
    
    To disable printing of a specific protocol, define the token NO_DECODE_{Protocol}
    in the project makefile, and pass it to the compiler using the -D switch.
+   
+   Each routine also adds a compact binary record of the packet to the protocol trace
+   when ENABLE_PROTOCOL_TRACE is defined, see ProtocolTrace.c.
 */
 
 /** \file
@@ -55,6 +58,9 @@
  */
 void DecodeEthernetFrameHeader(Ethernet_Frame_Info_t* const FrameINData)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_ETHERNET, 0, FrameINData->FrameLength,
+	               SwapEndian_16(((Ethernet_Frame_Header_t*)FrameINData->FrameData)->EtherType));
+
 	#if !defined(NO_DECODE_ETHERNET)
 	Ethernet_Frame_Header_t* FrameHeader = (Ethernet_Frame_Header_t*)FrameINData->FrameData;
 	
@@ -97,6 +103,9 @@ void DecodeEthernetFrameHeader(Ethernet_Frame_Info_t* const FrameINData)
  */
 void DecodeARPHeader(void* InDataStart)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_ARP, SwapEndian_16(((ARP_Header_t*)InDataStart)->Operation), 0,
+	               SwapEndian_16(((ARP_Header_t*)InDataStart)->ProtocolType));
+
 	#if !defined(NO_DECODE_ARP)
 	ARP_Header_t* ARPHeader = (ARP_Header_t*)InDataStart;	
 
@@ -147,6 +156,9 @@ void DecodeARPHeader(void* InDataStart)
  */
 void DecodeIPHeader(void* InDataStart)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_IP, ((IP_Header_t*)InDataStart)->Protocol, SwapEndian_16(((IP_Header_t*)InDataStart)->TotalLength),
+	               ((IP_Header_t*)InDataStart)->TTL);
+
 	#if !defined(NO_DECODE_IP)
 	IP_Header_t* IPHeader  = (IP_Header_t*)InDataStart;
 
@@ -185,6 +197,8 @@ void DecodeIPHeader(void* InDataStart)
  */
 void DecodeICMPHeader(void* InDataStart)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_ICMP, ((ICMP_Header_t*)InDataStart)->Type, 0, ((ICMP_Header_t*)InDataStart)->Code);
+
 	#if !defined(NO_DECODE_ICMP)
 	ICMP_Header_t* ICMPHeader  = (ICMP_Header_t*)InDataStart;
 
@@ -201,6 +215,9 @@ void DecodeICMPHeader(void* InDataStart)
  */
 void DecodeTCPHeader(void* InDataStart)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_TCP, ((TCP_Header_t*)InDataStart)->Flags, (((TCP_Header_t*)InDataStart)->DataOffset * sizeof(uint32_t)),
+	               SwapEndian_16(((TCP_Header_t*)InDataStart)->DestinationPort));
+
 	#if !defined(NO_DECODE_TCP)
 	TCP_Header_t* TCPHeader  = (TCP_Header_t*)InDataStart;
 
@@ -229,6 +246,9 @@ void DecodeTCPHeader(void* InDataStart)
  */
 void DecodeUDPHeader(void* InDataStart)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_UDP, 0, SwapEndian_16(((UDP_Header_t*)InDataStart)->Length),
+	               SwapEndian_16(((UDP_Header_t*)InDataStart)->DestinationPort));
+
 	#if !defined(NO_DECODE_UDP)
 	UDP_Header_t* UDPHeader = (UDP_Header_t*)InDataStart;
 
@@ -247,6 +267,8 @@ void DecodeUDPHeader(void* InDataStart)
  */
 void DecodeDHCPHeader(void* InDataStart)
 {
+	PROTOCOL_TRACE(PROTOCOL_TRACE_DHCP, ((DHCP_Header_t*)InDataStart)->Operation, 0, 0);
+
 	#if !defined(NO_DECODE_DHCP)
 	uint8_t* DHCPOptions = (InDataStart + sizeof(DHCP_Header_t));
 
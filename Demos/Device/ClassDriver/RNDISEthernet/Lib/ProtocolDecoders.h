@@ -46,6 +46,7 @@
 		
 		#include "EthernetProtocols.h"
 		#include "Ethernet.h"
+		#include "ProtocolTrace.h"
 		
 	/* Function Prototypes: */
 		void DecodeEthernetFrameHeader(Ethernet_Frame_Info_t* const FrameINData);
@@ -0,0 +1,165 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Binary protocol tracing routines, for the profiling of packet processing. Unlike the text protocol decoders, which
+ *  block packet processing while each header is printed through the USART, the trace routines store a compact fixed
+ *  size record for each packet in a RAM buffer, which is sent through the USART a byte at a time from the main loop
+ *  whenever the USART is ready to accept more data. Each record is timestamped from the tick timer, so that the host
+ *  can determine the time taken to process each packet without the tracing itself changing that time.
+ *
+ *  Tracing is enabled by defining ENABLE_PROTOCOL_TRACE in the project makefile and passing it to the compiler via
+ *  the -D switch; when not defined, all tracing code is removed from the firmware.
+ */
+
+#include "ProtocolTrace.h"
+
+#if defined(ENABLE_PROTOCOL_TRACE)
+
+/** Number of tick timer periods which have elapsed since the trace was started, advanced by \ref PROTOCOL_TRACE_TICK(). */
+uint16_t ProtocolTrace_Ticks;
+
+/** Circular buffer of trace records waiting to be sent through the USART. */
+static ProtocolTrace_Record_t TraceBuffer[PROTOCOL_TRACE_RECORDS];
+
+/** Free running index of the next record to be written into the trace buffer. */
+static uint8_t TraceBufferHead;
+
+/** Free running index of the next record to be sent from the trace buffer. */
+static uint8_t TraceBufferTail;
+
+/** Index of the next byte of the current record to send through the USART, including the sync and checksum bytes. */
+static uint8_t TraceByteIndex;
+
+/** XOR of the bytes of the current record sent so far. */
+static uint8_t TraceChecksum;
+
+/** Number of records discarded since the last \ref PROTOCOL_TRACE_DROPPED record was added, due to a full buffer. */
+static uint16_t TraceDroppedRecords;
+
+/** Initializes the protocol trace, reconfiguring the USART to the trace baud rate. This should be called after the
+ *  USART has been initialized.
+ */
+void ProtocolTrace_Init(void)
+{
+	Serial_Init(PROTOCOL_TRACE_BAUDRATE, true);
+}
+
+/** Adds a new record to the trace buffer. This should be called via the \ref PROTOCOL_TRACE() macro rather than directly,
+ *  so that the call is removed when tracing is disabled.
+ *
+ *  \param[in] Protocol  Protocol of the traced packet, a value from the \ref ProtocolTrace_Protocols_t enum
+ *  \param[in] Info      Protocol specific 8-bit information value
+ *  \param[in] Length    Protocol specific 16-bit length value
+ *  \param[in] Value     Protocol specific 16-bit value
+ */
+void ProtocolTrace_Record(const uint8_t Protocol,
+                          const uint8_t Info,
+                          const uint16_t Length,
+                          const uint16_t Value)
+{
+	uint8_t FreeRecords = (PROTOCOL_TRACE_RECORDS - (uint8_t)(TraceBufferHead - TraceBufferTail));
+
+	/* Report any lost records before the new record, so that the host knows where the gap in the trace lies */
+	if (TraceDroppedRecords && (FreeRecords >= 2))
+	{
+		uint16_t DroppedRecords = TraceDroppedRecords;
+
+		TraceDroppedRecords = 0;
+		ProtocolTrace_Record(PROTOCOL_TRACE_DROPPED, 0, 0, DroppedRecords);
+		FreeRecords--;
+	}
+
+	if (!(FreeRecords) || TraceDroppedRecords)
+	{
+		if (TraceDroppedRecords != 0xFFFF)
+		  TraceDroppedRecords++;
+
+		return;
+	}
+
+	ProtocolTrace_Record_t* TraceRecord = &TraceBuffer[TraceBufferHead & (PROTOCOL_TRACE_RECORDS - 1)];
+
+	/* If the tick timer has wrapped since the tick count was last advanced, the count is one period behind the timer */
+	TraceRecord->Ticks    = ProtocolTrace_Ticks;
+	TraceRecord->SubTicks = TCNT1;
+
+	if (TIFR1 & (1 << OCF1A))
+	{
+		TraceRecord->Ticks++;
+		TraceRecord->SubTicks = TCNT1;
+	}
+
+	TraceRecord->Protocol = Protocol;
+	TraceRecord->Info     = Info;
+	TraceRecord->Length   = Length;
+	TraceRecord->Value    = Value;
+	
+	TraceBufferHead++;
+}
+
+/** Sends buffered trace records through the USART, without waiting for the USART to become ready. This should be called
+ *  continuously from the main program loop.
+ */
+void ProtocolTrace_Task(void)
+{
+	while (UCSR1A & (1 << UDRE1))
+	{
+		if (!(TraceByteIndex))
+		{
+			/* Abort if there are no buffered records to send */
+			if (TraceBufferHead == TraceBufferTail)
+			  return;
+
+			UDR1          = PROTOCOL_TRACE_SYNC_BYTE;
+			TraceChecksum = 0;
+			TraceByteIndex++;
+		}
+		else if (TraceByteIndex <= sizeof(ProtocolTrace_Record_t))
+		{
+			uint8_t* TraceRecord = (uint8_t*)&TraceBuffer[TraceBufferTail & (PROTOCOL_TRACE_RECORDS - 1)];
+			uint8_t  TraceByte   = TraceRecord[TraceByteIndex - 1];
+
+			UDR1           = TraceByte;
+			TraceChecksum ^= TraceByte;
+			TraceByteIndex++;
+		}
+		else
+		{
+			/* Record complete, send the checksum and release the record's space in the buffer */
+			UDR1           = TraceChecksum;
+			TraceByteIndex = 0;
+			TraceBufferTail++;
+		}
+	}
+}
+
+#endif
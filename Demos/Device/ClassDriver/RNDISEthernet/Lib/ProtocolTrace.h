@@ -0,0 +1,142 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for ProtocolTrace.c.
+ */
+
+#ifndef _PROTOCOL_TRACE_H_
+#define _PROTOCOL_TRACE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdint.h>
+		#include <stdbool.h>
+		
+		#include <LUFA/Drivers/Peripheral/Serial.h>
+
+	/* Preprocessor Checks: */
+		#if defined(ENABLE_PROTOCOL_TRACE) && (!defined(NO_DECODE_ETHERNET) || !defined(NO_DECODE_ARP)  || \
+		                                       !defined(NO_DECODE_IP)       || !defined(NO_DECODE_ICMP) || \
+		                                       !defined(NO_DECODE_TCP)      || !defined(NO_DECODE_UDP)  || \
+		                                       !defined(NO_DECODE_DHCP))
+			#error The text protocol decoders must all be disabled when ENABLE_PROTOCOL_TRACE is defined, as both use the USART.
+		#endif
+
+	/* Macros: */
+		#if !defined(PROTOCOL_TRACE_RECORDS) || defined(__DOXYGEN__)
+			/** Number of trace records which can be buffered while waiting to be sent through the USART. This must be
+			 *  a power of two no larger than 128.
+			 */
+			#define PROTOCOL_TRACE_RECORDS      16
+		#endif
+		
+		#if !defined(PROTOCOL_TRACE_BAUDRATE) || defined(__DOXYGEN__)
+			/** Baud rate of the USART while tracing is enabled, in bits per second. The USART is run in double speed
+			 *  mode to reduce the baud rate error at the higher speeds required to keep up with the network traffic.
+			 */
+			#define PROTOCOL_TRACE_BAUDRATE     38400
+		#endif
+
+		/** Synchronization byte which precedes each trace record sent through the USART. */
+		#define PROTOCOL_TRACE_SYNC_BYTE    0xA5
+		
+		#if defined(ENABLE_PROTOCOL_TRACE) || defined(__DOXYGEN__)
+			/** Adds a new record to the trace buffer, to be sent through the USART by \ref ProtocolTrace_Task(). If the trace
+			 *  buffer is full the record is discarded, and a \ref PROTOCOL_TRACE_DROPPED record is added once space is
+			 *  available again. When ENABLE_PROTOCOL_TRACE is not defined in the project makefile, this macro expands to
+			 *  nothing so that tracing adds no code or processing time to the firmware.
+			 *
+			 *  \param[in] Protocol  Protocol of the traced packet, a value from the \ref ProtocolTrace_Protocols_t enum
+			 *  \param[in] Info      Protocol specific 8-bit information value, such as a type or flags field
+			 *  \param[in] Length    Protocol specific 16-bit length value
+			 *  \param[in] Value     Protocol specific 16-bit value, such as a port number
+			 */
+			#define PROTOCOL_TRACE(Protocol, Info, Length, Value)   ProtocolTrace_Record(Protocol, Info, Length, Value)
+			
+			/** Advances the trace timestamp by one tick timer period. This must be called each time the main loop handles
+			 *  a Timer 1 compare match. When ENABLE_PROTOCOL_TRACE is not defined in the project makefile, this macro
+			 *  expands to nothing.
+			 */
+			#define PROTOCOL_TRACE_TICK()                          MACROS{ ProtocolTrace_Ticks++; }MACROE
+		#else
+			#define PROTOCOL_TRACE(Protocol, Info, Length, Value)   MACROS{ }MACROE
+			#define PROTOCOL_TRACE_TICK()                          MACROS{ }MACROE
+		#endif
+
+	/* Enums: */
+		/** Enum for the packet types which may be recorded in the protocol trace. The values of the record's protocol
+		 *  specific fields for each type are given in the description of each value.
+		 */
+		enum ProtocolTrace_Protocols_t
+		{
+			PROTOCOL_TRACE_ETHERNET = 0, /**< Ethernet frame received; Length is the frame length and Value the EtherType */
+			PROTOCOL_TRACE_ARP      = 1, /**< ARP packet received; Info is the operation and Value the protocol type */
+			PROTOCOL_TRACE_IP       = 2, /**< IP packet received; Info is the protocol, Length the total length and Value the TTL */
+			PROTOCOL_TRACE_ICMP     = 3, /**< ICMP packet received; Info is the type and Value the code */
+			PROTOCOL_TRACE_TCP      = 4, /**< TCP segment received; Info is the flags, Length the header length and Value the
+			                              *   destination port
+			                              */
+			PROTOCOL_TRACE_UDP      = 5, /**< UDP datagram received; Length is the datagram length and Value the destination port */
+			PROTOCOL_TRACE_DHCP     = 6, /**< DHCP packet received; Info is the BOOTP operation */
+			PROTOCOL_TRACE_TX       = 7, /**< Ethernet frame queued for transmission; Info is non-zero if the frame was sent in
+			                              *   place over the received frame, Length is the frame length and Value the EtherType
+			                              */
+			PROTOCOL_TRACE_DROPPED  = 8, /**< Records were lost due to a full trace buffer; Value is the number of lost records */
+		};
+
+	/* Type Defines: */
+		/** Type define for a single protocol trace record, as stored in the trace buffer and sent (in little endian byte
+		 *  order) through the USART. Each record is sent preceded by \ref PROTOCOL_TRACE_SYNC_BYTE and followed by the
+		 *  XOR of all the record's bytes, so that the host can locate the record boundaries in the serial stream.
+		 */
+		typedef struct
+		{
+			uint16_t Ticks; /**< Number of tick timer periods elapsed when the record was made */
+			uint8_t  SubTicks; /**< Value of the tick timer when the record was made, in units of 1024 CPU clock cycles */
+			uint8_t  Protocol; /**< Traced packet type, a value from the \ref ProtocolTrace_Protocols_t enum */
+			uint8_t  Info; /**< Protocol specific 8-bit information value */
+			uint16_t Length; /**< Protocol specific 16-bit length value */
+			uint16_t Value; /**< Protocol specific 16-bit value */
+		} ProtocolTrace_Record_t;
+
+	/* External Variables: */
+		extern uint16_t ProtocolTrace_Ticks;
+
+	/* Function Prototypes: */
+		void ProtocolTrace_Init(void);
+		void ProtocolTrace_Record(const uint8_t Protocol,
+		                          const uint8_t Info,
+		                          const uint16_t Length,
+		                          const uint16_t Value);
+		void ProtocolTrace_Task(void);
+
+#endif
@@ -0,0 +1,174 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Simple read-only filesystem image for the webserver application. The contents and lengths of each file are fixed
+ *  at compile time and stored in PROGMEM, along with a lookup table mapping each file's path to its data, so that
+ *  files can be located and streamed out in blocks without rescanning the data to find its length.
+ */
+
+#include "ROMFileSystem.h"
+
+/** Default webserver page, served when the root path of the webserver is requested by the host. */
+char PROGMEM IndexFile[] = 
+		"<html>"
+		"	<head>"
+		"		<title>"
+		"			LUFA Webserver Demo"
+		"		</title>"
+		"		<link rel=\"stylesheet\" type=\"text/css\" href=\"/style.css\" />"
+		"	</head>"
+		"	<body>"
+		"		<h1>Hello from your USB AVR!</h1>"
+		"		<p>"
+		"			Hello! Welcome to the LUFA RNDIS Demo Webserver test page, running on your USB AVR via the LUFA library. This demonstrates the HTTP webserver, TCP/IP stack and RNDIS demo all running atop the LUFA USB stack."
+		"			<br /><br />"
+		"			<small>Project Information: <a href=\"http://www.fourwalledcubicle.com/LUFA.php\">http://www.fourwalledcubicle.com/LUFA.php</a>.</small>"
+		"			<br />"
+		"			<small>Stack Information: <a href=\"/info.txt\">/info.txt</a>.</small>"
+		"			<hr />"
+		"			<i>LUFA Version: </i>" LUFA_VERSION_STRING
+		"		</p>"
+		"	</body>"
+		"</html>";
+
+/** Stylesheet for the default webserver page. */
+char PROGMEM StyleFile[] =
+		"body { font-family: sans-serif; margin: 2em; }\r\n"
+		"h1 { color: #336699; }\r\n"
+		"small { color: #666666; }\r\n";
+
+/** Plain text information page, describing the services offered by the device. */
+char PROGMEM InfoFile[] =
+		"LUFA RNDIS Demo\r\n"
+		"\r\n"
+		"Services: HTTP (TCP port 80), DHCP server (UDP port 67), ICMP echo\r\n"
+		"Device Address: 10.0.0.2\r\n"
+		"LUFA Version: " LUFA_VERSION_STRING "\r\n";
+
+/** Lookup table of the files in the filesystem image, mapping each file path to its content type, data and length. The
+ *  lengths of each file's path, type and data are taken from the sizes of their string literals and arrays less the string null
+ *  terminators, so that they never need to be rescanned at run time. Several paths may share
+ *  the same file data, such as the root path which serves the default webserver page.
+ */
+ROMFS_File_t PROGMEM FileTable[] =
+	{
+		ROMFS_FILE("/",           "text/html",  IndexFile),
+		ROMFS_FILE("/index.html", "text/html",  IndexFile),
+		ROMFS_FILE("/style.css",  "text/css",   StyleFile),
+		ROMFS_FILE("/info.txt",   "text/plain", InfoFile),
+	};
+
+
+/** Searches the filesystem image's lookup table for a file with the given path.
+ *
+ *  \param[in] Path        Path of the file to locate, which need not be null terminated
+ *  \param[in] PathLength  Length of the path in bytes
+ *
+ *  \return Index of the located file in the filesystem image, or ROMFS_NO_FILE if no file with the given path exists
+ */
+uint8_t ROMFS_FindFile(const char* Path,
+                       const uint8_t PathLength)
+{
+	for (uint8_t FileIndex = 0; FileIndex < (sizeof(FileTable) / sizeof(FileTable[0])); FileIndex++)
+	{
+		/* Compare the precomputed path lengths first, so that only paths of the same length need to be compared */
+		if ((pgm_read_byte(&FileTable[FileIndex].PathLength) == PathLength) &&
+		    (memcmp_P(Path, FileTable[FileIndex].Path, PathLength) == 0))
+		{
+			return FileIndex;
+		}
+	}
+	
+	return ROMFS_NO_FILE;
+}
+
+/** Retrieves the length of a file in the filesystem image.
+ *
+ *  \param[in] FileIndex  Index of the file, as returned by \ref ROMFS_FindFile()
+ *
+ *  \return Length of the file data in bytes
+ */
+uint16_t ROMFS_GetFileLength(const uint8_t FileIndex)
+{
+	return pgm_read_word(&FileTable[FileIndex].Length);
+}
+
+/** Copies the content type of a file in the filesystem image into the given buffer. The copied content type is not null
+ *  terminated.
+ *
+ *  \param[in] FileIndex  Index of the file, as returned by \ref ROMFS_FindFile()
+ *  \param[out] Buffer    Buffer to store the content type string into, at least \ref ROMFS_MAX_TYPE_LENGTH bytes long
+ *
+ *  \return Length of the copied content type string
+ */
+uint8_t ROMFS_CopyContentType(const uint8_t FileIndex,
+                              char* Buffer)
+{
+	uint8_t Length = pgm_read_byte(&FileTable[FileIndex].ContentTypeLength);
+
+	memcpy_P(Buffer, FileTable[FileIndex].ContentType, Length);
+	
+	return Length;
+}
+
+/** Reads a block of data from a file in the filesystem image into the given buffer.
+ *
+ *  \param[in] FileIndex  Index of the file, as returned by \ref ROMFS_FindFile()
+ *  \param[in] Offset     Offset in bytes from the start of the file to read from
+ *  \param[out] Buffer    Buffer to store the read file data into
+ *  \param[in] MaxLength  Maximum number of bytes to read into the buffer
+ *
+ *  \return Number of bytes read, which is less than MaxLength only when the end of the file has been reached
+ */
+uint16_t ROMFS_ReadFile(const uint8_t FileIndex,
+                        const uint16_t Offset,
+                        uint8_t* Buffer,
+                        const uint16_t MaxLength)
+{
+	uint16_t    FileLength = pgm_read_word(&FileTable[FileIndex].Length);
+	const char* FileData   = pgm_read_ptr(&FileTable[FileIndex].Data);
+	uint16_t    Length;
+	
+	/* Nothing left to read once the end of the file has been reached */
+	if (Offset >= FileLength)
+	  return 0;
+
+	/* Limit the block to the remainder of the file, which is known without scanning the file data */
+	Length = (FileLength - Offset);
+	
+	if (Length > MaxLength)
+	  Length = MaxLength;
+	
+	memcpy_P(Buffer, &FileData[Offset], Length);
+	
+	return Length;
+}
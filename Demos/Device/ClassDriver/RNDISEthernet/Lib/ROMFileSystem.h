@@ -0,0 +1,92 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+/** \file
+ *
+ *  Header file for ROMFileSystem.c.
+ */
+ 
+#ifndef _ROM_FILESYSTEM_H_
+#define _ROM_FILESYSTEM_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <string.h>
+		
+		#include <LUFA/Version.h>
+		#include <LUFA/Common/Common.h>
+		
+	/* Macros: */
+		/** Maximum length of a file path in the filesystem image, including the null terminator. */
+		#define ROMFS_MAX_PATH_LENGTH       16
+
+		/** Maximum length of a file content type in the filesystem image, including the null terminator. */
+		#define ROMFS_MAX_TYPE_LENGTH       12
+		
+		/** File index value indicating that no file with a given path exists in the filesystem image. */
+		#define ROMFS_NO_FILE               0xFF
+
+		/** Macro to create a file entry in the filesystem image's lookup table, with the lengths of the file's path, content
+		 *  type and data computed at compile time.
+		 *
+		 *  \param[in] FilePath  String literal giving the absolute path of the file
+		 *  \param[in] FileType  String literal giving the MIME content type of the file
+		 *  \param[in] FileData  PROGMEM string array containing the file data
+		 */
+		#define ROMFS_FILE(FilePath, FileType, FileData) {.Path = FilePath, .PathLength = (sizeof(FilePath) - 1),              \
+		                                                  .ContentType = FileType, .ContentTypeLength = (sizeof(FileType) - 1), \
+		                                                  .Data = FileData, .Length = (sizeof(FileData) - 1)}
+
+	/* Type Defines: */
+		/** Type define for a file entry in the filesystem image's lookup table, which is located in PROGMEM. */
+		typedef struct
+		{
+			char                   Path[ROMFS_MAX_PATH_LENGTH]; /**< Absolute path of the file, starting with a '/' */
+			uint8_t                PathLength; /**< Length of the file path, excluding the null terminator */
+			char                   ContentType[ROMFS_MAX_TYPE_LENGTH]; /**< MIME content type of the file data */
+			uint8_t                ContentTypeLength; /**< Length of the content type, excluding the null terminator */
+			const char*            Data; /**< Pointer to the file data in PROGMEM */
+			uint16_t               Length; /**< Length of the file data in bytes, computed at compile time */
+		} ROMFS_File_t;
+
+	/* Function Prototypes: */
+		uint8_t  ROMFS_FindFile(const char* Path,
+		                        const uint8_t PathLength);
+		uint16_t ROMFS_GetFileLength(const uint8_t FileIndex);
+		uint8_t  ROMFS_CopyContentType(const uint8_t FileIndex,
+		                               char* Buffer);
+		uint16_t ROMFS_ReadFile(const uint8_t FileIndex,
+		                        const uint16_t Offset,
+		                        uint8_t* Buffer,
+		                        const uint16_t MaxLength);
+
+#endif
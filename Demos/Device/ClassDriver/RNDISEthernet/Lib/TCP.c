@@ -50,112 +50,95 @@ TCP_PortState_t        PortStateTable[MAX_OPEN_TCP_PORTS];
  */
 TCP_ConnectionState_t  ConnectionStateTable[MAX_TCP_CONNECTIONS];
 
+/** Connection hash table array. Each bucket holds the index of the first connection state table entry whose port, remote address
+ *  and remote port hash to the bucket, with further entries chained through each entry's NextInBucket index. This allows the entry
+ *  for a received packet to be located without scanning the entire connection state table.
+ */
+uint8_t                ConnectionHashTable[TCP_CONNECTION_HASH_BUCKETS];
+
+/** Outgoing segment table array. This holds the data of each segment sent to a host until it has been acknowledged, so that
+ *  several segments may be in flight at the one time and lost segments can be retransmitted. The table is shared between all
+ *  connections to save on SRAM, with free entries indicated by a NULL connection pointer.
+ */
+TCP_Segment_t          SegmentTable[TCP_TX_SEGMENTS];
+
 
 /** Task to handle the calling of each registered application's callback function, to process and generate TCP packets at the application
- *  level. If an application produces a response, this task constructs the appropriate Ethernet frame and places it into the Ethernet OUT
- *  buffer for later transmission.
+ *  level. If an application produces a response, this task splits it into segments no larger than the connection's negotiated MSS and
+ *  sends as many as the host's receive window and the free segment buffers allow, without waiting for each to be acknowledged. Segments
+ *  whose retransmission timer has expired are resent before any new data.
  */
 void TCP_TCPTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
 {
 	/* Run each application in sequence, to process incoming and generate outgoing packets */
 	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
 	{
-		/* Find the corresponding port entry in the port table */
-		for (uint8_t PTableEntry = 0; PTableEntry < MAX_OPEN_TCP_PORTS; PTableEntry++)
-		{
-			/* Run the application handler for the port */
-			if ((PortStateTable[PTableEntry].Port  == ConnectionStateTable[CSTableEntry].Port) && 
-			    (PortStateTable[PTableEntry].State == TCP_Port_Open))
-			{
-				PortStateTable[PTableEntry].ApplicationHandler(&ConnectionStateTable[CSTableEntry],
-				                                               &ConnectionStateTable[CSTableEntry].Info.Buffer);
-			}
-		}
+		TCP_ConnectionState_t* ConnectionState = &ConnectionStateTable[CSTableEntry];
+
+		if ((ConnectionState->State == TCP_Connection_Closed) || (ConnectionState->PortEntry == TCP_NO_ENTRY))
+		  continue;
+
+		/* Dispatch directly to the connection's port entry, which may have since been closed or reassigned to another port */
+		TCP_PortState_t* PortState = &PortStateTable[ConnectionState->PortEntry];
+
+		/* Run the application handler for the port */
+		if ((PortState->Port == ConnectionState->Port) && (PortState->State == TCP_Port_Open))
+		  PortState->ApplicationHandler(ConnectionState, &ConnectionState->Info.Buffer);
 	}
 	
-	/* Get pointer to the output frame info struct for convenience */
-	Ethernet_Frame_Info_t* FrameOUT = &RNDISInterfaceInfo->State.FrameOUT;
-	
-	/* Bail out early if there is already a frame waiting to be sent in the Ethernet OUT buffer */
-	if (FrameOUT->FrameInBuffer)
-	  return;
+	/* Get pointer to the next free output frame info struct from the RNDIS interface's transmit queue */
+	Ethernet_Frame_Info_t* FrameOUT = RNDIS_Device_GetTransmitFrame(RNDISInterfaceInfo);
 	
-	/* Send response packets from each application as the TCP packet buffers are filled by the applications */
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
+	/* Send retransmissions and new segments from each connection while output frame buffers are free */
+	for (uint8_t CSTableEntry = 0; (CSTableEntry < MAX_TCP_CONNECTIONS) && (FrameOUT != NULL); CSTableEntry++)
 	{
-		/* For each completely received packet, pass it along to the listening application */
-		if ((ConnectionStateTable[CSTableEntry].Info.Buffer.Direction == TCP_PACKETDIR_OUT) &&
-		    (ConnectionStateTable[CSTableEntry].Info.Buffer.Ready))
+		TCP_ConnectionState_t* ConnectionState = &ConnectionStateTable[CSTableEntry];
+		TCP_Segment_t*         Segment;
+
+		/* Only synchronized connections may send data to the host */
+		if ((ConnectionState->State < TCP_Connection_Established) || (ConnectionState->State == TCP_Connection_Closed))
+		  continue;
+
+		/* Resend the oldest unacknowledged segment (or the connection's FIN) if the retransmission timer has expired */
+		if (ConnectionState->Info.RetransmitPending)
 		{
-			Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT->FrameData;
-			IP_Header_t*             IPHeaderOUT    = (IP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t)];
-			TCP_Header_t*            TCPHeaderOUT   = (TCP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t) +
-			                                                                              sizeof(IP_Header_t)];
-			void*                    TCPDataOUT     = &FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t) +
-			                                                               sizeof(IP_Header_t) +
-			                                                               sizeof(TCP_Header_t)];
-
-			uint16_t PacketSize = ConnectionStateTable[CSTableEntry].Info.Buffer.Length;
-
-			/* Fill out the TCP data */
-			TCPHeaderOUT->SourcePort           = ConnectionStateTable[CSTableEntry].Port;
-			TCPHeaderOUT->DestinationPort      = ConnectionStateTable[CSTableEntry].RemotePort;
-			TCPHeaderOUT->SequenceNumber       = SwapEndian_32(ConnectionStateTable[CSTableEntry].Info.SequenceNumberOut);
-			TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(ConnectionStateTable[CSTableEntry].Info.SequenceNumberIn);
-			TCPHeaderOUT->DataOffset           = (sizeof(TCP_Header_t) / sizeof(uint32_t));
-			TCPHeaderOUT->WindowSize           = SwapEndian_16(TCP_WINDOW_SIZE);
-
-			TCPHeaderOUT->Flags                = TCP_FLAG_ACK;
-			TCPHeaderOUT->UrgentPointer        = 0;
-			TCPHeaderOUT->Checksum             = 0;
-			TCPHeaderOUT->Reserved             = 0;
-
-			memcpy(TCPDataOUT, ConnectionStateTable[CSTableEntry].Info.Buffer.Data, PacketSize);
-			
-			ConnectionStateTable[CSTableEntry].Info.SequenceNumberOut += PacketSize;
-
-			TCPHeaderOUT->Checksum             = TCP_Checksum16(TCPHeaderOUT, ServerIPAddress,
-			                                                    ConnectionStateTable[CSTableEntry].RemoteAddress,
-			                                                    (sizeof(TCP_Header_t) + PacketSize));
-
-			PacketSize += sizeof(TCP_Header_t);
-
-			/* Fill out the response IP header */
-			IPHeaderOUT->TotalLength        = SwapEndian_16(sizeof(IP_Header_t) + PacketSize);
-			IPHeaderOUT->TypeOfService      = 0;
-			IPHeaderOUT->HeaderLength       = (sizeof(IP_Header_t) / sizeof(uint32_t));
-			IPHeaderOUT->Version            = 4;
-			IPHeaderOUT->Flags              = 0;
-			IPHeaderOUT->FragmentOffset     = 0;
-			IPHeaderOUT->Identification     = 0;
-			IPHeaderOUT->HeaderChecksum     = 0;
-			IPHeaderOUT->Protocol           = PROTOCOL_TCP;
-			IPHeaderOUT->TTL                = DEFAULT_TTL;
-			IPHeaderOUT->SourceAddress      = ServerIPAddress;
-			IPHeaderOUT->DestinationAddress = ConnectionStateTable[CSTableEntry].RemoteAddress;
+			if (TCP_GetRetransmitSegment(ConnectionState, &Segment))
+			{
+				TCP_SendSegment(FrameOUT, ConnectionState, Segment);
+				FrameOUT = RNDIS_Device_GetTransmitFrame(RNDISInterfaceInfo);
+			}
 			
-			IPHeaderOUT->HeaderChecksum     = Ethernet_Checksum16(IPHeaderOUT, sizeof(IP_Header_t));
-		
-			PacketSize += sizeof(IP_Header_t);
-		
-			/* Fill out the response Ethernet frame header */
-			FrameOUTHeader->Source          = ServerMACAddress;
-			FrameOUTHeader->Destination     = (MAC_Address_t){{0x02, 0x00, 0x02, 0x00, 0x02, 0x00}};
-			FrameOUTHeader->EtherType       = SwapEndian_16(ETHERTYPE_IPV4);
-
-			PacketSize += sizeof(Ethernet_Frame_Header_t);
+			continue;
+		}
 
-			/* Set the response length in the buffer and indicate that a response is ready to be sent */
-			FrameOUT->FrameLength           = PacketSize;
-			FrameOUT->FrameInBuffer         = true;
+		/* Queue and send new segments from the application buffer until the window is full or no more frames are free, stopping
+		 * early if the host's MAC address is not yet known as the queued segment will be resent once it has been resolved */
+		while ((FrameOUT != NULL) && ((Segment = TCP_QueueSegment(&ConnectionState->Info)) != NULL))
+		{
+			bool SegmentSent = TCP_SendSegment(FrameOUT, ConnectionState, Segment);
 			
-			ConnectionStateTable[CSTableEntry].Info.Buffer.Ready = false;
+			FrameOUT = RNDIS_Device_GetTransmitFrame(RNDISInterfaceInfo);
 			
-			break;
+			if (!(SegmentSent))
+			  break;
 		}
 	}
 }
 
+/** Advances the retransmission timer of each connection with unacknowledged data in flight. This must be called every
+ *  \ref TCP_TICK_INTERVAL_MS milliseconds; expired timers are serviced in the next call to \ref TCP_TCPTask().
+ */
+void TCP_Tick(void)
+{
+	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
+	{
+		TCP_ConnectionInfo_t* ConnectionInfo = &ConnectionStateTable[CSTableEntry].Info;
+		
+		if (ConnectionInfo->RetransmitTimer && !(--ConnectionInfo->RetransmitTimer))
+		  ConnectionInfo->RetransmitPending = true;
+	}
+}
+
 /** Initialises the TCP protocol handler, clearing the port and connection state tables. This must be called before TCP packets are
  *  processed.
  */
@@ -168,6 +151,14 @@ void TCP_Init(void)
 	/* Initialize the connection table with all CLOSED entries */
 	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
 	  ConnectionStateTable[CSTableEntry].State = TCP_Connection_Closed;
+
+	/* Initialize the connection hash table with all EMPTY buckets */
+	for (uint8_t Bucket = 0; Bucket < TCP_CONNECTION_HASH_BUCKETS; Bucket++)
+	  ConnectionHashTable[Bucket] = TCP_NO_ENTRY;
+
+	/* Initialize the outgoing segment table with all FREE entries */
+	for (uint8_t SegmentEntry = 0; SegmentEntry < TCP_TX_SEGMENTS; SegmentEntry++)
+	  SegmentTable[SegmentEntry].Connection = NULL;
 }
 
 /** Sets the state and callback handler of the given port, specified in big endian to the given state.
@@ -184,22 +175,20 @@ bool TCP_SetPortState(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	/* Check to see if the port entry is already in the port state table */
-	for (uint8_t PTableEntry = 0; PTableEntry < MAX_TCP_CONNECTIONS; PTableEntry++)
+	/* Check to see if the port entry is already in the port state table, update it if found */
+	uint8_t PTableEntry = TCP_FindPortEntry(Port);
+
+	if (PTableEntry != TCP_NO_ENTRY)
 	{
-		/* Find existing entry for the port in the table, update it if found */
-		if (PortStateTable[PTableEntry].Port == Port)
-		{
-			PortStateTable[PTableEntry].State = State;
-			PortStateTable[PTableEntry].ApplicationHandler = Handler;
-			return true;
-		}
+		PortStateTable[PTableEntry].State = State;
+		PortStateTable[PTableEntry].ApplicationHandler = Handler;
+		return true;
 	}
 
 	/* Check if trying to open the port -- if so we need to find an unused (closed) entry and replace it */
 	if (State == TCP_Port_Open)
 	{
-		for (uint8_t PTableEntry = 0; PTableEntry < MAX_TCP_CONNECTIONS; PTableEntry++)
+		for (PTableEntry = 0; PTableEntry < MAX_OPEN_TCP_PORTS; PTableEntry++)
 		{
 			/* Find a closed port entry in the table, change it to the given port and state */
 			if (PortStateTable[PTableEntry].State == TCP_Port_Closed)
@@ -231,15 +220,13 @@ uint8_t TCP_GetPortState(const uint16_t Port)
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t PTableEntry = 0; PTableEntry < MAX_TCP_CONNECTIONS; PTableEntry++)
-	{
-		/* Find existing entry for the port in the table, return the port status if found */
-		if (PortStateTable[PTableEntry].Port == Port)
-		  return PortStateTable[PTableEntry].State;
-	}
-	
+	uint8_t PTableEntry = TCP_FindPortEntry(Port);
+
 	/* Port not in table, assume closed */
-	return TCP_Port_Closed;
+	if (PTableEntry == TCP_NO_ENTRY)
+	  return TCP_Port_Closed;
+
+	return PortStateTable[PTableEntry].State;
 }
 
 /** Sets the connection state of the given port, remote address and remote port to the given TCP connection state. If the
@@ -259,27 +246,58 @@ bool TCP_SetConnectionState(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
+	TCP_ConnectionState_t* ConnectionState = TCP_FindConnection(Port, &RemoteAddress, RemotePort);
+
+	/* Find existing entry for the connection in the table, update it if found */
+	if (ConnectionState != NULL)
 	{
-		/* Find port entry in the table */
-		if ((ConnectionStateTable[CSTableEntry].Port == Port) &&
-		     IP_COMPARE(&ConnectionStateTable[CSTableEntry].RemoteAddress, &RemoteAddress) &&
-			 ConnectionStateTable[CSTableEntry].RemotePort == RemotePort)
-		{
-			ConnectionStateTable[CSTableEntry].State = State;
-			return true;
-		}
+		ConnectionState->State = State;
+
+		/* Discard any unacknowledged data of a closed connection so that its segment buffers can be reused */
+		if (State == TCP_Connection_Closed)
+		  TCP_ReleaseSegments(&ConnectionState->Info);
+
+		return true;
 	}
 	
 	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
 	{
+		ConnectionState = &ConnectionStateTable[CSTableEntry];
+
 		/* Find empty entry in the table */
-		if (ConnectionStateTable[CSTableEntry].State == TCP_Connection_Closed)
+		if (ConnectionState->State == TCP_Connection_Closed)
 		{
-			ConnectionStateTable[CSTableEntry].Port          = Port;
-			ConnectionStateTable[CSTableEntry].RemoteAddress = RemoteAddress;			
-			ConnectionStateTable[CSTableEntry].RemotePort    = RemotePort;
-			ConnectionStateTable[CSTableEntry].State         = State;
+			uint8_t* BucketLink = &ConnectionHashTable[TCP_GetConnectionBucket(ConnectionState->Port,
+			                                                                   &ConnectionState->RemoteAddress,
+			                                                                   ConnectionState->RemotePort)];
+
+			/* Unlink the entry from the hash bucket chain of the closed connection it previously held, if any */
+			while (*BucketLink != TCP_NO_ENTRY)
+			{
+				if (*BucketLink == CSTableEntry)
+				{
+					*BucketLink = ConnectionState->NextInBucket;
+					break;
+				}
+				
+				BucketLink = &ConnectionStateTable[*BucketLink].NextInBucket;
+			}
+
+			ConnectionState->Port          = Port;
+			ConnectionState->RemoteAddress = RemoteAddress;			
+			ConnectionState->RemotePort    = RemotePort;
+			ConnectionState->State         = State;
+			ConnectionState->PortEntry     = TCP_FindPortEntry(Port);
+
+			/* Clear the application state left over from the previous connection held by the entry */
+			memset(ConnectionState->AppState, 0, sizeof(ConnectionState->AppState));
+
+			/* Link the entry into the head of the hash bucket chain for the new connection */
+			BucketLink = &ConnectionHashTable[TCP_GetConnectionBucket(Port, &RemoteAddress, RemotePort)];
+			
+			ConnectionState->NextInBucket  = *BucketLink;
+			*BucketLink                    = CSTableEntry;
+
 			return true;
 		}
 	}
@@ -301,19 +319,12 @@ uint8_t TCP_GetConnectionState(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
-	{
-		/* Find port entry in the table */
-		if ((ConnectionStateTable[CSTableEntry].Port == Port) &&
-		     IP_COMPARE(&ConnectionStateTable[CSTableEntry].RemoteAddress, &RemoteAddress) &&
-			 ConnectionStateTable[CSTableEntry].RemotePort == RemotePort)
-			 
-		{
-			return ConnectionStateTable[CSTableEntry].State;
-		}
-	}
+	TCP_ConnectionState_t* ConnectionState = TCP_FindConnection(Port, &RemoteAddress, RemotePort);
+
+	if (ConnectionState == NULL)
+	  return TCP_Connection_Closed;
 	
-	return TCP_Connection_Closed;
+	return ConnectionState->State;
 }
 
 /** Retrieves the connection info structure of a given connection to a host.
@@ -330,18 +341,12 @@ TCP_ConnectionInfo_t* TCP_GetConnectionInfo(const uint16_t Port,
 {
 	/* Note, Port number should be specified in BIG endian to simplify network code */
 
-	for (uint8_t CSTableEntry = 0; CSTableEntry < MAX_TCP_CONNECTIONS; CSTableEntry++)
-	{
-		/* Find port entry in the table */
-		if ((ConnectionStateTable[CSTableEntry].Port == Port) &&
-		     IP_COMPARE(&ConnectionStateTable[CSTableEntry].RemoteAddress, &RemoteAddress) &&
-			 ConnectionStateTable[CSTableEntry].RemotePort == RemotePort)
-		{
-			return &ConnectionStateTable[CSTableEntry].Info;
-		}
-	}
+	TCP_ConnectionState_t* ConnectionState = TCP_FindConnection(Port, &RemoteAddress, RemotePort);
+
+	if (ConnectionState == NULL)
+	  return NULL;
 	
-	return NULL;
+	return &ConnectionState->Info;
 }
 
 /** Processes a TCP packet inside an Ethernet frame, and writes the appropriate response
@@ -368,6 +373,10 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 	DecodeTCPHeader(TCPHeaderInStart);
 
 	bool PacketResponse = false;
+	bool FINSent        = false;
+	
+	/* Incoming flags are needed for the response sequence numbers, but may be overwritten by the in place response */
+	uint8_t FlagsIN     = TCPHeaderIN->Flags;
 		
 	/* Check if the destination port is open and allows incoming connections */
 	if (TCP_GetPortState(TCPHeaderIN->DestinationPort) == TCP_Port_Open)
@@ -388,8 +397,19 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 		}
 		else
 		{
+			uint8_t ConnectionState = TCP_GetConnectionState(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
+			                                                 TCPHeaderIN->SourcePort);
+
+			/* Acknowledgements free sent segments and update the host's receive window in all synchronized states */
+			if ((TCPHeaderIN->Flags & TCP_FLAG_ACK) &&
+			    (ConnectionState >= TCP_Connection_Established) && (ConnectionState != TCP_Connection_Closed))
+			{
+				TCP_ProcessAcknowledgement(TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
+				                                                 TCPHeaderIN->SourcePort), TCPHeaderIN);
+			}
+
 			/* Process the incoming TCP packet based on the current connection state for the sender and port */
-			switch (TCP_GetConnectionState(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress, TCPHeaderIN->SourcePort))
+			switch (ConnectionState)
 			{
 				case TCP_Connection_Listen:
 					if (TCPHeaderIN->Flags == TCP_FLAG_SYN)
@@ -405,6 +425,19 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 							ConnectionInfo->SequenceNumberIn  = (SwapEndian_32(TCPHeaderIN->SequenceNumber) + 1);
 							ConnectionInfo->SequenceNumberOut = 0;
 							ConnectionInfo->Buffer.InUse      = false;
+							ConnectionInfo->Buffer.Ready      = false;
+
+							/* Reset the send window, and negotiate the segment size from the host's MSS option */
+							ConnectionInfo->UnacknowledgedSequenceNumber = 0;
+							ConnectionInfo->RemoteWindowSize  = SwapEndian_16(TCPHeaderIN->WindowSize);
+							ConnectionInfo->MaxSegmentSize    = TCP_GetMaxSegmentSize(TCPHeaderIN);
+							ConnectionInfo->BufferQueued      = 0;
+							ConnectionInfo->RetransmitTimer   = 0;
+							ConnectionInfo->RetransmitTimeout = (TCP_RETRANSMIT_TIMEOUT_MS / TCP_TICK_INTERVAL_MS);
+							ConnectionInfo->Retransmissions   = 0;
+							ConnectionInfo->RetransmitPending = false;
+							
+							TCP_ReleaseSegments(ConnectionInfo);
 						}
 						else
 						{
@@ -427,6 +460,10 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 															   TCPHeaderIN->SourcePort);
 															   
 						ConnectionInfo->SequenceNumberOut++;
+						
+						/* Host has acknowledged our SYN, device-to-host data starts from the next sequence number */
+						ConnectionInfo->UnacknowledgedSequenceNumber = ConnectionInfo->SequenceNumberOut;
+						ConnectionInfo->RemoteWindowSize             = SwapEndian_16(TCPHeaderIN->WindowSize);
 					}
 					
 					break;
@@ -445,13 +482,29 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 															   TCPHeaderIN->SourcePort);
 
 						ConnectionInfo->SequenceNumberIn++;
-						ConnectionInfo->SequenceNumberOut++;
+						FINSent             = true;
 					}
 					else if ((TCPHeaderIN->Flags == TCP_FLAG_ACK) || (TCPHeaderIN->Flags == (TCP_FLAG_ACK | TCP_FLAG_PSH)))
 					{
 						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
 															   TCPHeaderIN->SourcePort);
 
+						uint16_t IPOffset   = (IPHeaderIN->HeaderLength * sizeof(uint32_t));
+						uint16_t TCPOffset  = (TCPHeaderIN->DataOffset * sizeof(uint32_t));
+						uint16_t DataLength = (SwapEndian_16(IPHeaderIN->TotalLength) - IPOffset - TCPOffset);
+
+						/* Pure acknowledgements of sent data carry no payload, and have already been processed */
+						if (!(DataLength))
+						  break;
+
+						/* Re-acknowledge out of order or duplicate data from the host so that it retransmits the expected segment */
+						if (SwapEndian_32(TCPHeaderIN->SequenceNumber) != ConnectionInfo->SequenceNumberIn)
+						{
+							TCPHeaderOUT->Flags = TCP_FLAG_ACK;
+							PacketResponse      = true;
+							break;
+						}
+
 						/* Check if the buffer is currently in use either by a buffered data to send, or receive */		
 						if ((ConnectionInfo->Buffer.InUse == false) && (ConnectionInfo->Buffer.Ready == false))
 						{						
@@ -464,10 +517,6 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 						if ((ConnectionInfo->Buffer.Direction == TCP_PACKETDIR_IN) &&
 							(ConnectionInfo->Buffer.Length != TCP_WINDOW_SIZE))
 						{
-							uint16_t IPOffset   = (IPHeaderIN->HeaderLength * sizeof(uint32_t));
-							uint16_t TCPOffset  = (TCPHeaderIN->DataOffset * sizeof(uint32_t));
-							uint16_t DataLength = (SwapEndian_16(IPHeaderIN->TotalLength) - IPOffset - TCPOffset);
-
 							/* Copy the packet data into the buffer */
 							memcpy(&ConnectionInfo->Buffer.Data[ConnectionInfo->Buffer.Length],
 								   &((uint8_t*)TCPHeaderInStart)[TCPOffset],
@@ -498,8 +547,13 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
 															   TCPHeaderIN->SourcePort);
 
+						/* FIN must follow the application's final data, wait until all of it has been queued for sending */
+						if (ConnectionInfo->Buffer.Ready)
+						  break;
+
 						TCPHeaderOUT->Flags = (TCP_FLAG_ACK | TCP_FLAG_FIN);
 						PacketResponse      = true;
+						FINSent             = true;
 						
 						ConnectionInfo->Buffer.InUse = false;
 						
@@ -517,15 +571,21 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 						PacketResponse      = true;
 
 						ConnectionInfo->SequenceNumberIn++;
-						ConnectionInfo->SequenceNumberOut++;
 						
 						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
 											   TCPHeaderIN->SourcePort, TCP_Connection_Closed);
 					}
 					else if (TCPHeaderIN->Flags == TCP_FLAG_ACK)
 					{
-						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
-											   TCPHeaderIN->SourcePort, TCP_Connection_FINWait2);
+						ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
+															   TCPHeaderIN->SourcePort);
+
+						/* Only a host ACK which covers our FIN completes the first half of the close */
+						if (SwapEndian_32(TCPHeaderIN->AcknowledgmentNumber) == ConnectionInfo->SequenceNumberOut)
+						{
+							TCP_SetConnectionState(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
+												   TCPHeaderIN->SourcePort, TCP_Connection_FINWait2);
+						}
 					}
 					
 					break;
@@ -539,7 +599,6 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 						PacketResponse      = true;
 
 						ConnectionInfo->SequenceNumberIn++;
-						ConnectionInfo->SequenceNumberOut++;
 						
 						TCP_SetConnectionState(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
 											   TCPHeaderIN->SourcePort, TCP_Connection_Closed);
@@ -570,13 +629,54 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 		ConnectionInfo = TCP_GetConnectionInfo(TCPHeaderIN->DestinationPort, IPHeaderIN->SourceAddress,
 		                                       TCPHeaderIN->SourcePort);
 
-		TCPHeaderOUT->SourcePort           = TCPHeaderIN->DestinationPort;
-		TCPHeaderOUT->DestinationPort      = TCPHeaderIN->SourcePort;
-		TCPHeaderOUT->SequenceNumber       = SwapEndian_32(ConnectionInfo->SequenceNumberOut);
-		TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(ConnectionInfo->SequenceNumberIn);
+		/* Save the incoming ports and sequence numbers before they are swapped, as the response header may overwrite the
+		   incoming header */
+		uint16_t SourcePort      = TCPHeaderIN->SourcePort;
+		uint16_t DestinationPort = TCPHeaderIN->DestinationPort;
+		uint32_t SequenceNumber  = SwapEndian_32(TCPHeaderIN->SequenceNumber);
+		uint32_t AckNumber       = SwapEndian_32(TCPHeaderIN->AcknowledgmentNumber);
+
+		/* Resets to closed ports have no connection, so continue on from the sequence numbers of the incoming packet */
+		if (ConnectionInfo != NULL)
+		{
+			SequenceNumber = ConnectionInfo->SequenceNumberIn;
+			AckNumber      = ConnectionInfo->SequenceNumberOut;
+
+			/* Our FIN occupies one sequence number after the final data, so that the host's ACK of it is accepted, and is
+			   resent from the retransmission timer until it is acknowledged */
+			if (FINSent)
+			{
+				ConnectionInfo->SequenceNumberOut++;
+
+				if (!(ConnectionInfo->RetransmitTimer))
+				  ConnectionInfo->RetransmitTimer = ConnectionInfo->RetransmitTimeout;
+			}
+		}
+		else if (FlagsIN & TCP_FLAG_SYN)
+		{
+			SequenceNumber++;
+		}
+
+		TCPHeaderOUT->SourcePort           = DestinationPort;
+		TCPHeaderOUT->DestinationPort      = SourcePort;
+		TCPHeaderOUT->SequenceNumber       = SwapEndian_32(AckNumber);
+		TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(SequenceNumber);
 		TCPHeaderOUT->DataOffset           = (sizeof(TCP_Header_t) / sizeof(uint32_t));
 		
-		if (!(ConnectionInfo->Buffer.InUse))
+		/* Advertise the device's maximum segment size to the host when synchronizing */
+		if (TCPHeaderOUT->Flags & TCP_FLAG_SYN)
+		{
+			uint8_t* TCPOptionsOUT = &((uint8_t*)TCPHeaderOutStart)[sizeof(TCP_Header_t)];
+			
+			TCPOptionsOUT[0] = TCP_OPTION_MSS;
+			TCPOptionsOUT[1] = 4;
+			TCPOptionsOUT[2] = (TCP_MAX_SEGMENT_SIZE >> 8);
+			TCPOptionsOUT[3] = (TCP_MAX_SEGMENT_SIZE & 0xFF);
+			
+			TCPHeaderOUT->DataOffset++;
+		}
+		
+		if ((ConnectionInfo == NULL) || !(ConnectionInfo->Buffer.InUse))
 		  TCPHeaderOUT->WindowSize         = SwapEndian_16(TCP_WINDOW_SIZE);
 		else
 		  TCPHeaderOUT->WindowSize         = SwapEndian_16(TCP_WINDOW_SIZE - ConnectionInfo->Buffer.Length);
@@ -585,31 +685,422 @@ int16_t TCP_ProcessTCPPacket(void* IPHeaderInStart,
 		TCPHeaderOUT->Checksum             = 0;
 		TCPHeaderOUT->Reserved             = 0;
 		
+		uint16_t TCPHeaderSize = (TCPHeaderOUT->DataOffset * sizeof(uint32_t));
+
 		TCPHeaderOUT->Checksum             = TCP_Checksum16(TCPHeaderOUT, IPHeaderIN->DestinationAddress,
-		                                                    IPHeaderIN->SourceAddress, sizeof(TCP_Header_t));					
+		                                                    IPHeaderIN->SourceAddress, TCPHeaderSize, 0);
 
-		return sizeof(TCP_Header_t);	
+		return TCPHeaderSize;	
 	}
 
 	return NO_RESPONSE;
 }
 
+/** Calculates the connection hash table bucket of a given connection, from its device port, remote address and remote port.
+ *
+ *  \param[in] Port           TCP port of the connection on the device, specified in big endian
+ *  \param[in] RemoteAddress  Remote protocol IP address of the connected host
+ *  \param[in] RemotePort     TCP port of the remote host in the connection, specified in big endian
+ *
+ *  \return Index of the connection's bucket in the connection hash table
+ */
+static uint8_t TCP_GetConnectionBucket(const uint16_t Port,
+                                       const IP_Address_t* const RemoteAddress,
+                                       const uint16_t RemotePort)
+{
+	/* Remote port varies the most between connections from the same host, so is folded in last */
+	uint8_t Hash = (RemoteAddress->Octets[2] ^ RemoteAddress->Octets[3] ^ (Port >> 8) ^ (Port & 0xFF));
+	
+	Hash ^= ((RemotePort >> 8) ^ (RemotePort & 0xFF));
+	Hash ^= (Hash >> 4);
+
+	return (Hash & (TCP_CONNECTION_HASH_BUCKETS - 1));
+}
+
+/** Locates the entry of a given connection in the connection state table, via the connection hash table.
+ *
+ *  \param[in] Port           TCP port of the connection on the device, specified in big endian
+ *  \param[in] RemoteAddress  Remote protocol IP address of the connected host
+ *  \param[in] RemotePort     TCP port of the remote host in the connection, specified in big endian
+ *
+ *  \return Pointer to the connection's entry in the connection state table if found, NULL otherwise
+ */
+static TCP_ConnectionState_t* TCP_FindConnection(const uint16_t Port,
+                                                 const IP_Address_t* const RemoteAddress,
+                                                 const uint16_t RemotePort)
+{
+	uint8_t CSTableEntry = ConnectionHashTable[TCP_GetConnectionBucket(Port, RemoteAddress, RemotePort)];
+
+	/* Walk the bucket's chain, which only contains connections with the same hash */
+	while (CSTableEntry != TCP_NO_ENTRY)
+	{
+		TCP_ConnectionState_t* ConnectionState = &ConnectionStateTable[CSTableEntry];
+	
+		if ((ConnectionState->Port == Port) && (ConnectionState->RemotePort == RemotePort) &&
+		    IP_COMPARE(&ConnectionState->RemoteAddress, RemoteAddress))
+		{
+			return ConnectionState;
+		}
+		
+		CSTableEntry = ConnectionState->NextInBucket;
+	}
+	
+	return NULL;
+}
+
+/** Locates the entry of a given port in the port state table.
+ *
+ *  \param[in] Port  TCP port number on the device, specified in big endian
+ *
+ *  \return Index of the port's entry in the port state table if found, TCP_NO_ENTRY otherwise
+ */
+static uint8_t TCP_FindPortEntry(const uint16_t Port)
+{
+	for (uint8_t PTableEntry = 0; PTableEntry < MAX_OPEN_TCP_PORTS; PTableEntry++)
+	{
+		if (PortStateTable[PTableEntry].Port == Port)
+		  return PTableEntry;
+	}
+	
+	return TCP_NO_ENTRY;
+}
+
+/** Retrieves the maximum segment size advertised by the host in the options of a received SYN segment, limited to the
+ *  device's own \ref TCP_MAX_SEGMENT_SIZE.
+ *
+ *  \param[in] TCPHeaderIN  Pointer to the received segment's TCP header
+ *
+ *  \return Maximum payload size of segments sent to the host on the connection
+ */
+static uint16_t TCP_GetMaxSegmentSize(const TCP_Header_t* const TCPHeaderIN)
+{
+	const uint8_t* Options        = &((const uint8_t*)TCPHeaderIN)[sizeof(TCP_Header_t)];
+	uint8_t        OptionsLength  = ((TCPHeaderIN->DataOffset * sizeof(uint32_t)) - sizeof(TCP_Header_t));
+	uint16_t       MaxSegmentSize = TCP_DEFAULT_MAX_SEGMENT_SIZE;
+
+	if (TCPHeaderIN->DataOffset < (sizeof(TCP_Header_t) / sizeof(uint32_t)))
+	  OptionsLength = 0;
+
+	while (OptionsLength)
+	{
+		if (Options[0] == TCP_OPTION_END)
+		{
+			break;
+		}
+		else if (Options[0] == TCP_OPTION_NOP)
+		{
+			Options++;
+			OptionsLength--;
+		}
+		else
+		{
+			/* Abort on malformed options which would run past the end of the header */
+			if ((OptionsLength < 2) || (Options[1] < 2) || (Options[1] > OptionsLength))
+			  break;
+
+			if ((Options[0] == TCP_OPTION_MSS) && (Options[1] == 4))
+			  MaxSegmentSize = (((uint16_t)Options[2] << 8) | Options[3]);
+
+			OptionsLength -= Options[1];
+			Options       += Options[1];
+		}
+	}
+
+	if ((MaxSegmentSize > TCP_MAX_SEGMENT_SIZE) || !(MaxSegmentSize))
+	  MaxSegmentSize = TCP_MAX_SEGMENT_SIZE;
+
+	return MaxSegmentSize;
+}
+
+/** Moves the next block of unsent data in a connection's application buffer into a free outgoing segment buffer, ready to be
+ *  sent to the host. The block is limited to the connection's negotiated MSS and the space remaining in the host's receive window.
+ *
+ *  \param[in,out] ConnectionInfo  Connection whose application buffer is to be segmented
+ *
+ *  \return Pointer to the newly queued segment, or NULL if no data could be queued
+ */
+static TCP_Segment_t* TCP_QueueSegment(TCP_ConnectionInfo_t* const ConnectionInfo)
+{
+	TCP_ConnectionBuffer_t* Buffer = &ConnectionInfo->Buffer;
+
+	if (!(Buffer->Ready) || (Buffer->Direction != TCP_PACKETDIR_OUT))
+	  return NULL;
+
+	uint16_t Length   = (Buffer->Length - ConnectionInfo->BufferQueued);
+	uint16_t InFlight = (ConnectionInfo->SequenceNumberOut - ConnectionInfo->UnacknowledgedSequenceNumber);
+
+	/* Empty buffers have nothing to send, release them back to the application immediately */
+	if (!(Length))
+	{
+		Buffer->Ready = false;
+		return NULL;
+	}
+
+	/* Wait for the host to acknowledge data if its receive window is full */
+	if (InFlight >= ConnectionInfo->RemoteWindowSize)
+	  return NULL;
+
+	if (Length > ConnectionInfo->MaxSegmentSize)
+	  Length = ConnectionInfo->MaxSegmentSize;
+
+	if (Length > (ConnectionInfo->RemoteWindowSize - InFlight))
+	  Length = (ConnectionInfo->RemoteWindowSize - InFlight);
+
+	for (uint8_t SegmentEntry = 0; SegmentEntry < TCP_TX_SEGMENTS; SegmentEntry++)
+	{
+		TCP_Segment_t* Segment = &SegmentTable[SegmentEntry];
+	
+		if (Segment->Connection != NULL)
+		  continue;
+
+		/* Sum the payload as it is copied into the segment, so that it does not need to be re-read on each transmission */
+		Segment->Connection      = ConnectionInfo;
+		Segment->SequenceNumber  = ConnectionInfo->SequenceNumberOut;
+		Segment->Length          = Length;
+		Segment->PayloadChecksum = Ethernet_ChecksumCopy(Segment->Data, &Buffer->Data[ConnectionInfo->BufferQueued], Length, 0);
+
+		ConnectionInfo->SequenceNumberOut += Length;
+		ConnectionInfo->BufferQueued      += Length;
+
+		/* Once the entire buffer has been queued, hand it back to the application for the next block of data */
+		if (ConnectionInfo->BufferQueued == Buffer->Length)
+		{
+			ConnectionInfo->BufferQueued = 0;
+			Buffer->Ready = false;
+		}
+
+		/* Start the retransmission timer if it is not already running for earlier unacknowledged data */
+		if (!(ConnectionInfo->RetransmitTimer))
+		  ConnectionInfo->RetransmitTimer = ConnectionInfo->RetransmitTimeout;
+
+		return Segment;
+	}
+	
+	/* No free segment buffers, wait until earlier segments are acknowledged */
+	return NULL;
+}
+
+/** Services an expired retransmission timer of a connection, backing off the connection's retransmission timeout and locating
+ *  the oldest unacknowledged segment to resend. Once all data has been acknowledged, a closing connection's unacknowledged FIN
+ *  is resent instead. Connections which exceed \ref TCP_MAX_RETRANSMISSIONS are abandoned.
+ *
+ *  \param[in,out] ConnectionState  Connection whose retransmission timer has expired
+ *  \param[out]    Segment          Location where a pointer to the segment to resend is to be stored, or NULL to resend the FIN
+ *
+ *  \return Boolean true if a segment or FIN is to be resent, false otherwise
+ */
+static bool TCP_GetRetransmitSegment(TCP_ConnectionState_t* const ConnectionState,
+                                     TCP_Segment_t** const Segment)
+{
+	TCP_ConnectionInfo_t* ConnectionInfo = &ConnectionState->Info;
+	TCP_Segment_t*        OldestSegment  = NULL;
+
+	ConnectionInfo->RetransmitPending = false;
+
+	/* Give up on the connection if the host has stopped responding */
+	if (++ConnectionInfo->Retransmissions > TCP_MAX_RETRANSMISSIONS)
+	{
+		TCP_ReleaseSegments(ConnectionInfo);
+		ConnectionState->State = TCP_Connection_Closed;
+		return false;
+	}
+
+	for (uint8_t SegmentEntry = 0; SegmentEntry < TCP_TX_SEGMENTS; SegmentEntry++)
+	{
+		TCP_Segment_t* CurrSegment = &SegmentTable[SegmentEntry];
+		
+		if (CurrSegment->Connection != ConnectionInfo)
+		  continue;
+
+		/* Compare sequence numbers relative to the oldest unacknowledged byte, so that wrap-around is handled */
+		if ((OldestSegment == NULL) ||
+		    ((CurrSegment->SequenceNumber - ConnectionInfo->UnacknowledgedSequenceNumber) <
+		     (OldestSegment->SequenceNumber - ConnectionInfo->UnacknowledgedSequenceNumber)))
+		{
+			OldestSegment = CurrSegment;
+		}
+	}
+
+	/* With all data acknowledged, the only unacknowledged sequence number left in a closing connection is our FIN */
+	if ((OldestSegment == NULL) &&
+	    (((ConnectionState->State != TCP_Connection_FINWait1) && (ConnectionState->State != TCP_Connection_CloseWait)) ||
+	     (ConnectionInfo->UnacknowledgedSequenceNumber == ConnectionInfo->SequenceNumberOut)))
+	{
+		return false;
+	}
+
+	/* Back off exponentially so that a congested host is not flooded with repeated segments */
+	if (ConnectionInfo->RetransmitTimeout < (TCP_MAX_RETRANSMIT_TIMEOUT_MS / TCP_TICK_INTERVAL_MS / 2))
+	  ConnectionInfo->RetransmitTimeout *= 2;
+	else
+	  ConnectionInfo->RetransmitTimeout  = (TCP_MAX_RETRANSMIT_TIMEOUT_MS / TCP_TICK_INTERVAL_MS);
+
+	ConnectionInfo->RetransmitTimer = ConnectionInfo->RetransmitTimeout;
+
+	*Segment = OldestSegment;
+	return true;
+}
+
+/** Processes the acknowledgement number and window of a segment received from the host, releasing the outgoing segment buffers
+ *  of any newly acknowledged data and restarting the connection's retransmission timer.
+ *
+ *  \param[in,out] ConnectionInfo  Connection the received segment belongs to
+ *  \param[in]     TCPHeaderIN     Pointer to the received segment's TCP header
+ */
+static void TCP_ProcessAcknowledgement(TCP_ConnectionInfo_t* const ConnectionInfo,
+                                       const TCP_Header_t* const TCPHeaderIN)
+{
+	uint32_t AckNumber = SwapEndian_32(TCPHeaderIN->AcknowledgmentNumber);
+	
+	ConnectionInfo->RemoteWindowSize = SwapEndian_16(TCPHeaderIN->WindowSize);
+
+	/* Ignore acknowledgements of data which is already acknowledged, or which has not yet been sent */
+	if (((int32_t)(AckNumber - ConnectionInfo->UnacknowledgedSequenceNumber) <= 0) ||
+	    ((int32_t)(AckNumber - ConnectionInfo->SequenceNumberOut) > 0))
+	{
+		return;
+	}
+	
+	ConnectionInfo->UnacknowledgedSequenceNumber = AckNumber;
+
+	/* Free each segment which has been completely acknowledged by the host */
+	for (uint8_t SegmentEntry = 0; SegmentEntry < TCP_TX_SEGMENTS; SegmentEntry++)
+	{
+		TCP_Segment_t* Segment = &SegmentTable[SegmentEntry];
+	
+		if ((Segment->Connection == ConnectionInfo) &&
+		    ((int32_t)(AckNumber - (Segment->SequenceNumber + Segment->Length)) >= 0))
+		{
+			Segment->Connection = NULL;
+		}
+	}
+	
+	/* Host is responding, reset the backoff and restart the timer if there is still unacknowledged data in flight */
+	ConnectionInfo->Retransmissions   = 0;
+	ConnectionInfo->RetransmitPending = false;
+	ConnectionInfo->RetransmitTimeout = (TCP_RETRANSMIT_TIMEOUT_MS / TCP_TICK_INTERVAL_MS);
+	ConnectionInfo->RetransmitTimer   = (AckNumber != ConnectionInfo->SequenceNumberOut) ? ConnectionInfo->RetransmitTimeout : 0;
+}
+
+/** Frees all outgoing segment buffers belonging to the given connection, discarding any unacknowledged data.
+ *
+ *  \param[in] ConnectionInfo  Connection whose segments are to be released
+ */
+static void TCP_ReleaseSegments(const TCP_ConnectionInfo_t* const ConnectionInfo)
+{
+	for (uint8_t SegmentEntry = 0; SegmentEntry < TCP_TX_SEGMENTS; SegmentEntry++)
+	{
+		if (SegmentTable[SegmentEntry].Connection == ConnectionInfo)
+		  SegmentTable[SegmentEntry].Connection = NULL;
+	}
+}
+
+/** Constructs a complete Ethernet frame containing the given outgoing segment of a connection, and marks it ready for
+ *  transmission to the host. The segment acknowledges all data received from the host so far. If the host's MAC address
+ *  is not in the ARP cache, an ARP request for it may be sent in place of the segment, which remains unacknowledged and is
+ *  retransmitted once the connection's retransmission timer expires.
+ *
+ *  \param[out] FrameOUT        Pointer to a free output Ethernet frame
+ *  \param[in]  ConnectionState Connection the segment belongs to
+ *  \param[in]  Segment         Segment to send, or NULL to resend the connection's FIN
+ *
+ *  \return Boolean true if the segment was written to the frame, false if the host's MAC address is not yet known
+ */
+static bool TCP_SendSegment(Ethernet_Frame_Info_t* const FrameOUT,
+                            const TCP_ConnectionState_t* const ConnectionState,
+                            const TCP_Segment_t* const Segment)
+{
+	Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT->FrameData;
+	IP_Header_t*             IPHeaderOUT    = (IP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t)];
+	TCP_Header_t*            TCPHeaderOUT   = (TCP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t) +
+	                                                                              sizeof(IP_Header_t)];
+	void*                    TCPDataOUT     = &FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t) +
+	                                                               sizeof(IP_Header_t) +
+	                                                               sizeof(TCP_Header_t)];
+
+	MAC_Address_t RemoteMACAddress;
+	uint16_t      PacketSize = (Segment != NULL) ? Segment->Length : 0;
+
+	/* Look up the host's MAC address, requesting it from the network in place of the segment if it is not known */
+	if (!(ARP_ResolveAddress(FrameOUT, &ConnectionState->RemoteAddress, &RemoteMACAddress)))
+	  return false;
+
+	/* Fill out the TCP data */
+	TCPHeaderOUT->SourcePort           = ConnectionState->Port;
+	TCPHeaderOUT->DestinationPort      = ConnectionState->RemotePort;
+	TCPHeaderOUT->SequenceNumber       = SwapEndian_32((Segment != NULL) ? Segment->SequenceNumber :
+	                                                                       (ConnectionState->Info.SequenceNumberOut - 1));
+	TCPHeaderOUT->AcknowledgmentNumber = SwapEndian_32(ConnectionState->Info.SequenceNumberIn);
+	TCPHeaderOUT->DataOffset           = (sizeof(TCP_Header_t) / sizeof(uint32_t));
+	TCPHeaderOUT->WindowSize           = SwapEndian_16(TCP_WINDOW_SIZE);
+
+	TCPHeaderOUT->Flags                = (Segment != NULL) ? TCP_FLAG_ACK : (TCP_FLAG_FIN | TCP_FLAG_ACK);
+	TCPHeaderOUT->UrgentPointer        = 0;
+	TCPHeaderOUT->Checksum             = 0;
+	TCPHeaderOUT->Reserved             = 0;
+
+	if (Segment != NULL)
+	  memcpy(TCPDataOUT, Segment->Data, PacketSize);
+
+	TCPHeaderOUT->Checksum             = TCP_Checksum16(TCPHeaderOUT, ServerIPAddress, ConnectionState->RemoteAddress,
+	                                                    (sizeof(TCP_Header_t) + PacketSize),
+	                                                    (Segment != NULL) ? Segment->PayloadChecksum : 0);
+
+	PacketSize += sizeof(TCP_Header_t);
+
+	/* Fill out the response IP header */
+	IPHeaderOUT->TotalLength        = SwapEndian_16(sizeof(IP_Header_t) + PacketSize);
+	IPHeaderOUT->TypeOfService      = 0;
+	IPHeaderOUT->HeaderLength       = (sizeof(IP_Header_t) / sizeof(uint32_t));
+	IPHeaderOUT->Version            = 4;
+	IPHeaderOUT->Flags              = 0;
+	IPHeaderOUT->FragmentOffset     = 0;
+	IPHeaderOUT->Identification     = 0;
+	IPHeaderOUT->HeaderChecksum     = 0;
+	IPHeaderOUT->Protocol           = PROTOCOL_TCP;
+	IPHeaderOUT->TTL                = DEFAULT_TTL;
+	IPHeaderOUT->SourceAddress      = ServerIPAddress;
+	IPHeaderOUT->DestinationAddress = ConnectionState->RemoteAddress;
+	
+	IPHeaderOUT->HeaderChecksum     = Ethernet_Checksum16(IPHeaderOUT, sizeof(IP_Header_t));
+
+	PacketSize += sizeof(IP_Header_t);
+
+	/* Fill out the response Ethernet frame header */
+	FrameOUTHeader->Source          = ServerMACAddress;
+	FrameOUTHeader->Destination     = RemoteMACAddress;
+	FrameOUTHeader->EtherType       = SwapEndian_16(ETHERTYPE_IPV4);
+
+	PacketSize += sizeof(Ethernet_Frame_Header_t);
+
+	/* Set the response length in the buffer and indicate that a response is ready to be sent */
+	FrameOUT->FrameLength           = PacketSize;
+	FrameOUT->FrameInBuffer         = true;
+
+	PROTOCOL_TRACE(PROTOCOL_TRACE_TX, false, PacketSize, ETHERTYPE_IPV4);
+	
+	return true;
+}
+
 /** Calculates the appropriate TCP checksum, consisting of the addition of the one's compliment of each word,
- *  complimented.
+ *  complimented. Only the IP pseudo-header and the TCP header are summed by this function; the sum of the segment's
+ *  payload must be supplied by the caller, typically calculated while the payload was copied into the frame.
  *
  *  \param[in] TCPHeaderOutStart   Pointer to the start of the packet's outgoing TCP header
  *  \param[in] SourceAddress       Source protocol IP address of the outgoing IP header
  *  \param[in] DestinationAddress  Destination protocol IP address of the outgoing IP header
  *  \param[in] TCPOutSize          Size in bytes of the TCP data header and payload
+ *  \param[in] PayloadChecksum     Partial checksum of the segment payload from \ref Ethernet_ChecksumCopy(), or zero if no payload
  *
  *  \return A 16-bit TCP checksum value
  */
 static uint16_t TCP_Checksum16(void* TCPHeaderOutStart,
                                const IP_Address_t SourceAddress,
                                const IP_Address_t DestinationAddress,
-                               const uint16_t TCPOutSize)
+                               const uint16_t TCPOutSize,
+                               const uint32_t PayloadChecksum)
 {
-	uint32_t Checksum = 0;
+	uint32_t Checksum = PayloadChecksum;
 	
 	/* TCP/IP checksums are the addition of the one's compliment of each word including the IP pseudo-header,
 	   complimented */
@@ -621,14 +1112,9 @@ static uint16_t TCP_Checksum16(void* TCPHeaderOutStart,
 	Checksum += SwapEndian_16(PROTOCOL_TCP);
 	Checksum += SwapEndian_16(TCPOutSize);
 
-	for (uint16_t CurrWord = 0; CurrWord < (TCPOutSize >> 1); CurrWord++)
-	  Checksum += ((uint16_t*)TCPHeaderOutStart)[CurrWord];
-	
-	if (TCPOutSize & 0x01)
-	  Checksum += (((uint16_t*)TCPHeaderOutStart)[TCPOutSize >> 1] & 0x00FF);
-	  
-	while (Checksum & 0xFFFF0000)
-	  Checksum = ((Checksum & 0xFFFF) + (Checksum >> 16));
+	/* The TCP header (including any options) is always a whole number of words, so the payload checksum can be combined */
+	Checksum = Ethernet_ChecksumPartial(TCPHeaderOutStart,
+	                                    (((TCP_Header_t*)TCPHeaderOutStart)->DataOffset * sizeof(uint32_t)), Checksum);
 	
-	return ~Checksum;
+	return Ethernet_ChecksumFold16(Checksum);
 }
@@ -39,21 +39,71 @@
 	/* Includes: */
 		#include <avr/io.h>
 		#include <stdbool.h>
+		#include <string.h>
 		
 		#include "EthernetProtocols.h"
 		#include "Ethernet.h"
 		#include "ProtocolDecoders.h"
 		
 	/* Macros: */
-		/** Maximum number of TCP ports which can be open at the one time. */
-		#define MAX_OPEN_TCP_PORTS              1
+		#if !defined(MAX_OPEN_TCP_PORTS) || defined(__DOXYGEN__)
+			/** Maximum number of TCP ports which can be open at the one time. */
+			#define MAX_OPEN_TCP_PORTS          1
+		#endif
+
+		#if !defined(MAX_TCP_CONNECTIONS) || defined(__DOXYGEN__)
+			/** Maximum number of TCP connections which can be sustained at the one time. */
+			#define MAX_TCP_CONNECTIONS         3
+		#endif
+
+		#if !defined(TCP_CONNECTION_HASH_BUCKETS) || defined(__DOXYGEN__)
+			/** Number of hash buckets used to index the connection state table by port, remote address and remote port. This
+			 *  must be a power of two, and should be at least \ref MAX_TCP_CONNECTIONS for single entry bucket chains.
+			 */
+			#define TCP_CONNECTION_HASH_BUCKETS 4
+		#endif
+
+		#if !defined(TCP_APP_STATE_SIZE) || defined(__DOXYGEN__)
+			/** Size in bytes of the per-connection state area reserved for the application handling the connection's port. */
+			#define TCP_APP_STATE_SIZE          4
+		#endif
 
-		/** Maximum number of TCP connections which can be sustained at the one time. */
-		#define MAX_TCP_CONNECTIONS             3
+		/** Table index value indicating no entry, used to terminate connection hash bucket chains. */
+		#define TCP_NO_ENTRY                    0xFF
 
 		/** TCP window size, giving the maximum number of bytes which can be buffered at the one time. */
 		#define TCP_WINDOW_SIZE                 512
-		
+
+		#if !defined(TCP_MAX_SEGMENT_SIZE) || defined(__DOXYGEN__)
+			/** Maximum number of payload bytes in a single TCP segment, advertised to the host in the MSS option of the
+			 *  SYN/ACK. Outgoing segments are limited to the lesser of this value and the MSS advertised by the host.
+			 */
+			#define TCP_MAX_SEGMENT_SIZE        256
+		#endif
+
+		#if !defined(TCP_TX_SEGMENTS) || defined(__DOXYGEN__)
+			/** Number of outgoing segment buffers, shared between all connections, which hold sent data until it is
+			 *  acknowledged by the host. This sets the maximum number of unacknowledged segments in flight at the one time,
+			 *  and each buffer consumes slightly more than \ref TCP_MAX_SEGMENT_SIZE bytes of SRAM.
+			 */
+			#define TCP_TX_SEGMENTS             4
+		#endif
+
+		/** Interval in milliseconds between calls to \ref TCP_Tick(), which advances the retransmission timers. */
+		#define TCP_TICK_INTERVAL_MS            10
+
+		/** Initial retransmission timeout of a connection, in milliseconds. */
+		#define TCP_RETRANSMIT_TIMEOUT_MS       500
+
+		/** Maximum retransmission timeout of a connection after repeated exponential backoff, in milliseconds. */
+		#define TCP_MAX_RETRANSMIT_TIMEOUT_MS   4000
+
+		/** Number of successive retransmissions of a segment before the connection is abandoned. */
+		#define TCP_MAX_RETRANSMISSIONS         6
+
+		/** Maximum segment size assumed for a host which does not send a MSS option, as given in RFC1122. */
+		#define TCP_DEFAULT_MAX_SEGMENT_SIZE    536
+
 		/** Port number for HTTP transmissions. */
 		#define TCP_PORT_HTTP                   SwapEndian_16(80)
 		
@@ -86,7 +136,16 @@
 
 		/** Connection Finalize TCP flag mask. */
 		#define TCP_FLAG_FIN                    (1 << 0)
-		
+
+		/** End of option list TCP option kind. */
+		#define TCP_OPTION_END                  0
+
+		/** No operation (padding) TCP option kind. */
+		#define TCP_OPTION_NOP                  1
+
+		/** Maximum Segment Size TCP option kind. */
+		#define TCP_OPTION_MSS                  2
+
 		/** Application macro: Determines if the given application buffer contains a packet received from the host
 		 *
 		 *  \param[in] Buffer  Application buffer to check
@@ -145,6 +204,14 @@
 		 */
 		#define TCP_APP_CLOSECONNECTION(Connection)  MACROS{ Connection->State = TCP_Connection_Closing;  }MACROE
 
+		/** Application macro: Retrieves the application specific state of a connection, which is cleared to zero when the
+		 *  connection is opened and retained across calls to the application callback for the lifetime of the connection.
+		 *
+		 *  \param[in] Connection  TCP connection whose application state is to be retrieved
+		 *  \param[in] Type        Type of the application's state structure, no larger than \ref TCP_APP_STATE_SIZE bytes
+		 */
+		#define TCP_APP_GET_STATE(Connection, Type)  ((Type*)Connection->AppState)
+
 	/* Enums: */
 		/** Enum for possible TCP port states. */
 		enum TCP_PortStates_t
@@ -187,6 +254,14 @@
 		{
 			uint32_t               SequenceNumberIn; /**< Current TCP sequence number for host-to-device */	
 			uint32_t               SequenceNumberOut; /**< Current TCP sequence number for device-to-host */
+			uint32_t               UnacknowledgedSequenceNumber; /**< Oldest device-to-host sequence number not yet acknowledged */
+			uint16_t               RemoteWindowSize; /**< Last receive window size advertised by the host */
+			uint16_t               MaxSegmentSize; /**< Negotiated maximum payload size of device-to-host segments */
+			uint16_t               BufferQueued; /**< Number of bytes of the application buffer already queued for transmission */
+			uint16_t               RetransmitTimer; /**< Ticks until the oldest unacknowledged segment is resent, zero if stopped */
+			uint16_t               RetransmitTimeout; /**< Current retransmission timeout in ticks, doubled on each retransmission */
+			uint8_t                Retransmissions; /**< Number of successive retransmissions of the oldest unacknowledged segment */
+			bool                   RetransmitPending; /**< Indicates if the retransmission timer has expired */
 			TCP_ConnectionBuffer_t Buffer; /**< Connection application data buffer */
 		} TCP_ConnectionInfo_t;
 
@@ -198,8 +273,23 @@
 			IP_Address_t           RemoteAddress; /**< Connection protocol IP address of the host */
 			TCP_ConnectionInfo_t   Info; /**< Connection information, including application buffer */
 			uint8_t                State; /**< Current connection state, a value from the TCP_ConnectionStates_t enum */
+			uint8_t                PortEntry; /**< Index of the connection's port in the port state table, for direct dispatch */
+			uint8_t                NextInBucket; /**< Index of the next connection in the same hash bucket, or TCP_NO_ENTRY */
+			uint8_t                AppState[TCP_APP_STATE_SIZE]; /**< Application specific connection state, cleared when the
+			                                                      *   connection is opened
+			                                                      */
 		} TCP_ConnectionState_t;
 
+		/** Type define for an outgoing TCP segment, held until its data is acknowledged by the host. */
+		typedef struct
+		{
+			TCP_ConnectionInfo_t*  Connection; /**< Connection the segment belongs to, NULL if the segment buffer is free */
+			uint32_t               SequenceNumber; /**< Sequence number of the first byte of the segment payload */
+			uint32_t               PayloadChecksum; /**< Partial checksum of the segment payload, reused on each transmission */
+			uint16_t               Length; /**< Length of the segment payload */
+			uint8_t                Data[TCP_MAX_SEGMENT_SIZE]; /**< Segment payload */
+		} TCP_Segment_t;
+
 		/** Type define for a TCP port state. */
 		typedef struct
 		{
@@ -230,6 +320,7 @@
 	/* Function Prototypes: */
 		void                  TCP_TCPTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo);
 		void                  TCP_Init(void);
+		void                  TCP_Tick(void);
 		bool                  TCP_SetPortState(const uint16_t Port,
 		                                       const uint8_t State,
 		                                       void (*Handler)(TCP_ConnectionState_t*, TCP_ConnectionBuffer_t*));
@@ -249,10 +340,28 @@
 		                                           void* TCPHeaderOutStart);
 
 		#if defined(INCLUDE_FROM_TCP_C)
+			static uint8_t  TCP_GetConnectionBucket(const uint16_t Port,
+			                                        const IP_Address_t* const RemoteAddress,
+			                                        const uint16_t RemotePort);
+			static uint8_t  TCP_FindPortEntry(const uint16_t Port);
+			static TCP_ConnectionState_t* TCP_FindConnection(const uint16_t Port,
+			                                                 const IP_Address_t* const RemoteAddress,
+			                                                 const uint16_t RemotePort);
 			static uint16_t TCP_Checksum16(void* TCPHeaderOutStart,
 			                               const IP_Address_t SourceAddress,
 										   const IP_Address_t DestinationAddress,
-			                               uint16_t TCPOutSize);
+			                               const uint16_t TCPOutSize,
+			                               const uint32_t PayloadChecksum);
+			static uint16_t TCP_GetMaxSegmentSize(const TCP_Header_t* const TCPHeaderIN);
+			static void     TCP_ProcessAcknowledgement(TCP_ConnectionInfo_t* const ConnectionInfo,
+			                                           const TCP_Header_t* const TCPHeaderIN);
+			static void     TCP_ReleaseSegments(const TCP_ConnectionInfo_t* const ConnectionInfo);
+			static TCP_Segment_t* TCP_QueueSegment(TCP_ConnectionInfo_t* const ConnectionInfo);
+			static bool     TCP_GetRetransmitSegment(TCP_ConnectionState_t* const ConnectionState,
+			                                         TCP_Segment_t** const Segment);
+			static bool     TCP_SendSegment(Ethernet_Frame_Info_t* const FrameOUT,
+			                                const TCP_ConnectionState_t* const ConnectionState,
+			                                const TCP_Segment_t* const Segment);
 		#endif
 
 #endif
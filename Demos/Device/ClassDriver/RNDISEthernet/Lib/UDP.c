@@ -37,6 +37,160 @@
 #define  INCLUDE_FROM_UDP_C
 #include "UDP.h"
 
+/** Port state table array. This contains the current status of application UDP ports in the device. To save on space, only open
+ *  ports are stored - closed ports may be overwritten at any time, and the system will assume any ports not present in the array
+ *  are closed. Datagrams for the DHCP server are handled internally, and do not require an entry in the table.
+ */
+UDP_PortState_t UDPPortStateTable[MAX_OPEN_UDP_PORTS];
+
+
+/** Initialises the UDP protocol handler, clearing the port state table. This must be called before UDP packets are processed. */
+void UDP_Init(void)
+{
+	/* Initialize the port state table with all CLOSED entries */
+	for (uint8_t PTableEntry = 0; PTableEntry < MAX_OPEN_UDP_PORTS; PTableEntry++)
+	  UDPPortStateTable[PTableEntry].State = UDP_Port_Closed;
+}
+
+/** Sets the state and datagram handler of the given port, specified in big endian to the given state. The handler is called for
+ *  each datagram received on an open port, and may write a reply datagram's data into the given response buffer, which may be the
+ *  same buffer as the received datagram's data.
+ *
+ *  \param[in] Port     Port whose state and handler function to set, specified in big endian
+ *  \param[in] State    New state of the port, a value from the UDP_PortStates_t enum
+ *  \param[in] Handler  Application datagram handler for the port, returning the size of any reply or NO_RESPONSE
+ *
+ *  \return Boolean true if the port state was set, false otherwise (no more space in the port state table)
+ */
+bool UDP_SetPortState(const uint16_t Port,
+                      const uint8_t State,
+                      int16_t (*Handler)(const UDP_Datagram_t*, void*))
+{
+	/* Check to see if the port entry is already in the port state table, update it if found */
+	uint8_t PTableEntry = UDP_FindPortEntry(Port);
+
+	if (PTableEntry != UDP_NO_ENTRY)
+	{
+		UDPPortStateTable[PTableEntry].State = State;
+		UDPPortStateTable[PTableEntry].ApplicationHandler = Handler;
+		return true;
+	}
+
+	/* Port not in table but trying to close it, so operation successful */
+	if (State != UDP_Port_Open)
+	  return true;
+
+	/* Find a closed port entry in the table, change it to the given port and state */
+	for (PTableEntry = 0; PTableEntry < MAX_OPEN_UDP_PORTS; PTableEntry++)
+	{
+		if (UDPPortStateTable[PTableEntry].State == UDP_Port_Closed)
+		{
+			UDPPortStateTable[PTableEntry].Port  = Port;
+			UDPPortStateTable[PTableEntry].State = State;
+			UDPPortStateTable[PTableEntry].ApplicationHandler = Handler;
+			return true;
+		}
+	}
+	
+	/* Port not in table and no room to add it, return failure */
+	return false;
+}
+
+/** Retrieves the current state of a given UDP port, specified in big endian.
+ *
+ *  \param[in] Port  UDP port whose state is to be retrieved, given in big-endian
+ *
+ *  \return A value from the UDP_PortStates_t enum
+ */
+uint8_t UDP_GetPortState(const uint16_t Port)
+{
+	uint8_t PTableEntry = UDP_FindPortEntry(Port);
+
+	return (PTableEntry != UDP_NO_ENTRY) ? UDPPortStateTable[PTableEntry].State : UDP_Port_Closed;
+}
+
+/** Sends a UDP datagram to a host, building the UDP, IP and Ethernet headers in place in front of datagram data which the
+ *  application has already written into the frame at the location given by \ref UDP_DATAGRAM_DATA(). If the host's MAC address
+ *  is not in the ARP cache, the datagram is not sent and the frame may instead be used for an ARP request; the application should
+ *  then retry the datagram in a new frame once the address has been resolved.
+ *
+ *  \param[out] FrameOUT        Pointer to a free output Ethernet frame, containing the datagram data
+ *  \param[in]  LocalPort       Port on the device the datagram is sent from, in big endian
+ *  \param[in]  RemoteAddress   Protocol IP address of the host to send the datagram to
+ *  \param[in]  RemotePort      Port on the host to send the datagram to, in big endian
+ *  \param[in]  Length          Length of the datagram data in bytes, no larger than \ref UDP_MAX_DATAGRAM_SIZE
+ *  \param[in]  PayloadChecksum Pointer to a partial checksum of the datagram data from \ref Ethernet_ChecksumCopy(), or NULL
+ *                              for the data to be summed when the datagram is sent
+ *
+ *  \return Boolean true if the datagram was written to the frame, false if the host's MAC address is not yet known
+ */
+bool UDP_SendDatagram(Ethernet_Frame_Info_t* const FrameOUT,
+                      const uint16_t LocalPort,
+                      const IP_Address_t* const RemoteAddress,
+                      const uint16_t RemotePort,
+                      const uint16_t Length,
+                      const uint32_t* const PayloadChecksum)
+{
+	Ethernet_Frame_Header_t* FrameOUTHeader = (Ethernet_Frame_Header_t*)&FrameOUT->FrameData;
+	IP_Header_t*             IPHeaderOUT    = (IP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t)];
+	UDP_Header_t*            UDPHeaderOUT   = (UDP_Header_t*)&FrameOUT->FrameData[sizeof(Ethernet_Frame_Header_t) +
+	                                                                              sizeof(IP_Header_t)];
+	
+	MAC_Address_t RemoteMACAddress;
+	uint16_t      PacketSize = (sizeof(UDP_Header_t) + Length);
+
+	/* Look up the host's MAC address, requesting it from the network in place of the datagram if it is not known */
+	if (!(ARP_ResolveAddress(FrameOUT, RemoteAddress, &RemoteMACAddress)))
+	  return false;
+
+	/* Fill out the UDP header */
+	UDPHeaderOUT->SourcePort      = LocalPort;
+	UDPHeaderOUT->DestinationPort = RemotePort;
+	UDPHeaderOUT->Length          = SwapEndian_16(PacketSize);
+	UDPHeaderOUT->Checksum        = 0;
+	
+	#if !defined(NO_UDP_CHECKSUM)
+	/* Sum the datagram data here unless the application already summed it while writing it into the frame */
+	uint32_t DataChecksum = (PayloadChecksum != NULL) ? *PayloadChecksum :
+	                                                    Ethernet_ChecksumPartial(UDP_DATAGRAM_DATA(FrameOUT), Length, 0);
+
+	UDPHeaderOUT->Checksum        = UDP_Checksum16(UDPHeaderOUT, &ServerIPAddress, RemoteAddress, PacketSize, DataChecksum);
+	#endif
+
+	/* Fill out the IP header */
+	IPHeaderOUT->TotalLength        = SwapEndian_16(sizeof(IP_Header_t) + PacketSize);
+	IPHeaderOUT->TypeOfService      = 0;
+	IPHeaderOUT->HeaderLength       = (sizeof(IP_Header_t) / sizeof(uint32_t));
+	IPHeaderOUT->Version            = 4;
+	IPHeaderOUT->Flags              = 0;
+	IPHeaderOUT->FragmentOffset     = 0;
+	IPHeaderOUT->Identification     = 0;
+	IPHeaderOUT->HeaderChecksum     = 0;
+	IPHeaderOUT->Protocol           = PROTOCOL_UDP;
+	IPHeaderOUT->TTL                = DEFAULT_TTL;
+	IPHeaderOUT->SourceAddress      = ServerIPAddress;
+	IPHeaderOUT->DestinationAddress = *RemoteAddress;
+	
+	IPHeaderOUT->HeaderChecksum     = Ethernet_Checksum16(IPHeaderOUT, sizeof(IP_Header_t));
+
+	PacketSize += sizeof(IP_Header_t);
+
+	/* Fill out the Ethernet frame header */
+	FrameOUTHeader->Source          = ServerMACAddress;
+	FrameOUTHeader->Destination     = RemoteMACAddress;
+	FrameOUTHeader->EtherType       = SwapEndian_16(ETHERTYPE_IPV4);
+
+	PacketSize += sizeof(Ethernet_Frame_Header_t);
+
+	/* Set the frame length in the buffer and indicate that the datagram is ready to be sent */
+	FrameOUT->FrameLength           = PacketSize;
+	FrameOUT->FrameInBuffer         = true;
+
+	PROTOCOL_TRACE(PROTOCOL_TRACE_TX, false, PacketSize, ETHERTYPE_IPV4);
+	
+	return true;
+}
+
 /** Processes a UDP packet inside an Ethernet frame, and writes the appropriate response
  *  to the output Ethernet frame if a sub-protocol handler has created a response packet.
  *
@@ -50,12 +204,20 @@ int16_t UDP_ProcessUDPPacket(void* IPHeaderInStart,
                              void* UDPHeaderInStart,
                              void* UDPHeaderOutStart)
 {
+	IP_Header_t*  IPHeaderIN   = (IP_Header_t*)IPHeaderInStart;
 	UDP_Header_t* UDPHeaderIN  = (UDP_Header_t*)UDPHeaderInStart;
 	UDP_Header_t* UDPHeaderOUT = (UDP_Header_t*)UDPHeaderOutStart;
 	
 	int16_t RetSize = NO_RESPONSE;
 	
 	DecodeUDPHeader(UDPHeaderInStart);
+
+	/* Discard datagrams whose length is too short to contain a UDP header, or runs past the end of the IP packet */
+	uint16_t IPPayloadLength = (SwapEndian_16(IPHeaderIN->TotalLength) - (IPHeaderIN->HeaderLength * sizeof(uint32_t)));
+	uint16_t UDPLength       = SwapEndian_16(UDPHeaderIN->Length);
+
+	if ((UDPLength < sizeof(UDP_Header_t)) || (UDPLength > IPPayloadLength))
+	  return NO_RESPONSE;
 	
 	switch (SwapEndian_16(UDPHeaderIN->DestinationPort))
 	{
@@ -64,14 +226,39 @@ int16_t UDP_ProcessUDPPacket(void* IPHeaderInStart,
 			                                 &((uint8_t*)UDPHeaderInStart)[sizeof(UDP_Header_t)],
 		                                     &((uint8_t*)UDPHeaderOutStart)[sizeof(UDP_Header_t)]);
 			break;
+		default:
+		{
+			uint8_t PTableEntry = UDP_FindPortEntry(UDPHeaderIN->DestinationPort);
+			
+			/* Discard datagrams to closed ports */
+			if ((PTableEntry == UDP_NO_ENTRY) || (UDPPortStateTable[PTableEntry].State != UDP_Port_Open))
+			  break;
+
+			UDP_Datagram_t Datagram;
+			
+			Datagram.RemoteAddress = IPHeaderIN->SourceAddress;
+			Datagram.RemotePort    = UDPHeaderIN->SourcePort;
+			Datagram.LocalPort     = UDPHeaderIN->DestinationPort;
+			Datagram.Length        = (UDPLength - sizeof(UDP_Header_t));
+			Datagram.Data          = &((uint8_t*)UDPHeaderInStart)[sizeof(UDP_Header_t)];
+
+			/* Pass the datagram directly to the port's handler, which may write a reply over the received datagram data */
+			RetSize = UDPPortStateTable[PTableEntry].ApplicationHandler(&Datagram,
+			                                                            &((uint8_t*)UDPHeaderOutStart)[sizeof(UDP_Header_t)]);
+			break;
+		}
 	}
 	
 	/* Check to see if the protocol processing routine has filled out a response */
 	if (RetSize > 0)
 	{
+		/* Save the incoming ports before they are swapped, as the response header may overwrite the incoming header */
+		uint16_t SourcePort           = UDPHeaderIN->SourcePort;
+		uint16_t DestinationPort      = UDPHeaderIN->DestinationPort;
+
 		/* Fill out the response UDP packet header */
-		UDPHeaderOUT->SourcePort      = UDPHeaderIN->DestinationPort;
-		UDPHeaderOUT->DestinationPort = UDPHeaderIN->SourcePort;
+		UDPHeaderOUT->SourcePort      = DestinationPort;
+		UDPHeaderOUT->DestinationPort = SourcePort;
 		UDPHeaderOUT->Checksum        = 0;
 		UDPHeaderOUT->Length          = SwapEndian_16(sizeof(UDP_Header_t) + RetSize);
 
@@ -81,3 +268,54 @@ int16_t UDP_ProcessUDPPacket(void* IPHeaderInStart,
 	
 	return NO_RESPONSE;
 }
+
+/** Searches the UDP port state table for the entry of the given port.
+ *
+ *  \param[in] Port  UDP port to search for, given in big endian
+ *
+ *  \return Index of the port in the port state table, or UDP_NO_ENTRY if the port is not in the table
+ */
+static uint8_t UDP_FindPortEntry(const uint16_t Port)
+{
+	for (uint8_t PTableEntry = 0; PTableEntry < MAX_OPEN_UDP_PORTS; PTableEntry++)
+	{
+		if ((UDPPortStateTable[PTableEntry].State != UDP_Port_Closed) && (UDPPortStateTable[PTableEntry].Port == Port))
+		  return PTableEntry;
+	}
+	
+	return UDP_NO_ENTRY;
+}
+
+#if !defined(NO_UDP_CHECKSUM)
+/** Calculates the appropriate UDP checksum, consisting of the addition of the one's compliment of each word of the IP
+ *  pseudo-header, UDP header and datagram data, complimented. The sum of the datagram data must be supplied by the caller.
+ *
+ *  \param[in] UDPHeaderOutStart   Pointer to the start of the packet's outgoing UDP header
+ *  \param[in] SourceAddress       Source protocol IP address of the outgoing IP header
+ *  \param[in] DestinationAddress  Destination protocol IP address of the outgoing IP header
+ *  \param[in] UDPOutSize          Size in bytes of the UDP header and datagram data
+ *  \param[in] PayloadChecksum     Partial checksum of the datagram data
+ *
+ *  \return A 16-bit UDP checksum value
+ */
+static uint16_t UDP_Checksum16(void* UDPHeaderOutStart,
+                               const IP_Address_t* const SourceAddress,
+                               const IP_Address_t* const DestinationAddress,
+                               const uint16_t UDPOutSize,
+                               const uint32_t PayloadChecksum)
+{
+	uint32_t Checksum = PayloadChecksum;
+	
+	Checksum += ((uint16_t*)SourceAddress)[0];
+	Checksum += ((uint16_t*)SourceAddress)[1];
+	Checksum += ((uint16_t*)DestinationAddress)[0];
+	Checksum += ((uint16_t*)DestinationAddress)[1];
+	Checksum += SwapEndian_16(PROTOCOL_UDP);
+	Checksum += SwapEndian_16(UDPOutSize);
+
+	Checksum  = Ethernet_ChecksumFold16(Ethernet_ChecksumPartial(UDPHeaderOutStart, sizeof(UDP_Header_t), Checksum));
+
+	/* A computed checksum of zero is sent as all ones, as a zero checksum indicates that no checksum was calculated */
+	return (Checksum == 0) ? 0xFFFF : Checksum;
+}
+#endif
@@ -38,11 +38,14 @@
 
 	/* Includes: */
 		#include <avr/io.h>
+		#include <stdbool.h>
 	
 		#include "EthernetProtocols.h"
 		#include "Ethernet.h"
 		#include "ProtocolDecoders.h"
 		#include "DHCP.h"
+		#include "ARP.h"
+		#include "IP.h"
 	
 	/* Macros: */
 		/** Source UDP port for a DHCP request. */
@@ -51,6 +54,34 @@
 		/** Destination UDP port for a DHCP reply. */
 		#define UDP_PORT_DHCP_REPLY   68
 
+		#if !defined(MAX_OPEN_UDP_PORTS) || defined(__DOXYGEN__)
+			/** Maximum number of UDP ports which can be opened by applications at the one time. */
+			#define MAX_OPEN_UDP_PORTS    2
+		#endif
+
+		/** Table index value indicating no entry in the UDP port state table. */
+		#define UDP_NO_ENTRY          0xFF
+
+		/** Maximum number of data bytes which can be sent in a single UDP datagram. */
+		#define UDP_MAX_DATAGRAM_SIZE (ETHERNET_FRAME_SIZE_MAX - sizeof(Ethernet_Frame_Header_t) - sizeof(IP_Header_t) - \
+		                               sizeof(UDP_Header_t))
+
+		/** Retrieves a pointer to the start of the datagram data in an outgoing Ethernet frame, so that applications can write
+		 *  the data of a datagram directly into the frame before it is sent via \ref UDP_SendDatagram().
+		 *
+		 *  \param[in] FrameOUT  Pointer to the output Ethernet frame the datagram is to be sent in
+		 */
+		#define UDP_DATAGRAM_DATA(FrameOUT) ((void*)&(FrameOUT)->FrameData[sizeof(Ethernet_Frame_Header_t) + sizeof(IP_Header_t) + \
+		                                                           sizeof(UDP_Header_t)])
+
+	/* Enums: */
+		/** Enum for the possible states of an application UDP port. */
+		enum UDP_PortStates_t
+		{
+			UDP_Port_Closed       = 0, /**< UDP port closed, datagrams sent to this port are discarded */
+			UDP_Port_Open         = 1, /**< UDP port open, datagrams sent to this port are passed to the port's handler */
+		};
+
 	/* Type Defines: */
 		/** Type define for a UDP packet header. */
 		typedef struct
@@ -60,10 +91,52 @@
 			uint16_t Length; /**< Total packet length, in bytes */
 			uint16_t Checksum; /**< Optional UDP packet checksum */
 		} UDP_Header_t;
+
+		/** Type define for a received UDP datagram, passed to the handler of the datagram's destination port. */
+		typedef struct
+		{
+			IP_Address_t  RemoteAddress; /**< Protocol IP address of the host which sent the datagram */
+			uint16_t      RemotePort; /**< Port on the host the datagram was sent from, in big endian */
+			uint16_t      LocalPort; /**< Port on the device the datagram was sent to, in big endian */
+			uint16_t      Length; /**< Length of the datagram data, in bytes */
+			const void*   Data; /**< Pointer to the datagram data in the received frame */
+		} UDP_Datagram_t;
+
+		/** Type define for an application UDP port state. */
+		typedef struct
+		{
+			uint16_t      Port; /**< UDP port number on the device, in big endian */
+			uint8_t       State; /**< Current port state, a value from the UDP_PortStates_t enum */
+			int16_t       (*ApplicationHandler) (const UDP_Datagram_t* Datagram,
+			                                     void* ResponseData); /**< Port application handler */
+		} UDP_PortState_t;
 		
 	/* Function Prototypes: */
+		void    UDP_Init(void);
+		bool    UDP_SetPortState(const uint16_t Port,
+		                         const uint8_t State,
+		                         int16_t (*Handler)(const UDP_Datagram_t*, void*));
+		uint8_t UDP_GetPortState(const uint16_t Port);
+		bool    UDP_SendDatagram(Ethernet_Frame_Info_t* const FrameOUT,
+		                         const uint16_t LocalPort,
+		                         const IP_Address_t* const RemoteAddress,
+		                         const uint16_t RemotePort,
+		                         const uint16_t Length,
+		                         const uint32_t* const PayloadChecksum);
 		int16_t UDP_ProcessUDPPacket(void* IPHeaderInStart,
 		                             void* UDPHeaderInStart,
 		                             void* UDPHeaderOutStart);
 
+		#if defined(INCLUDE_FROM_UDP_C)
+			static uint8_t  UDP_FindPortEntry(const uint16_t Port);
+
+			#if !defined(NO_UDP_CHECKSUM)
+				static uint16_t UDP_Checksum16(void* UDPHeaderOutStart,
+				                               const IP_Address_t* const SourceAddress,
+				                               const IP_Address_t* const DestinationAddress,
+				                               const uint16_t UDPOutSize,
+				                               const uint32_t PayloadChecksum);
+			#endif
+		#endif
+
 #endif
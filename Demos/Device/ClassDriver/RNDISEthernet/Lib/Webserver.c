@@ -34,15 +34,17 @@
  *  application will serve up a static HTTP web page when requested by the host.
  */
 
+#define  INCLUDE_FROM_WEBSERVER_C
 #include "Webserver.h"
 
 /** HTTP server response header, for transmission before the page contents. This indicates to the host that a page exists at the
- *  given location, and gives extra connection information.
+ *  given location, and gives extra connection information. The content type and length of the requested file are appended to
+ *  the header before it is sent.
  */
 char PROGMEM HTTP200Header[] = "HTTP/1.1 200 OK\r\n"
                                "Server: LUFA RNDIS\r\n"
-                               "Content-type: text/html\r\n"
-                               "Connection: close\r\n\r\n";
+                               "Connection: close\r\n"
+                               "Content-Type: ";
 
 /** HTTP server response header, for transmission before a resource not found error. This indicates to the host that the given
  *  given URL is invalid, and gives extra error information.
@@ -51,27 +53,30 @@ char PROGMEM HTTP404Header[] = "HTTP/1.1 404 Not Found\r\n"
                                "Server: LUFA RNDIS\r\n"
                                "Connection: close\r\n\r\n";
 
-/** HTTP page to serve to the host when a HTTP request is made. This page is too long for a single response, thus it is automatically
- *  broken up into smaller blocks and sent as a series of packets each time the webserver application callback is run.
+/** HTTP server response header field, giving the length of the requested file which follows the response header. */
+char PROGMEM HTTPContentLengthField[] = "\r\nContent-Length: ";
+
+/** HTTP server response header terminator, marking the end of the header and the start of the file contents. */
+char PROGMEM HTTPHeaderEnd[] = "\r\n\r\n";
+
+/** Table of the HTTP response header templates, indexed by a value from the \ref Webserver_ResponseTemplates_t enum. The length
+ *  of each template is computed at compile time, so that responses can be assembled without rescanning the template strings.
  */
-char PROGMEM HTTPPage[]   = 
-		"<html>"
-		"	<head>"
-		"		<title>"
-		"			LUFA Webserver Demo"
-		"		</title>"
-		"	</head>"
-		"	<body>"
-		"		<h1>Hello from your USB AVR!</h1>"
-		"		<p>"
-		"			Hello! Welcome to the LUFA RNDIS Demo Webserver test page, running on your USB AVR via the LUFA library. This demonstrates the HTTP webserver, TCP/IP stack and RNDIS demo all running atop the LUFA USB stack."
-		"			<br /><br />"
-		"			<small>Project Information: <a href=\"http://www.fourwalledcubicle.com/LUFA.php\">http://www.fourwalledcubicle.com/LUFA.php</a>.</small>"
-		"			<hr />"
-		"			<i>LUFA Version: </i>" LUFA_VERSION_STRING
-		"		</p>"
-		"	</body>"
-		"</html>";
+Webserver_ResponseTemplate_t PROGMEM ResponseTemplates[] =
+	{
+		[HTTP_TEMPLATE_OK]             = HTTP_TEMPLATE(HTTP200Header),
+		[HTTP_TEMPLATE_NOT_FOUND]      = HTTP_TEMPLATE(HTTP404Header),
+		[HTTP_TEMPLATE_CONTENT_LENGTH] = HTTP_TEMPLATE(HTTPContentLengthField),
+		[HTTP_TEMPLATE_HEADER_END]     = HTTP_TEMPLATE(HTTPHeaderEnd),
+	};
+
+/** Table of the HTTP request methods recognised by the webserver, with the length of each method name computed at compile time. */
+Webserver_MethodEntry_t PROGMEM MethodTable[] =
+	{
+		HTTP_METHOD_ENTRY("GET",   HTTP_METHOD_GET),
+		HTTP_METHOD_ENTRY("HEAD",  HTTP_METHOD_HEAD),
+		HTTP_METHOD_ENTRY("TRACE", HTTP_METHOD_TRACE),
+	};
 
 
 /** Initialises the Webserver application, opening the appropriate HTTP port in the TCP handler and registering the application
@@ -83,22 +88,104 @@ void Webserver_Init(void)
 	TCP_SetPortState(TCP_PORT_HTTP, TCP_Port_Open, Webserver_ApplicationCallback);
 }
 
-/** Indicates if a given request equals the given HTTP command.
+/** Parses the request line of a HTTP request in a single pass, determining the request method and the location of the requested
+ *  path within the request. Method names are only compared against recognised methods of the same length.
+ *
+ *  \param[in] Buffer        Pointer to the application's receive buffer, containing the HTTP request made by the host
+ *  \param[out] RequestLine  Pointer to a request line structure where the parsed request method and path are to be stored
+ */
+static void Webserver_ParseRequestLine(TCP_ConnectionBuffer_t* const Buffer,
+                                       Webserver_RequestLine_t* const RequestLine)
+{
+	char*    BufferDataStr = (char*)Buffer->Data;
+	uint16_t Position      = 0;
+	
+	RequestLine->Method     = HTTP_METHOD_UNKNOWN;
+	RequestLine->PathStart  = 0;
+	RequestLine->PathLength = 0;
+
+	/* Find the end of the method name, which is terminated by a space */
+	while ((Position < Buffer->Length) && (BufferDataStr[Position] != ' '))
+	  Position++;
+	
+	/* Look up the method name in the method table, comparing only against methods with the same name length */
+	for (uint8_t MethodIndex = 0; MethodIndex < (sizeof(MethodTable) / sizeof(MethodTable[0])); MethodIndex++)
+	{
+		if ((pgm_read_byte(&MethodTable[MethodIndex].NameLength) == Position) &&
+		    (memcmp_P(BufferDataStr, MethodTable[MethodIndex].Name, Position) == 0))
+		{
+			RequestLine->Method = pgm_read_byte(&MethodTable[MethodIndex].Method);
+			break;
+		}
+	}
+
+	/* Unknown or incomplete requests have no path */
+	if ((RequestLine->Method == HTTP_METHOD_UNKNOWN) || (Position == Buffer->Length))
+	  return;
+
+	RequestLine->PathStart = ++Position;
+	
+	/* Find the end of the requested path, excluding any query string */
+	while (Position < Buffer->Length)
+	{
+		char CurrChar = BufferDataStr[Position];
+	
+		if ((CurrChar == ' ') || (CurrChar == '?') || (CurrChar == '\r'))
+		  break;
+
+		Position++;
+	}
+	
+	/* Paths too long to be stored in the request line structure cannot be the path of any file, so are truncated */
+	RequestLine->PathLength = (((Position - RequestLine->PathStart) > UINT8_MAX) ? UINT8_MAX : (Position - RequestLine->PathStart));
+}
+
+/** Copies a HTTP response header template into the given buffer.
  *
- *  \param[in] RequestHeader  HTTP request made by the host
- *  \param[in] Command        HTTP command to compare the request to
+ *  \param[out] BufferDataStr  Buffer to copy the response header template into
+ *  \param[in]  Template       Template to copy, a value from the \ref Webserver_ResponseTemplates_t enum
  *
- *  \return Boolean true if the command matches the request, false otherwise
+ *  \return Length of the copied template in bytes
  */
-static bool IsHTTPCommand(uint8_t* RequestHeader,
-                          char* Command)
+static uint16_t Webserver_CopyTemplate(char* BufferDataStr,
+                                       const uint8_t Template)
 {
-	/* Returns true if the non null terminated string in RequestHeader matches the null terminated string Command */
-	return (strncmp((char*)RequestHeader, Command, strlen(Command)) == 0);
+	uint16_t Length = pgm_read_word(&ResponseTemplates[Template].Length);
+	
+	memcpy_P(BufferDataStr, pgm_read_ptr(&ResponseTemplates[Template].Data), Length);
+	
+	return Length;
+}
+
+/** Writes the HTTP 200 response header for a file in the filesystem image into the given buffer, including the file's
+ *  content type and length.
+ *
+ *  \param[out] BufferDataStr  Buffer to write the response header into
+ *  \param[in]  FileIndex      Index of the file in the filesystem image that is to be sent to the host
+ *
+ *  \return Length of the response header in bytes
+ */
+static uint16_t Webserver_WriteResponseHeader(char* BufferDataStr,
+                                              const uint8_t FileIndex)
+{
+	uint16_t Length = 0;
+
+	Length += Webserver_CopyTemplate(&BufferDataStr[Length], HTTP_TEMPLATE_OK);
+	Length += ROMFS_CopyContentType(FileIndex, &BufferDataStr[Length]);
+	Length += Webserver_CopyTemplate(&BufferDataStr[Length], HTTP_TEMPLATE_CONTENT_LENGTH);
+	
+	/* Add the length of the file, taken from the filesystem image's lookup table */
+	utoa(ROMFS_GetFileLength(FileIndex), &BufferDataStr[Length], 10);
+	Length += strlen(&BufferDataStr[Length]);
+
+	Length += Webserver_CopyTemplate(&BufferDataStr[Length], HTTP_TEMPLATE_HEADER_END);
+	
+	return Length;
 }
 
 /** Application callback routine, executed each time the TCP processing task runs. This callback determines what request
- *  has been made (if any), and serves up appropriate responses.
+ *  has been made (if any), and serves up appropriate responses. The file being sent on each connection and the progress of
+ *  the transfer are held in the connection's application state, so that several connections may fetch files at once.
  *
  *  \param[in] ConnectionState  Pointer to a TCP Connection State structure giving connection information
  *  \param[in,out] Buffer       Pointer to the application's send/receive packet buffer
@@ -106,91 +193,90 @@ static bool IsHTTPCommand(uint8_t* RequestHeader,
 void Webserver_ApplicationCallback(TCP_ConnectionState_t* const ConnectionState,
                                    TCP_ConnectionBuffer_t* const Buffer)
 {
-	char*          BufferDataStr = (char*)Buffer->Data;
-	static uint8_t PageBlock     = 0;
+	char*                        BufferDataStr = (char*)Buffer->Data;
+	Webserver_ConnectionState_t* AppState      = TCP_APP_GET_STATE(ConnectionState, Webserver_ConnectionState_t);
 	
 	/* Check to see if a packet has been received on the HTTP port from a remote host */
 	if (TCP_APP_HAS_RECEIVED_PACKET(Buffer))
 	{
-		if (IsHTTPCommand(Buffer->Data, "GET"))
+		Webserver_RequestLine_t RequestLine;
+		
+		Webserver_ParseRequestLine(Buffer, &RequestLine);
+
+		switch (RequestLine.Method)
 		{
-			if (IsHTTPCommand(Buffer->Data, "GET / "))
+			case HTTP_METHOD_GET:
+			case HTTP_METHOD_HEAD:
 			{
-				PageBlock = 0;
-
-				/* Copy the HTTP 200 response header into the packet buffer */
-				strcpy_P(BufferDataStr, HTTP200Header);
+				uint8_t FileIndex = ROMFS_FindFile(&BufferDataStr[RequestLine.PathStart], RequestLine.PathLength);
 				
-				/* Send the buffer contents to the host */
-				TCP_APP_SEND_BUFFER(Buffer, strlen(BufferDataStr));
+				if (FileIndex != ROMFS_NO_FILE)
+				{
+					/* Write the HTTP 200 response header for the requested file into the packet buffer */
+					uint16_t Length = Webserver_WriteResponseHeader(BufferDataStr, FileIndex);
+					
+					AppState->FileIndex  = FileIndex;
+					AppState->FileOffset = 0;
+					
+					/* Fill the remainder of the packet buffer with the start of the file contents, unless only the header was requested */
+					if (RequestLine.Method == HTTP_METHOD_GET)
+					{
+						uint16_t BlockLength = ROMFS_ReadFile(FileIndex, 0, &Buffer->Data[Length], (HTTP_REPLY_BLOCK_SIZE - Length));
+						
+						AppState->FileOffset = BlockLength;
+						Length              += BlockLength;
+					}
+					
+					/* Send the buffer contents to the host */
+					TCP_APP_SEND_BUFFER(Buffer, Length);
+					
+					if ((RequestLine.Method == HTTP_METHOD_HEAD) || (AppState->FileOffset == ROMFS_GetFileLength(FileIndex)))
+					{
+						/* All data sent, close the connection */
+						TCP_APP_CLOSECONNECTION(ConnectionState);
+					}
+					else
+					{
+						/* Lock the buffer to Device->Host transmissions only while we send the remaining file contents */
+						TCP_APP_CAPTURE_BUFFER(Buffer);
+					}
+				}
+				else
+				{
+					/* Copy the HTTP 404 response header into the packet buffer and send it to the host */
+					TCP_APP_SEND_BUFFER(Buffer, Webserver_CopyTemplate(BufferDataStr, HTTP_TEMPLATE_NOT_FOUND));
+					
+					/* All data sent, close the connection */
+					TCP_APP_CLOSECONNECTION(ConnectionState);
+				}
 
-				/* Lock the buffer to Device->Host transmissions only while we send the page contents */
-				TCP_APP_CAPTURE_BUFFER(Buffer);
+				break;
 			}
-			else
-			{
-				/* Copy the HTTP 404 response header into the packet buffer */
-				strcpy_P(BufferDataStr, HTTP404Header);
-				
-				/* Send the buffer contents to the host */
-				TCP_APP_SEND_BUFFER(Buffer, strlen(BufferDataStr));
+			case HTTP_METHOD_TRACE:
+				/* Echo the host's query back to the host */
+				TCP_APP_SEND_BUFFER(Buffer, Buffer->Length);
 				
 				/* All data sent, close the connection */
 				TCP_APP_CLOSECONNECTION(ConnectionState);
-			}
-		}
-		else if (IsHTTPCommand(Buffer->Data, "HEAD"))
-		{
-			if (IsHTTPCommand(Buffer->Data, "HEAD / "))
-			{
-				/* Copy the HTTP response header into the packet buffer */
-				strcpy_P(BufferDataStr, HTTP200Header);
-
-				/* Send the buffer contents to the host */
-				TCP_APP_SEND_BUFFER(Buffer, strlen(BufferDataStr));
-			}
-			else
-			{
-				/* Copy the HTTP response header into the packet buffer */
-				strcpy_P(BufferDataStr, HTTP404Header);
-
-				/* Send the buffer contents to the host */
-				TCP_APP_SEND_BUFFER(Buffer, strlen(BufferDataStr));			
-			}
-			
-			/* All data sent, close the connection */
-			TCP_APP_CLOSECONNECTION(ConnectionState);
-		}
-		else if (IsHTTPCommand(Buffer->Data, "TRACE"))
-		{
-			/* Echo the host's query back to the host */
-			TCP_APP_SEND_BUFFER(Buffer, Buffer->Length);
-			
-			/* All data sent, close the connection */
-			TCP_APP_CLOSECONNECTION(ConnectionState);
-		}
-		else
-		{
-			/* Unknown request, just clear the buffer (drop the packet) */
-			TCP_APP_CLEAR_BUFFER(Buffer);
+				break;
+			default:
+				/* Unknown request, just clear the buffer (drop the packet) */
+				TCP_APP_CLEAR_BUFFER(Buffer);
+				break;
 		}
 	}
 	else if (TCP_APP_HAVE_CAPTURED_BUFFER(Buffer))
 	{
-		uint16_t RemLength = strlen_P(&HTTPPage[PageBlock * HTTP_REPLY_BLOCK_SIZE]);
-		uint16_t Length;
-	
-		/* Determine the length of the loaded block */
-		Length = ((RemLength > HTTP_REPLY_BLOCK_SIZE) ? HTTP_REPLY_BLOCK_SIZE : RemLength);
-
-		/* Copy the next buffer sized block of the page to the packet buffer */
-		strncpy_P(BufferDataStr, &HTTPPage[PageBlock * HTTP_REPLY_BLOCK_SIZE], Length);
+		/* Copy the next buffer sized block of the file to the packet buffer, continuing from where the last block ended */
+		uint16_t Length = ROMFS_ReadFile(AppState->FileIndex, AppState->FileOffset, Buffer->Data, HTTP_REPLY_BLOCK_SIZE);
 		
+		AppState->FileOffset += Length;
+
 		/* Send the buffer contents to the host */
 		TCP_APP_SEND_BUFFER(Buffer, Length);
 
-		/* Check to see if the entire page has been sent */
-		if (PageBlock++ == (sizeof(HTTPPage) / HTTP_REPLY_BLOCK_SIZE))
+		/* Check to see if the entire file has been sent */
+		if (AppState->FileOffset == ROMFS_GetFileLength(AppState->FileIndex))
 		{
 			/* Unlock the buffer so that the host can fill it with future packets */
 			TCP_APP_RELEASE_BUFFER(Buffer);
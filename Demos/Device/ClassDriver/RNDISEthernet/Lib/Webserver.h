@@ -39,18 +39,97 @@
 	/* Includes: */
 		#include <avr/io.h>
 		#include <avr/pgmspace.h>
+		#include <stdlib.h>
 		
 		#include <LUFA/Version.h>
 		
 		#include "TCP.h"
+		#include "ROMFileSystem.h"
 	
 	/* Macros: */
 		/** Maximum size of a HTTP response per transmission */
-		#define  HTTP_REPLY_BLOCK_SIZE     128
+		#define  HTTP_REPLY_BLOCK_SIZE     TCP_WINDOW_SIZE
+
+		/** Maximum length of a HTTP request method name recognised by the webserver, including the null terminator. */
+		#define  HTTP_MAX_METHOD_LENGTH    8
+		
+		/** Macro to create an entry in the webserver's response template table from a PROGMEM string array, with the length of
+		 *  the template computed at compile time.
+		 *
+		 *  \param[in] TemplateData  PROGMEM string array containing the response template
+		 */
+		#define  HTTP_TEMPLATE(TemplateData)          {.Data = TemplateData, .Length = (sizeof(TemplateData) - 1)}
+		
+		/** Macro to create an entry in the webserver's request method table, with the length of the method name computed at
+		 *  compile time.
+		 *
+		 *  \param[in] MethodName  String literal giving the method name as it appears in a HTTP request line
+		 *  \param[in] MethodID    Method identifier, a value from the \ref Webserver_HTTPMethods_t enum
+		 */
+		#define  HTTP_METHOD_ENTRY(MethodName, MethodID) {.Name = MethodName, .NameLength = (sizeof(MethodName) - 1), .Method = MethodID}
+	
+	/* Enums: */
+		/** Enum for the HTTP request methods recognised by the webserver. */
+		enum Webserver_HTTPMethods_t
+		{
+			HTTP_METHOD_UNKNOWN          = 0, /**< Unrecognised or malformed request */
+			HTTP_METHOD_GET              = 1, /**< Request for a file's header and contents */
+			HTTP_METHOD_HEAD             = 2, /**< Request for a file's header only */
+			HTTP_METHOD_TRACE            = 3, /**< Request for the host's request to be echoed back */
+		};
+		
+		/** Enum for the webserver's HTTP response header templates, used as indexes into the response template table. */
+		enum Webserver_ResponseTemplates_t
+		{
+			HTTP_TEMPLATE_OK             = 0, /**< HTTP 200 response header, up to the content type */
+			HTTP_TEMPLATE_NOT_FOUND      = 1, /**< Complete HTTP 404 response header */
+			HTTP_TEMPLATE_CONTENT_LENGTH = 2, /**< Content length header field name */
+			HTTP_TEMPLATE_HEADER_END     = 3, /**< Header terminator, following the last header field */
+		};
+	
+	/* Type Defines: */
+		/** Type define for the webserver's per-connection state, stored in the application state of each TCP connection. */
+		typedef struct
+		{
+			uint8_t  FileIndex; /**< Index of the file being sent to the host in the filesystem image */
+			uint16_t FileOffset; /**< Offset of the next block of the file to send to the host */
+		} Webserver_ConnectionState_t;
+
+		/** Type define for an entry in the webserver's HTTP response header template table, which is located in PROGMEM. */
+		typedef struct
+		{
+			const char* Data; /**< Pointer to the template string in PROGMEM */
+			uint16_t    Length; /**< Length of the template string, excluding the null terminator */
+		} Webserver_ResponseTemplate_t;
+
+		/** Type define for an entry in the webserver's HTTP request method table, which is located in PROGMEM. */
+		typedef struct
+		{
+			char     Name[HTTP_MAX_METHOD_LENGTH]; /**< Method name as it appears in a HTTP request line */
+			uint8_t  NameLength; /**< Length of the method name, excluding the null terminator */
+			uint8_t  Method; /**< Method identifier, a value from the \ref Webserver_HTTPMethods_t enum */
+		} Webserver_MethodEntry_t;
+
+		/** Type define for a parsed HTTP request line, giving the request method and the location of the requested path. */
+		typedef struct
+		{
+			uint8_t  Method; /**< Request method, a value from the \ref Webserver_HTTPMethods_t enum */
+			uint16_t PathStart; /**< Offset of the requested path from the start of the request */
+			uint8_t  PathLength; /**< Length of the requested path, excluding any query string */
+		} Webserver_RequestLine_t;
 	
 	/* Function Prototypes: */
 		void Webserver_Init(void);
 		void Webserver_ApplicationCallback(TCP_ConnectionState_t* const ConnectionState,
 		                                   TCP_ConnectionBuffer_t* const Buffer);
 
+		#if defined(INCLUDE_FROM_WEBSERVER_C)
+			static void     Webserver_ParseRequestLine(TCP_ConnectionBuffer_t* const Buffer,
+			                                           Webserver_RequestLine_t* const RequestLine);
+			static uint16_t Webserver_CopyTemplate(char* BufferDataStr,
+			                                       const uint8_t Template);
+			static uint16_t Webserver_WriteResponseHeader(char* BufferDataStr,
+			                                              const uint8_t FileIndex);
+		#endif
+
 #endif
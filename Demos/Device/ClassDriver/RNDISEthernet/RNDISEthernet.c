@@ -36,6 +36,20 @@
 
 #include "RNDISEthernet.h"
 
+#if (RNDIS_EXTRA_RX_FRAMES > 0)
+/** Additional frame buffers for the RNDIS interface's receive queue, so that new frames can be received from the host
+ *  while an earlier frame is being processed.
+ */
+static Ethernet_Frame_Info_t ExtraRXFrames[RNDIS_EXTRA_RX_FRAMES];
+#endif
+
+#if (RNDIS_EXTRA_TX_FRAMES > 0)
+/** Additional frame buffers for the RNDIS interface's transmit queue, so that new frames can be generated while an
+ *  earlier frame is being sent to the host.
+ */
+static Ethernet_Frame_Info_t ExtraTXFrames[RNDIS_EXTRA_TX_FRAMES];
+#endif
+
 /** LUFA RNDIS Class driver interface configuration and state information. This structure is
  *  passed to all RNDIS Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -60,6 +74,16 @@ USB_ClassInfo_RNDIS_Device_t Ethernet_RNDIS_Interface =
 				
 				.AdapterVendorDescription       = "LUFA RNDIS Demo Adapter",
 				.AdapterMACAddress              = {ADAPTER_MAC_ADDRESS},
+
+				#if (RNDIS_EXTRA_RX_FRAMES > 0)
+				.RXFrameQueue                   = ExtraRXFrames,
+				.RXFrameQueueSize               = RNDIS_EXTRA_RX_FRAMES,
+				#endif
+
+				#if (RNDIS_EXTRA_TX_FRAMES > 0)
+				.TXFrameQueue                   = ExtraTXFrames,
+				.TXFrameQueueSize               = RNDIS_EXTRA_TX_FRAMES,
+				#endif
 			},
 	};
 
@@ -71,22 +95,50 @@ int main(void)
 	SetupHardware();
 
 	TCP_Init();
+	UDP_Init();
 	Webserver_Init();
 
+	#if defined(ENABLE_PROTOCOL_TRACE)
+	ProtocolTrace_Init();
+	#endif
+
 	LEDs_SetAllLEDs(LEDMASK_USB_NOTREADY);
 	sei();
 
+	uint8_t TickCount = 0;
+
 	for (;;)
 	{
-		if (Ethernet_RNDIS_Interface.State.FrameIN.FrameInBuffer)
+		Ethernet_Frame_Info_t* FrameIN = RNDIS_Device_GetReceivedFrame(&Ethernet_RNDIS_Interface);
+
+		/* Responses are built in place over the received frame, so no transmit frame buffer is needed to process it */
+		if (FrameIN != NULL)
 		{
 			LEDs_SetAllLEDs(LEDMASK_USB_BUSY);
-			Ethernet_ProcessPacket(&Ethernet_RNDIS_Interface.State.FrameIN, &Ethernet_RNDIS_Interface.State.FrameOUT);
+			Ethernet_ProcessPacket(FrameIN);
 			LEDs_SetAllLEDs(LEDMASK_USB_READY);
 		}
 
+		/* Advance the TCP retransmission timers each time the tick timer period elapses, and age the ARP cache each second */
+		if (TIFR1 & (1 << OCF1A))
+		{
+			TIFR1 = (1 << OCF1A);
+			TCP_Tick();
+			PROTOCOL_TRACE_TICK();
+			
+			if (++TickCount == (1000 / TCP_TICK_INTERVAL_MS))
+			{
+				TickCount = 0;
+				ARP_Tick();
+			}
+		}
+
 		TCP_TCPTask(&Ethernet_RNDIS_Interface);
 
+		#if defined(ENABLE_PROTOCOL_TRACE)
+		ProtocolTrace_Task();
+		#endif
+
 		RNDIS_Device_USBTask(&Ethernet_RNDIS_Interface);
 		USB_USBTask();
 	}
@@ -106,6 +158,10 @@ void SetupHardware(void)
 	LEDs_Init();
 	SerialStream_Init(9600, false);
 	USB_Init();
+
+	/* Timer Initialization - compare flag set every TCP_TICK_INTERVAL_MS, polled in the main loop */
+	OCR1A  = (((F_CPU / 1024) * TCP_TICK_INTERVAL_MS) / 1000);
+	TCCR1B = ((1 << WGM12) | (1 << CS12) | (1 << CS10));
 }
 
 /** Event handler for the library USB Connection event. */
@@ -47,8 +47,10 @@
 
 		#include "Lib/Ethernet.h"
 		#include "Lib/TCP.h"
+		#include "Lib/UDP.h"
 		#include "Lib/ARP.h"
 		#include "Lib/Webserver.h"
+		#include "Lib/ProtocolTrace.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Board/LEDs.h>
@@ -71,6 +73,21 @@
 
 		/** LED mask for the library LED driver, to indicate that the USB interface is busy. */
 		#define LEDMASK_USB_BUSY          LEDS_LED2
+
+		#if !defined(RNDIS_EXTRA_RX_FRAMES) || defined(__DOXYGEN__)
+			/** Number of additional Ethernet frame buffers used to queue frames received from the host while an earlier
+			 *  frame is still being processed. Each frame buffer consumes around 1.5KB of SRAM, so the receive queue is
+			 *  disabled by default.
+			 */
+			#define RNDIS_EXTRA_RX_FRAMES  0
+		#endif
+
+		#if !defined(RNDIS_EXTRA_TX_FRAMES) || defined(__DOXYGEN__)
+			/** Number of additional Ethernet frame buffers used to queue frames to send to the host while an earlier
+			 *  frame is still being transmitted. Each frame buffer consumes around 1.5KB of SRAM.
+			 */
+			#define RNDIS_EXTRA_TX_FRAMES  0
+		#endif
 		
 	/* Function Prototypes: */
 		void SetupHardware(void);
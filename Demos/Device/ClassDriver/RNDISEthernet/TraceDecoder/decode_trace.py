@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+#
+#             LUFA Library
+#     Copyright (C) Dean Camera, 2010.
+#
+#  dean [at] fourwalledcubicle [dot] com
+#      www.fourwalledcubicle.com
+#
+
+# Host decoder for the binary protocol trace of the RNDISEthernet demo, sent
+# through the USART when ENABLE_PROTOCOL_TRACE is defined in the project
+# makefile. Reads the raw serial stream from the given file or serial device
+# (configured beforehand to the trace baud rate, e.g. with "stty -F /dev/ttyUSB0
+# 38400 raw"), or from standard input if no file is given, and prints one line
+# per record along with the time taken to process each received frame.
+#
+# Usage: decode_trace.py [--f-cpu HZ] [--tick-ms MS] [FILE]
+
+import argparse
+import struct
+import sys
+
+SYNC_BYTE   = 0xA5
+RECORD_SIZE = 9
+
+PROTOCOL_ETHERNET = 0
+PROTOCOL_TX       = 7
+PROTOCOL_DROPPED  = 8
+
+PROTOCOL_NAMES = ["ETHERNET", "ARP", "IP", "ICMP", "TCP", "UDP", "DHCP", "TX", "DROPPED"]
+
+def read_records(stream):
+    buffer = bytearray()
+
+    while True:
+        data = stream.read(256)
+        if not data:
+            return
+
+        buffer.extend(data)
+
+        while len(buffer) >= (RECORD_SIZE + 2):
+            # Resynchronize on the next sync byte whose record checksum is valid
+            if buffer[0] != SYNC_BYTE:
+                del buffer[0]
+                continue
+
+            record   = bytes(buffer[1 : RECORD_SIZE + 1])
+            checksum = 0
+            for byte in record:
+                checksum ^= byte
+
+            if checksum != buffer[RECORD_SIZE + 1]:
+                del buffer[0]
+                continue
+
+            del buffer[: RECORD_SIZE + 2]
+            yield struct.unpack("<HBBBHH", record)
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the RNDISEthernet demo binary protocol trace.")
+    parser.add_argument("--f-cpu", type=int, default=8000000, help="target CPU clock frequency in Hz")
+    parser.add_argument("--tick-ms", type=int, default=10, help="tick timer period in milliseconds")
+    parser.add_argument("file", nargs="?", help="trace file or serial device to read from")
+    args = parser.parse_args()
+
+    stream      = open(args.file, "rb") if args.file else getattr(sys.stdin, "buffer", sys.stdin)
+    subtick_ms  = (1024.0 * 1000) / args.f_cpu
+    tick_offset = 0
+    last_ticks  = None
+    frame_start = None
+
+    for (ticks, subticks, protocol, info, length, value) in read_records(stream):
+        # The tick count is 16 bits wide on the target, extend it across wraps
+        if (last_ticks is not None) and (ticks < last_ticks):
+            tick_offset += 0x10000
+        last_ticks = ticks
+
+        time_ms = ((tick_offset + ticks) * args.tick_ms) + (subticks * subtick_ms)
+        name    = PROTOCOL_NAMES[protocol] if protocol < len(PROTOCOL_NAMES) else ("UNKNOWN %u" % protocol)
+        line    = "%12.3f ms  %-8s info=0x%02X length=%-5u value=%u" % (time_ms, name, info, length, value)
+
+        if protocol == PROTOCOL_ETHERNET:
+            frame_start = time_ms
+        elif (protocol == PROTOCOL_TX) and (frame_start is not None):
+            line += "  (%.3f ms after last received frame)" % (time_ms - frame_start)
+        elif protocol == PROTOCOL_DROPPED:
+            frame_start = None
+
+        print(line)
+
+if __name__ == "__main__":
+    main()
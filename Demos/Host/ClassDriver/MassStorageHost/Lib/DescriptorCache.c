@@ -0,0 +1,200 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  EEPROM backed cache of attached device pipe configurations. When a device which has previously been enumerated
+ *  is re-attached, its pipes and the class driver state can be restored directly from the cache, skipping the
+ *  retrieval and parsing of the device's Configuration Descriptor.
+ *
+ *  Entries are keyed by the VID, PID and release number of the attached device, so that a firmware update in the
+ *  device (which may alter its descriptors) results in a cache miss.
+ */
+
+#define  INCLUDE_FROM_DESCRIPTORCACHE_C
+#include "DescriptorCache.h"
+
+/** Cached device pipe configurations, stored in EEPROM so that they are retained across power cycles. */
+DescriptorCache_Entry_t EEMEM DescriptorCacheEntries[DESCRIPTOR_CACHE_ENTRIES];
+
+/** Index of the next cache entry to replace when storing the configuration of a device not already in the cache. */
+uint8_t EEMEM DescriptorCacheNextEntry;
+
+/** Searches the cache for an entry matching the given device.
+ *
+ *  \param[in] DeviceDescriptor  Device Descriptor of the attached device.
+ *
+ *  \return Index of the matching cache entry, or -1 if the device is not cached.
+ */
+static int8_t DescriptorCache_FindEntry(const USB_Descriptor_Device_t* const DeviceDescriptor)
+{
+	for (uint8_t EntryIndex = 0; EntryIndex < DESCRIPTOR_CACHE_ENTRIES; EntryIndex++)
+	{
+		DescriptorCache_Entry_t* CurrEntry = &DescriptorCacheEntries[EntryIndex];
+
+		if ((eeprom_read_byte(&CurrEntry->Signature)     == DESCRIPTOR_CACHE_SIGNATURE)      &&
+		    (eeprom_read_word(&CurrEntry->VendorID)      == DeviceDescriptor->VendorID)      &&
+		    (eeprom_read_word(&CurrEntry->ProductID)     == DeviceDescriptor->ProductID)     &&
+		    (eeprom_read_word(&CurrEntry->ReleaseNumber) == DeviceDescriptor->ReleaseNumber))
+		{
+			return EntryIndex;
+		}
+	}
+
+	return -1;
+}
+
+/** Attempts to restore the pipe configuration and class driver state of an attached device from the cache.
+ *
+ *  \param[in]  DeviceDescriptor  Device Descriptor of the attached device.
+ *  \param[out] State             Pointer to the class driver's state structure, restored on a cache hit.
+ *  \param[in]  StateSize         Size of the class driver's state structure, in bytes.
+ *
+ *  \return Boolean true if the device's configuration was found in the cache and restored, false otherwise.
+ */
+bool DescriptorCache_RestoreConfiguration(const USB_Descriptor_Device_t* const DeviceDescriptor,
+                                          void* const State,
+                                          const uint8_t StateSize)
+{
+	DescriptorCache_Entry_t CachedEntry;
+	int8_t                  EntryIndex = DescriptorCache_FindEntry(DeviceDescriptor);
+
+	if (EntryIndex < 0)
+	  return false;
+
+	eeprom_read_block(&CachedEntry, &DescriptorCacheEntries[EntryIndex], sizeof(DescriptorCache_Entry_t));
+
+	/* Reject entries created by a build with a different class driver state layout */
+	if ((CachedEntry.StateSize != StateSize) || (CachedEntry.TotalPipes > DESCRIPTOR_CACHE_MAX_PIPES))
+	  return false;
+
+	for (uint8_t PipeIndex = 0; PipeIndex < CachedEntry.TotalPipes; PipeIndex++)
+	{
+		DescriptorCache_Pipe_t* CurrPipe = &CachedEntry.Pipes[PipeIndex];
+
+		Pipe_ConfigurePipe(CurrPipe->PipeNumber, CurrPipe->Type, CurrPipe->Token,
+		                   CurrPipe->EndpointNumber, CurrPipe->Size, CurrPipe->Banks);
+
+		if (!(Pipe_IsConfigured()))
+		  return false;
+
+		if (CurrPipe->Type == EP_TYPE_INTERRUPT)
+		  Pipe_SetInterruptPeriod(CurrPipe->InterruptPeriod);
+	}
+
+	memcpy(State, CachedEntry.State, StateSize);
+	return true;
+}
+
+/** Stores the current pipe configuration and class driver state of an attached device into the cache. This should
+ *  be called immediately after the class driver has successfully configured its pipes from the device's
+ *  Configuration Descriptor.
+ *
+ *  \param[in] DeviceDescriptor  Device Descriptor of the attached device.
+ *  \param[in] PipeMask          Mask of the pipe numbers used by the class driver, with bit N set for pipe N.
+ *  \param[in] State             Pointer to the class driver's state structure.
+ *  \param[in] StateSize         Size of the class driver's state structure, in bytes.
+ */
+void DescriptorCache_StoreConfiguration(const USB_Descriptor_Device_t* const DeviceDescriptor,
+                                        const uint8_t PipeMask,
+                                        const void* const State,
+                                        const uint8_t StateSize)
+{
+	DescriptorCache_Entry_t NewEntry;
+	int8_t                  EntryIndex = DescriptorCache_FindEntry(DeviceDescriptor);
+
+	if (StateSize > DESCRIPTOR_CACHE_MAX_STATE_SIZE)
+	  return;
+
+	memset(&NewEntry, 0x00, sizeof(DescriptorCache_Entry_t));
+
+	NewEntry.Signature     = DESCRIPTOR_CACHE_SIGNATURE;
+	NewEntry.VendorID      = DeviceDescriptor->VendorID;
+	NewEntry.ProductID     = DeviceDescriptor->ProductID;
+	NewEntry.ReleaseNumber = DeviceDescriptor->ReleaseNumber;
+	NewEntry.StateSize     = StateSize;
+	memcpy(NewEntry.State, State, StateSize);
+
+	uint8_t PrevSelectedPipe = Pipe_GetCurrentPipe();
+
+	/* Read back the configuration of each of the class driver's pipes from the USB controller */
+	for (uint8_t PipeNumber = 0; PipeNumber < PIPE_TOTAL_PIPES; PipeNumber++)
+	{
+		if (!(PipeMask & (1 << PipeNumber)))
+		  continue;
+
+		if (NewEntry.TotalPipes == DESCRIPTOR_CACHE_MAX_PIPES)
+		{
+			Pipe_SelectPipe(PrevSelectedPipe);
+			return;
+		}
+
+		DescriptorCache_Pipe_t* CurrPipe = &NewEntry.Pipes[NewEntry.TotalPipes++];
+
+		Pipe_SelectPipe(PipeNumber);
+
+		CurrPipe->PipeNumber      = PipeNumber;
+		CurrPipe->Type            = ((UPCFG0X >> EPTYPE0) & 0x03);
+		CurrPipe->Token           = Pipe_GetPipeToken();
+		CurrPipe->EndpointNumber  = Pipe_BoundEndpointNumber();
+		CurrPipe->Size            = (8 << ((UPCFG1X >> EPSIZE0) & 0x07));
+		CurrPipe->Banks           = (UPCFG1X & (0x03 << EPBK0));
+		CurrPipe->InterruptPeriod = UPCFG2X;
+	}
+
+	Pipe_SelectPipe(PrevSelectedPipe);
+
+	if (EntryIndex < 0)
+	{
+		EntryIndex = eeprom_read_byte(&DescriptorCacheNextEntry);
+
+		if (EntryIndex >= DESCRIPTOR_CACHE_ENTRIES)
+		  EntryIndex = 0;
+
+		eeprom_update_byte(&DescriptorCacheNextEntry, ((EntryIndex + 1) % DESCRIPTOR_CACHE_ENTRIES));
+	}
+
+	eeprom_update_block(&NewEntry, &DescriptorCacheEntries[EntryIndex], sizeof(DescriptorCache_Entry_t));
+}
+
+/** Removes an attached device from the cache, if present. This should be called if a device fails to operate
+ *  correctly after its configuration has been restored from the cache, so that its descriptors are re-parsed on
+ *  the next attachment.
+ *
+ *  \param[in] DeviceDescriptor  Device Descriptor of the attached device.
+ */
+void DescriptorCache_Invalidate(const USB_Descriptor_Device_t* const DeviceDescriptor)
+{
+	int8_t EntryIndex = DescriptorCache_FindEntry(DeviceDescriptor);
+
+	if (EntryIndex >= 0)
+	  eeprom_update_byte(&DescriptorCacheEntries[EntryIndex].Signature, 0xFF);
+}
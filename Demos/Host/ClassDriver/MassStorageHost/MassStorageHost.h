@@ -52,6 +52,8 @@
 		#include <LUFA/Drivers/USB/USB.h>
 		#include <LUFA/Drivers/USB/Class/MassStorage.h>
 		
+		#include "Lib/DescriptorCache.h"
+		
 	/* Macros: */
 		/** LED mask for the library LED driver, to indicate that the USB interface is not ready. */
 		#define LEDMASK_USB_NOTREADY      LEDS_LED1
@@ -70,6 +72,7 @@
 
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		bool ProcessConfigDescriptor(const USB_Descriptor_Device_t* const DeviceDescriptor);
 	
 		void EVENT_USB_Host_HostError(const uint8_t ErrorCode);
 		void EVENT_USB_Host_DeviceAttached(void);
@@ -0,0 +1,109 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for DescriptorCache.c.
+ */
+
+#ifndef _DESCRIPTOR_CACHE_H_
+#define _DESCRIPTOR_CACHE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/eeprom.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Macros: */
+		#if !defined(DESCRIPTOR_CACHE_ENTRIES) || defined(__DOXYGEN__)
+			/** Total number of attached devices whose pipe configurations are retained in EEPROM. Once all entries
+			 *  are in use, the oldest entry is replaced in a round-robin fashion.
+			 */
+			#define DESCRIPTOR_CACHE_ENTRIES       4
+		#endif
+
+		/** Maximum number of pipes which may be stored in a single cache entry. */
+		#define DESCRIPTOR_CACHE_MAX_PIPES         3
+
+		/** Maximum size in bytes of the class driver state structure which may be stored in a single cache entry. */
+		#define DESCRIPTOR_CACHE_MAX_STATE_SIZE    24
+
+		/** Signature value marking a valid cache entry in EEPROM. Erased EEPROM cells read as 0xFF, and so will
+		 *  never match.
+		 */
+		#define DESCRIPTOR_CACHE_SIGNATURE         0xDC
+
+	/* Type Defines: */
+		/** Type define for a single cached pipe configuration, containing the parameters needed to reconfigure
+		 *  the pipe via \c Pipe_ConfigurePipe() without re-parsing the device's Configuration Descriptor.
+		 */
+		typedef struct
+		{
+			uint8_t  PipeNumber; /**< Pipe number the configuration applies to. */
+			uint8_t  Type; /**< Pipe type, an EP_TYPE_* value. */
+			uint8_t  Token; /**< Pipe token, a PIPE_TOKEN_* mask. */
+			uint8_t  EndpointNumber; /**< Endpoint number within the attached device the pipe is bound to. */
+			uint16_t Size; /**< Size of the pipe bank, in bytes. */
+			uint8_t  Banks; /**< Number of pipe banks, a PIPE_BANK_* mask. */
+			uint8_t  InterruptPeriod; /**< Polling interval of the pipe in milliseconds, for interrupt pipes. */
+		} DescriptorCache_Pipe_t;
+
+		/** Type define for a single EEPROM cache entry, keyed by the attached device's VID, PID and release number. */
+		typedef struct
+		{
+			uint8_t  Signature; /**< Entry signature, \ref DESCRIPTOR_CACHE_SIGNATURE if the entry is valid. */
+			uint16_t VendorID; /**< Vendor ID of the cached device. */
+			uint16_t ProductID; /**< Product ID of the cached device. */
+			uint16_t ReleaseNumber; /**< Release number of the cached device. */
+			uint8_t  TotalPipes; /**< Number of valid pipe entries in the \c Pipes array. */
+			DescriptorCache_Pipe_t Pipes[DESCRIPTOR_CACHE_MAX_PIPES]; /**< Cached pipe configurations. */
+			uint8_t  StateSize; /**< Size of the stored class driver state, in bytes. */
+			uint8_t  State[DESCRIPTOR_CACHE_MAX_STATE_SIZE]; /**< Class driver state immediately after pipe configuration. */
+		} DescriptorCache_Entry_t;
+
+	/* Function Prototypes: */
+		bool DescriptorCache_RestoreConfiguration(const USB_Descriptor_Device_t* const DeviceDescriptor,
+		                                          void* const State,
+		                                          const uint8_t StateSize);
+		void DescriptorCache_StoreConfiguration(const USB_Descriptor_Device_t* const DeviceDescriptor,
+		                                        const uint8_t PipeMask,
+		                                        const void* const State,
+		                                        const uint8_t StateSize);
+		void DescriptorCache_Invalidate(const USB_Descriptor_Device_t* const DeviceDescriptor);
+
+		#if defined(INCLUDE_FROM_DESCRIPTORCACHE_C)
+			static int8_t DescriptorCache_FindEntry(const USB_Descriptor_Device_t* const DeviceDescriptor);
+		#endif
+
+#endif
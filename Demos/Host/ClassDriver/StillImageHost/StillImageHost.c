@@ -73,23 +73,25 @@ int main(void)
 		{
 			case HOST_STATE_Addressed:
 				LEDs_SetAllLEDs(LEDMASK_USB_ENUMERATING);
-			
-				uint16_t ConfigDescriptorSize;
-				uint8_t  ConfigDescriptorData[512];
+				
+				uint16_t ConfigStartFrame = USB_Host_GetFrameNumber();
 
-				if (USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
-				                                       sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful)
+				USB_Descriptor_Device_t DeviceDescriptor;
+				if (USB_Host_GetDeviceDescriptor(&DeviceDescriptor) != HOST_SENDCONTROL_Successful)
 				{
-					puts_P(PSTR("Error Retrieving Configuration Descriptor.\r\n"));
+					puts_P(PSTR("Error Retrieving Device Descriptor.\r\n"));
 					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
 					break;
 				}
 
-				if (SImage_Host_ConfigurePipes(&DigitalCamera_SI_Interface,
-				                               ConfigDescriptorSize, ConfigDescriptorData) != SI_ENUMERROR_NoError)
+				if (DescriptorCache_RestoreConfiguration(&DeviceDescriptor, &DigitalCamera_SI_Interface.State,
+				                                         sizeof(DigitalCamera_SI_Interface.State)))
+				{
+					puts_P(PSTR("Configuration Restored From Cache.\r\n"));
+				}
+				else if (!(ProcessConfigDescriptor(&DeviceDescriptor)))
 				{
-					puts_P(PSTR("Attached Device Not a Valid Still Image Class Device.\r\n"));
 					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
 					break;
@@ -98,11 +100,14 @@ int main(void)
 				if (USB_Host_SetDeviceConfiguration(1) != HOST_SENDCONTROL_Successful)
 				{
 					puts_P(PSTR("Error Setting Device Configuration.\r\n"));
+					DescriptorCache_Invalidate(&DeviceDescriptor);
 					LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
 					break;
 				}
 				
+				printf_P(PSTR("Configured in %u ms.\r\n"), ((USB_Host_GetFrameNumber() - ConfigStartFrame) & 0x07FF));
+				
 				puts_P(PSTR("Still Image Device Enumerated.\r\n"));
 				LEDs_SetAllLEDs(LEDMASK_USB_READY);
 				USB_HostState = HOST_STATE_Configured;
@@ -164,6 +169,40 @@ void SetupHardware(void)
 	USB_Init();
 }
 
+/** Retrieves and processes the attached device's Configuration Descriptor, configuring the Still Image class
+ *  driver's pipes and storing the resulting configuration into the descriptor cache for the next attachment.
+ *
+ *  \param[in] DeviceDescriptor  Device Descriptor of the attached device, used as the descriptor cache key.
+ *
+ *  \return Boolean true if the device was successfully configured, false otherwise.
+ */
+bool ProcessConfigDescriptor(const USB_Descriptor_Device_t* const DeviceDescriptor)
+{
+	uint16_t ConfigDescriptorSize;
+	uint8_t  ConfigDescriptorData[512];
+
+	if (USB_Host_GetDeviceConfigDescriptor(1, &ConfigDescriptorSize, ConfigDescriptorData,
+	                                       sizeof(ConfigDescriptorData)) != HOST_GETCONFIG_Successful)
+	{
+		puts_P(PSTR("Error Retrieving Configuration Descriptor.\r\n"));
+		return false;
+	}
+
+	if (SImage_Host_ConfigurePipes(&DigitalCamera_SI_Interface,
+	                               ConfigDescriptorSize, ConfigDescriptorData) != SI_ENUMERROR_NoError)
+	{
+		puts_P(PSTR("Attached Device Not a Valid Still Image Class Device.\r\n"));
+		return false;
+	}
+
+	DescriptorCache_StoreConfiguration(DeviceDescriptor,
+	                                   ((1 << DigitalCamera_SI_Interface.Config.DataINPipeNumber)  |
+	                                    (1 << DigitalCamera_SI_Interface.Config.DataOUTPipeNumber) |
+	                                    (1 << DigitalCamera_SI_Interface.Config.EventsPipeNumber)),
+	                                   &DigitalCamera_SI_Interface.State, sizeof(DigitalCamera_SI_Interface.State));
+	return true;
+}
+
 /** Event handler for the USB_DeviceAttached event. This indicates that a device has been attached to the host, and
  *  starts the library USB task to begin the enumeration and USB management process.
  */
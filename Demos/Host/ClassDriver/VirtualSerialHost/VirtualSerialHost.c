@@ -108,12 +108,13 @@ int main(void)
 				USB_HostState = HOST_STATE_Configured;
 				break;
 			case HOST_STATE_Configured:
-				if (CDC_Host_BytesReceived(&VirtualSerial_CDC_Interface))
 				{
 					/* Echo received bytes from the attached device through the USART */
-					int16_t ReceivedByte = CDC_Host_ReceiveByte(&VirtualSerial_CDC_Interface);
-					if (!(ReceivedByte < 0))
-					  putchar(ReceivedByte);
+					uint8_t  ReceivedData[16];
+					uint16_t BytesRead = CDC_Host_ReadData(&VirtualSerial_CDC_Interface, ReceivedData, sizeof(ReceivedData));
+
+					for (uint16_t ByteIndex = 0; ByteIndex < BytesRead; ByteIndex++)
+					  putchar(ReceivedData[ByteIndex]);
 				}
 			
 				break;
@@ -0,0 +1,452 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Minimal read-only FAT12/16/32 filesystem reader, layered on top of the sector cache. The volume's FAT
+ *  sectors are always accessed through the cache, so that following a file's cluster chain only results in
+ *  a device access when the chain crosses into a FAT sector which is not already cached. Whole sectors of
+ *  file data are read directly from the device into the caller's buffer in as few commands as possible,
+ *  bypassing the cache so that the cached FAT and directory sectors are not evicted when streaming files.
+ *
+ *  Only 8.3 filenames are supported, long filename entries are skipped when reading directories.
+ */
+
+#define  INCLUDE_FROM_FATREADER_C
+#include "FATReader.h"
+
+/** Layout information of the currently mounted FAT volume. */
+static FAT_Volume_t FAT_Volume;
+
+
+/** Reads a 16-bit little-endian value from the given location in a sector buffer.
+ *
+ *  \param[in] Data  Pointer to the first byte of the value
+ *
+ *  \return 16-bit value read from the buffer
+ */
+static inline uint16_t FAT_GetLE16(const uint8_t* const Data)
+{
+	return ((uint16_t)Data[1] << 8) | Data[0];
+}
+
+/** Reads a 32-bit little-endian value from the given location in a sector buffer.
+ *
+ *  \param[in] Data  Pointer to the first byte of the value
+ *
+ *  \return 32-bit value read from the buffer
+ */
+static inline uint32_t FAT_GetLE32(const uint8_t* const Data)
+{
+	return ((uint32_t)FAT_GetLE16(&Data[2]) << 16) | FAT_GetLE16(&Data[0]);
+}
+
+/** Locates and mounts the FAT volume on the attached device, either directly in the first sector or in the
+ *  first partition of a partitioned device. \ref SectorCache_Init() must have been called beforehand.
+ *
+ *  \return Zero on success, FAT_ERROR_NO_FILESYSTEM if no supported volume was found, or a sector cache error code
+ */
+uint8_t FAT_Mount(void)
+{
+	uint8_t* Sector;
+	uint32_t VolumeStart = 0;
+	uint8_t  ErrorCode;
+
+	FAT_Volume.FATType = 0;
+
+	if ((ErrorCode = SectorCache_GetSector(VolumeStart, false, &Sector)) != 0)
+	  return ErrorCode;
+
+	if (FAT_GetLE16(&Sector[510]) != 0xAA55)
+	  return FAT_ERROR_NO_FILESYSTEM;
+
+	/* Sector zero holds a partition table rather than a volume boot sector if it lacks a boot jump instruction */
+	if ((Sector[0] != 0xEB) && (Sector[0] != 0xE9))
+	{
+		VolumeStart = FAT_GetLE32(&Sector[0x1BE + 8]);
+
+		if ((ErrorCode = SectorCache_GetSector(VolumeStart, false, &Sector)) != 0)
+		  return ErrorCode;
+
+		if (FAT_GetLE16(&Sector[510]) != 0xAA55)
+		  return FAT_ERROR_NO_FILESYSTEM;
+	}
+
+	uint8_t  SectorsPerCluster = Sector[13];
+	uint16_t ReservedSectors   = FAT_GetLE16(&Sector[14]);
+	uint8_t  TotalFATs         = Sector[16];
+	uint16_t RootEntries       = FAT_GetLE16(&Sector[17]);
+	uint32_t TotalSectors      = FAT_GetLE16(&Sector[19]);
+	uint32_t FATSectors        = FAT_GetLE16(&Sector[22]);
+
+	if (!(TotalSectors))
+	  TotalSectors = FAT_GetLE32(&Sector[32]);
+
+	if (!(FATSectors))
+	  FATSectors = FAT_GetLE32(&Sector[36]);
+
+	/* Only volumes with sectors matching the cache sector size and a valid power-of-two cluster size are supported */
+	if ((FAT_GetLE16(&Sector[11]) != SECTOR_CACHE_SECTOR_SIZE) || !(SectorsPerCluster) ||
+	    (SectorsPerCluster & (SectorsPerCluster - 1)) || !(TotalFATs) || !(FATSectors))
+	{
+		return FAT_ERROR_NO_FILESYSTEM;
+	}
+
+	FAT_Volume.SectorsPerCluster  = SectorsPerCluster;
+	FAT_Volume.RootDirSectors     = ((RootEntries * 32) + (SECTOR_CACHE_SECTOR_SIZE - 1)) / SECTOR_CACHE_SECTOR_SIZE;
+	FAT_Volume.FATStartSector     = VolumeStart + ReservedSectors;
+	FAT_Volume.RootDirStartSector = FAT_Volume.FATStartSector + (TotalFATs * FATSectors);
+	FAT_Volume.DataStartSector    = FAT_Volume.RootDirStartSector + FAT_Volume.RootDirSectors;
+	FAT_Volume.RootCluster        = FAT_GetLE32(&Sector[44]);
+
+	if ((FAT_Volume.DataStartSector - VolumeStart) >= TotalSectors)
+	  return FAT_ERROR_NO_FILESYSTEM;
+
+	FAT_Volume.TotalClusters = (TotalSectors - (FAT_Volume.DataStartSector - VolumeStart)) / SectorsPerCluster;
+
+	/* FAT type is determined solely by the number of clusters in the volume, as per the FAT specification */
+	if (FAT_Volume.TotalClusters < 4085)
+	  FAT_Volume.FATType = FAT_TYPE_FAT12;
+	else if (FAT_Volume.TotalClusters < 65525)
+	  FAT_Volume.FATType = FAT_TYPE_FAT16;
+	else
+	  FAT_Volume.FATType = FAT_TYPE_FAT32;
+
+	return 0;
+}
+
+/** Retrieves the type of the currently mounted FAT volume.
+ *
+ *  \return A value from the \ref FAT_Types_t enum, or zero if no volume is mounted
+ */
+uint8_t FAT_GetType(void)
+{
+	return FAT_Volume.FATType;
+}
+
+/** Opens the root directory of the mounted volume, ready for its entries to be read via \ref FAT_ReadDirectory().
+ *
+ *  \param[out] Directory  Pointer to a file structure to open as the root directory
+ */
+void FAT_OpenRootDirectory(FAT_File_t* const Directory)
+{
+	memset(Directory, 0, sizeof(FAT_File_t));
+
+	Directory->Attributes = FAT_ATTRIBUTE_DIRECTORY;
+
+	/* FAT12 and FAT16 volumes use a fixed root directory region, indicated by a first cluster of zero */
+	if (FAT_Volume.FATType == FAT_TYPE_FAT32)
+	  Directory->FirstCluster = FAT_Volume.RootCluster;
+
+	FAT_RewindFile(Directory);
+}
+
+/** Reads the next file or subdirectory entry from an open directory, skipping deleted entries, long filename
+ *  entries and the volume label. The returned entry is opened ready for reading via \ref FAT_ReadFile().
+ *
+ *  \param[in,out] Directory  Pointer to the open directory to read from
+ *  \param[out] File          Pointer to a file structure to open as the next directory entry
+ *
+ *  \return Zero on success, FAT_ERROR_END_OF_DIRECTORY if no more entries exist, or a sector cache error code
+ */
+uint8_t FAT_ReadDirectory(FAT_File_t* const Directory,
+                          FAT_File_t* const File)
+{
+	for (;;)
+	{
+		uint8_t* Sector;
+		uint32_t SectorAddress;
+		uint8_t  ErrorCode;
+
+		if ((ErrorCode = FAT_SeekNextSector(Directory, &SectorAddress)) != 0)
+		  return (ErrorCode == FAT_ERROR_END_OF_CHAIN) ? FAT_ERROR_END_OF_DIRECTORY : ErrorCode;
+
+		/* Directory sectors are read through the cache, as they are typically accessed repeatedly */
+		if ((ErrorCode = SectorCache_GetSector(SectorAddress, false, &Sector)) != 0)
+		  return ErrorCode;
+
+		uint8_t* Entry = &Sector[Directory->ByteInSector];
+
+		Directory->ByteInSector += 32;
+		Directory->Position     += 32;
+
+		if (Directory->ByteInSector == SECTOR_CACHE_SECTOR_SIZE)
+		{
+			Directory->ByteInSector = 0;
+			Directory->SectorInCluster++;
+		}
+
+		/* A zero first name byte indicates that no further entries follow in the directory */
+		if (Entry[0] == 0x00)
+		  return FAT_ERROR_END_OF_DIRECTORY;
+
+		if ((Entry[0] == 0xE5) || ((Entry[11] & FAT_ATTRIBUTE_LONG_NAME) == FAT_ATTRIBUTE_LONG_NAME) ||
+		    (Entry[11] & FAT_ATTRIBUTE_VOLUME_ID))
+		{
+			continue;
+		}
+
+		memcpy(File->Name, Entry, sizeof(File->Name));
+		File->Attributes   = Entry[11];
+		File->FileSize     = (Entry[11] & FAT_ATTRIBUTE_DIRECTORY) ? 0 : FAT_GetLE32(&Entry[28]);
+		File->FirstCluster = FAT_GetLE16(&Entry[26]);
+
+		if (FAT_Volume.FATType == FAT_TYPE_FAT32)
+		  File->FirstCluster |= ((uint32_t)FAT_GetLE16(&Entry[20]) << 16);
+
+		FAT_RewindFile(File);
+		return 0;
+	}
+}
+
+/** Reads data from the current position of an open file, advancing the file position. Data is read through
+ *  the sector cache for partial sectors, and directly from the device in multiple sector reads for whole
+ *  sectors, with the file's cluster chain followed as needed.
+ *
+ *  \param[in,out] File    Pointer to the open file to read from
+ *  \param[out] Buffer     Pointer to the buffer where the read data is to be written to
+ *  \param[in] Length      Maximum number of bytes to read from the file
+ *  \param[out] BytesRead  Pointer to a location where the number of bytes actually read is to be stored
+ *
+ *  \return Zero on success or end of file, or a sector cache error code
+ */
+uint8_t FAT_ReadFile(FAT_File_t* const File,
+                     void* Buffer,
+                     const uint16_t Length,
+                     uint16_t* const BytesRead)
+{
+	uint8_t* BufferPtr = (uint8_t*)Buffer;
+	uint16_t BytesRem  = Length;
+	uint8_t  ErrorCode = 0;
+
+	if ((File->FileSize - File->Position) < BytesRem)
+	  BytesRem = (File->FileSize - File->Position);
+
+	*BytesRead = 0;
+
+	while (BytesRem)
+	{
+		uint32_t SectorAddress;
+
+		if ((ErrorCode = FAT_SeekNextSector(File, &SectorAddress)) != 0)
+		  break;
+
+		uint16_t BytesInChunk;
+
+		if (!(File->ByteInSector) && (BytesRem >= SECTOR_CACHE_SECTOR_SIZE))
+		{
+			/* Read as many whole sectors as possible from the current cluster directly into the caller's buffer */
+			uint16_t Sectors = (FAT_GetClusterSectors(File) - File->SectorInCluster);
+
+			if ((BytesRem / SECTOR_CACHE_SECTOR_SIZE) < Sectors)
+			  Sectors = (BytesRem / SECTOR_CACHE_SECTOR_SIZE);
+
+			if (Sectors > 0xFF)
+			  Sectors = 0xFF;
+
+			if ((ErrorCode = SectorCache_ReadSectors(SectorAddress, Sectors, BufferPtr)) != 0)
+			  break;
+
+			BytesInChunk = (Sectors * SECTOR_CACHE_SECTOR_SIZE);
+			File->SectorInCluster += Sectors;
+		}
+		else
+		{
+			uint8_t* Sector;
+
+			if ((ErrorCode = SectorCache_GetSector(SectorAddress, false, &Sector)) != 0)
+			  break;
+
+			BytesInChunk = (SECTOR_CACHE_SECTOR_SIZE - File->ByteInSector);
+
+			if (BytesRem < BytesInChunk)
+			  BytesInChunk = BytesRem;
+
+			memcpy(BufferPtr, &Sector[File->ByteInSector], BytesInChunk);
+
+			File->ByteInSector += BytesInChunk;
+
+			if (File->ByteInSector == SECTOR_CACHE_SECTOR_SIZE)
+			{
+				File->ByteInSector = 0;
+				File->SectorInCluster++;
+			}
+		}
+
+		BufferPtr      += BytesInChunk;
+		BytesRem       -= BytesInChunk;
+		File->Position += BytesInChunk;
+		*BytesRead     += BytesInChunk;
+	}
+
+	return (ErrorCode == FAT_ERROR_END_OF_CHAIN) ? 0 : ErrorCode;
+}
+
+/** Resets the read position of the given file back to the start of its first cluster.
+ *
+ *  \param[in,out] File  Pointer to the file to rewind
+ */
+static void FAT_RewindFile(FAT_File_t* const File)
+{
+	File->CurrentCluster  = File->FirstCluster;
+	File->SectorInCluster = 0;
+	File->ByteInSector    = 0;
+	File->Position        = 0;
+}
+
+/** Retrieves the number of sectors in the given file's current cluster. The fixed FAT12/16 root directory
+ *  region is treated as a single cluster spanning the entire region.
+ *
+ *  \param[in] File  Pointer to the file whose current cluster size is to be retrieved
+ *
+ *  \return Number of sectors in the file's current cluster
+ */
+static uint16_t FAT_GetClusterSectors(const FAT_File_t* const File)
+{
+	return (File->CurrentCluster) ? FAT_Volume.SectorsPerCluster : FAT_Volume.RootDirSectors;
+}
+
+/** Looks up the cluster following the given cluster in the volume's FAT. FAT sectors are accessed through
+ *  the sector cache, so consecutive lookups within the same FAT sector do not require a device access.
+ *
+ *  \param[in] Cluster       Cluster whose successor is to be retrieved
+ *  \param[out] NextCluster  Pointer to a location where the following cluster is to be stored
+ *
+ *  \return Zero on success, FAT_ERROR_END_OF_CHAIN if the given cluster is the last in its chain, or a sector cache error code
+ */
+static uint8_t FAT_GetNextCluster(const uint32_t Cluster,
+                                  uint32_t* const NextCluster)
+{
+	uint8_t* Sector;
+	uint32_t FATOffset;
+	uint32_t EndOfChainMarker;
+	uint8_t  ErrorCode;
+
+	switch (FAT_Volume.FATType)
+	{
+		case FAT_TYPE_FAT12:
+			FATOffset        = (Cluster + (Cluster >> 1));
+			EndOfChainMarker = 0x00000FF8;
+			break;
+		case FAT_TYPE_FAT16:
+			FATOffset        = (Cluster << 1);
+			EndOfChainMarker = 0x0000FFF8;
+			break;
+		default:
+			FATOffset        = (Cluster << 2);
+			EndOfChainMarker = 0x0FFFFFF8;
+			break;
+	}
+
+	uint32_t SectorAddress = FAT_Volume.FATStartSector + (FATOffset / SECTOR_CACHE_SECTOR_SIZE);
+	uint16_t SectorOffset  = (FATOffset % SECTOR_CACHE_SECTOR_SIZE);
+
+	if ((ErrorCode = SectorCache_GetSector(SectorAddress, false, &Sector)) != 0)
+	  return ErrorCode;
+
+	if (FAT_Volume.FATType == FAT_TYPE_FAT12)
+	{
+		uint16_t Entry = Sector[SectorOffset];
+
+		/* FAT12 entries may straddle two FAT sectors, in which case the high byte is in the following sector */
+		if (SectorOffset == (SECTOR_CACHE_SECTOR_SIZE - 1))
+		{
+			if ((ErrorCode = SectorCache_GetSector(SectorAddress + 1, false, &Sector)) != 0)
+			  return ErrorCode;
+
+			Entry |= ((uint16_t)Sector[0] << 8);
+		}
+		else
+		{
+			Entry |= ((uint16_t)Sector[SectorOffset + 1] << 8);
+		}
+
+		*NextCluster = (Cluster & 0x01) ? (Entry >> 4) : (Entry & 0x0FFF);
+	}
+	else if (FAT_Volume.FATType == FAT_TYPE_FAT16)
+	{
+		*NextCluster = FAT_GetLE16(&Sector[SectorOffset]);
+	}
+	else
+	{
+		*NextCluster = (FAT_GetLE32(&Sector[SectorOffset]) & 0x0FFFFFFF);
+	}
+
+	if ((*NextCluster < 2) || (*NextCluster >= EndOfChainMarker))
+	  return FAT_ERROR_END_OF_CHAIN;
+
+	return 0;
+}
+
+/** Determines the device sector address of the given file's current read position, following the file's
+ *  cluster chain into the next cluster if the end of the current cluster has been reached.
+ *
+ *  \param[in,out] File       Pointer to the file whose current sector is to be determined
+ *  \param[out] SectorAddress  Pointer to a location where the device sector address is to be stored
+ *
+ *  \return Zero on success, FAT_ERROR_END_OF_CHAIN if the end of the file's data was reached, or a sector cache error code
+ */
+static uint8_t FAT_SeekNextSector(FAT_File_t* const File,
+                                  uint32_t* const SectorAddress)
+{
+	uint8_t ErrorCode;
+
+	if (File->SectorInCluster == FAT_GetClusterSectors(File))
+	{
+		/* The fixed root directory region has no following cluster */
+		if (!(File->CurrentCluster))
+		  return FAT_ERROR_END_OF_CHAIN;
+
+		uint32_t NextCluster;
+
+		if ((ErrorCode = FAT_GetNextCluster(File->CurrentCluster, &NextCluster)) != 0)
+		  return ErrorCode;
+
+		File->CurrentCluster  = NextCluster;
+		File->SectorInCluster = 0;
+	}
+
+	if (!(File->CurrentCluster))
+	{
+		/* Zero length files have no allocated clusters, and the fixed root directory is addressed directly */
+		if (!(File->Attributes & FAT_ATTRIBUTE_DIRECTORY) || (File->FirstCluster))
+		  return FAT_ERROR_END_OF_CHAIN;
+
+		*SectorAddress = FAT_Volume.RootDirStartSector + File->SectorInCluster;
+	}
+	else
+	{
+		*SectorAddress = FAT_Volume.DataStartSector +
+		                 ((File->CurrentCluster - 2) * FAT_Volume.SectorsPerCluster) + File->SectorInCluster;
+	}
+
+	return 0;
+}
@@ -0,0 +1,136 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for FATReader.c.
+ */
+
+#ifndef _FAT_READER_H_
+#define _FAT_READER_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "SectorCache.h"
+
+	/* Macros: */
+		/** Additional error code for the FAT reader functions, indicating that no supported FAT filesystem was found. */
+		#define FAT_ERROR_NO_FILESYSTEM         0xC2
+
+		/** Additional error code for \ref FAT_ReadDirectory(), indicating that there are no more directory entries. */
+		#define FAT_ERROR_END_OF_DIRECTORY      0xC3
+
+		/** Additional error code for the FAT reader functions, indicating that the end of a file's cluster chain was reached. */
+		#define FAT_ERROR_END_OF_CHAIN          0xC4
+
+		/** Directory entry attribute mask, indicating that the entry is a read-only file. */
+		#define FAT_ATTRIBUTE_READ_ONLY         (1 << 0)
+
+		/** Directory entry attribute mask, indicating that the entry is a hidden file. */
+		#define FAT_ATTRIBUTE_HIDDEN            (1 << 1)
+
+		/** Directory entry attribute mask, indicating that the entry is a system file. */
+		#define FAT_ATTRIBUTE_SYSTEM            (1 << 2)
+
+		/** Directory entry attribute mask, indicating that the entry is the volume label. */
+		#define FAT_ATTRIBUTE_VOLUME_ID         (1 << 3)
+
+		/** Directory entry attribute mask, indicating that the entry is a subdirectory. */
+		#define FAT_ATTRIBUTE_DIRECTORY         (1 << 4)
+
+		/** Directory entry attribute mask, indicating that the entry has been modified since it was last archived. */
+		#define FAT_ATTRIBUTE_ARCHIVE           (1 << 5)
+
+		/** Directory entry attribute value, indicating that the entry is part of a long filename. */
+		#define FAT_ATTRIBUTE_LONG_NAME         0x0F
+
+	/* Enums: */
+		/** Enum for the possible FAT filesystem variants, as determined by the volume's total cluster count. */
+		enum FAT_Types_t
+		{
+			FAT_TYPE_FAT12 = 12, /**< Volume uses 12-bit FAT entries */
+			FAT_TYPE_FAT16 = 16, /**< Volume uses 16-bit FAT entries */
+			FAT_TYPE_FAT32 = 32, /**< Volume uses 32-bit FAT entries */
+		};
+
+	/* Type defines: */
+		/** Type define for the layout information of the currently mounted FAT volume. */
+		typedef struct
+		{
+			uint8_t  FATType; /**< Type of the mounted FAT volume, a value from the \ref FAT_Types_t enum */
+			uint8_t  SectorsPerCluster; /**< Number of sectors in each data cluster */
+			uint16_t RootDirSectors; /**< Number of sectors in the fixed root directory region (FAT12/16 only) */
+			uint32_t FATStartSector; /**< Device sector address of the first sector of the first FAT */
+			uint32_t RootDirStartSector; /**< Device sector address of the fixed root directory region (FAT12/16 only) */
+			uint32_t DataStartSector; /**< Device sector address of the first sector of cluster 2 */
+			uint32_t RootCluster; /**< First cluster of the root directory (FAT32 only) */
+			uint32_t TotalClusters; /**< Total number of data clusters in the volume */
+		} FAT_Volume_t;
+
+		/** Type define for an open file or directory on the mounted FAT volume. */
+		typedef struct
+		{
+			char     Name[11]; /**< Space padded 8.3 name of the file, without the dot separator */
+			uint8_t  Attributes; /**< Attributes of the file, a mask of FAT_ATTRIBUTE_* masks */
+			uint32_t FileSize; /**< Size of the file in bytes, zero for directories */
+			uint32_t FirstCluster; /**< First cluster of the file, or zero for the fixed FAT12/16 root directory */
+			uint32_t CurrentCluster; /**< Cluster the next read will take place from */
+			uint16_t SectorInCluster; /**< Sector within the current cluster the next read will take place from */
+			uint16_t ByteInSector; /**< Byte within the current sector the next read will take place from */
+			uint32_t Position; /**< Current read position within the file, in bytes */
+		} FAT_File_t;
+
+	/* Function Prototypes: */
+		uint8_t FAT_Mount(void);
+		uint8_t FAT_GetType(void);
+		void    FAT_OpenRootDirectory(FAT_File_t* const Directory);
+		uint8_t FAT_ReadDirectory(FAT_File_t* const Directory,
+		                          FAT_File_t* const File);
+		uint8_t FAT_ReadFile(FAT_File_t* const File,
+		                     void* Buffer,
+		                     const uint16_t Length,
+		                     uint16_t* const BytesRead);
+
+		#if defined(INCLUDE_FROM_FATREADER_C)
+			static inline uint16_t FAT_GetLE16(const uint8_t* const Data);
+			static inline uint32_t FAT_GetLE32(const uint8_t* const Data);
+			static void     FAT_RewindFile(FAT_File_t* const File);
+			static uint16_t FAT_GetClusterSectors(const FAT_File_t* const File);
+			static uint8_t  FAT_GetNextCluster(const uint32_t Cluster,
+			                                   uint32_t* const NextCluster);
+			static uint8_t  FAT_SeekNextSector(FAT_File_t* const File,
+			                                   uint32_t* const SectorAddress);
+		#endif
+
+#endif
@@ -0,0 +1,217 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Small write-back sector cache, sitting between the block level MassStore_ReadDeviceBlock() and
+ *  MassStore_WriteDeviceBlock() functions and higher level filesystem code. Recently used sectors are
+ *  kept in SRAM so that repeated accesses to filesystem metadata (such as the FAT) do not require a new
+ *  SCSI command for each access, and modified sectors are only written back to the device when they are
+ *  evicted or \ref SectorCache_Flush() is called.
+ */
+
+#define  INCLUDE_FROM_SECTORCACHE_C
+#include "SectorCache.h"
+
+/** Cached sector entries, evicted in least recently used order. */
+static SectorCache_Entry_t SectorCache_Entries[SECTOR_CACHE_ENTRIES];
+
+/** LUN index of the attached device the cache is currently holding sectors for. */
+static uint8_t SectorCache_LUNIndex;
+
+/** Access stamp counter, incremented on each cache access and used to track the LRU order of the entries. */
+static uint16_t SectorCache_AccessStamp;
+
+
+/** Discards all cached sectors and binds the cache to the given LUN of the attached device. This must be
+ *  called each time a new device is attached, before any other cache functions are used.
+ *
+ *  \param[in] LUNIndex   Index of the LUN inside the device the cache should access
+ *  \param[in] BlockSize  Size in bytes of each block on the device, as returned by MassStore_ReadCapacity()
+ *
+ *  \return Zero on success, or SECTOR_CACHE_BAD_BLOCK_SIZE if the device's block size is not supported
+ */
+uint8_t SectorCache_Init(const uint8_t LUNIndex,
+                         const uint16_t BlockSize)
+{
+	for (uint8_t EntryIndex = 0; EntryIndex < SECTOR_CACHE_ENTRIES; EntryIndex++)
+	{
+		SectorCache_Entries[EntryIndex].IsValid = false;
+		SectorCache_Entries[EntryIndex].IsDirty = false;
+	}
+
+	SectorCache_LUNIndex    = LUNIndex;
+	SectorCache_AccessStamp = 0;
+
+	if (BlockSize != SECTOR_CACHE_SECTOR_SIZE)
+	  return SECTOR_CACHE_BAD_BLOCK_SIZE;
+
+	return 0;
+}
+
+/** Retrieves a pointer to the cached copy of the given device sector, reading it in from the device if it
+ *  is not already cached. When the cache is full the least recently used entry is evicted, being written
+ *  back to the device first if it has been modified.
+ *
+ *  \param[in] BlockAddress  Device block address of the sector to retrieve
+ *  \param[in] ForWrite      If true, the sector is marked as modified so that it will later be written back
+ *  \param[out] SectorData   Pointer to a location where the address of the cached sector data is to be stored
+ *
+ *  \return A value from the Pipe_Stream_RW_ErrorCodes_t enum, or MASS_STORE_SCSI_COMMAND_FAILED if a SCSI command fails
+ */
+uint8_t SectorCache_GetSector(const uint32_t BlockAddress,
+                              const bool ForWrite,
+                              uint8_t** const SectorData)
+{
+	SectorCache_Entry_t* Entry = &SectorCache_Entries[0];
+	uint8_t ErrorCode;
+
+	for (uint8_t EntryIndex = 0; EntryIndex < SECTOR_CACHE_ENTRIES; EntryIndex++)
+	{
+		SectorCache_Entry_t* CurrEntry = &SectorCache_Entries[EntryIndex];
+
+		/* Stop searching on a hit, otherwise track the best eviction candidate - free entries first, then the oldest */
+		if (CurrEntry->IsValid && (CurrEntry->BlockAddress == BlockAddress))
+		{
+			Entry = CurrEntry;
+			break;
+		}
+		else if (!(CurrEntry->IsValid))
+		{
+			if (Entry->IsValid)
+			  Entry = CurrEntry;
+		}
+		else if (Entry->IsValid && ((uint16_t)(SectorCache_AccessStamp - CurrEntry->LastUsed) >
+		                            (uint16_t)(SectorCache_AccessStamp - Entry->LastUsed)))
+		{
+			Entry = CurrEntry;
+		}
+	}
+
+	/* Load the requested sector into the chosen entry on a cache miss, writing back its old contents if modified */
+	if (!(Entry->IsValid) || (Entry->BlockAddress != BlockAddress))
+	{
+		if ((ErrorCode = SectorCache_WriteBack(Entry)) != 0)
+		  return ErrorCode;
+
+		Entry->IsValid = false;
+
+		if ((ErrorCode = MassStore_ReadDeviceBlock(SectorCache_LUNIndex, BlockAddress, 1,
+		                                           SECTOR_CACHE_SECTOR_SIZE, Entry->Data)) != 0)
+		{
+			return ErrorCode;
+		}
+
+		Entry->BlockAddress = BlockAddress;
+		Entry->IsValid      = true;
+	}
+
+	Entry->LastUsed = ++SectorCache_AccessStamp;
+
+	if (ForWrite)
+	  Entry->IsDirty = true;
+
+	*SectorData = Entry->Data;
+	return 0;
+}
+
+/** Reads one or more consecutive sectors directly from the device into the given buffer in a single command,
+ *  without passing the data through the cache. This is intended for bulk file data which is read once and
+ *  would otherwise evict more useful cached metadata sectors. Any modified cached sectors within the range
+ *  are first written back to the device so that the returned data is coherent with the cache.
+ *
+ *  \param[in] BlockAddress  Start device block address to read from
+ *  \param[in] Blocks        Number of sectors to read from the device
+ *  \param[out] BufferPtr    Pointer to the buffer where the read data is to be written to
+ *
+ *  \return A value from the Pipe_Stream_RW_ErrorCodes_t enum, or MASS_STORE_SCSI_COMMAND_FAILED if a SCSI command fails
+ */
+uint8_t SectorCache_ReadSectors(const uint32_t BlockAddress,
+                                const uint8_t Blocks,
+                                void* BufferPtr)
+{
+	uint8_t ErrorCode;
+
+	for (uint8_t EntryIndex = 0; EntryIndex < SECTOR_CACHE_ENTRIES; EntryIndex++)
+	{
+		SectorCache_Entry_t* CurrEntry = &SectorCache_Entries[EntryIndex];
+
+		if (CurrEntry->IsValid && (CurrEntry->BlockAddress >= BlockAddress) &&
+		    (CurrEntry->BlockAddress < (BlockAddress + Blocks)))
+		{
+			if ((ErrorCode = SectorCache_WriteBack(CurrEntry)) != 0)
+			  return ErrorCode;
+		}
+	}
+
+	return MassStore_ReadDeviceBlock(SectorCache_LUNIndex, BlockAddress, Blocks, SECTOR_CACHE_SECTOR_SIZE, BufferPtr);
+}
+
+/** Writes back all modified sectors in the cache to the attached device. This should be called before the
+ *  device is removed or reset to ensure that all changes have been committed to the storage medium.
+ *
+ *  \return A value from the Pipe_Stream_RW_ErrorCodes_t enum, or MASS_STORE_SCSI_COMMAND_FAILED if a SCSI command fails
+ */
+uint8_t SectorCache_Flush(void)
+{
+	uint8_t ErrorCode;
+
+	for (uint8_t EntryIndex = 0; EntryIndex < SECTOR_CACHE_ENTRIES; EntryIndex++)
+	{
+		if ((ErrorCode = SectorCache_WriteBack(&SectorCache_Entries[EntryIndex])) != 0)
+		  return ErrorCode;
+	}
+
+	return 0;
+}
+
+/** Writes the given cache entry back to the attached device if it holds modified data.
+ *
+ *  \param[in,out] Entry  Cache entry to write back
+ *
+ *  \return A value from the Pipe_Stream_RW_ErrorCodes_t enum, or MASS_STORE_SCSI_COMMAND_FAILED if a SCSI command fails
+ */
+static uint8_t SectorCache_WriteBack(SectorCache_Entry_t* const Entry)
+{
+	uint8_t ErrorCode;
+
+	if (!(Entry->IsValid) || !(Entry->IsDirty))
+	  return 0;
+
+	if ((ErrorCode = MassStore_WriteDeviceBlock(SectorCache_LUNIndex, Entry->BlockAddress, 1,
+	                                            SECTOR_CACHE_SECTOR_SIZE, Entry->Data)) != 0)
+	{
+		return ErrorCode;
+	}
+
+	Entry->IsDirty = false;
+	return 0;
+}
@@ -0,0 +1,92 @@
+/*
+             LUFA Library
+     Copyright (C) Dean Camera, 2010.
+              
+  dean [at] fourwalledcubicle [dot] com
+      www.fourwalledcubicle.com
+*/
+
+/*
+  Copyright 2010  Dean Camera (dean [at] fourwalledcubicle [dot] com)
+
+  Permission to use, copy, modify, distribute, and sell this 
+  software and its documentation for any purpose is hereby granted
+  without fee, provided that the above copyright notice appear in 
+  all copies and that both that the copyright notice and this
+  permission notice and warranty disclaimer appear in supporting 
+  documentation, and that the name of the author not be used in 
+  advertising or publicity pertaining to distribution of the 
+  software without specific, written prior permission.
+
+  The author disclaim all warranties with regard to this
+  software, including all implied warranties of merchantability
+  and fitness.  In no event shall the author be liable for any
+  special, indirect or consequential damages or any damages
+  whatsoever resulting from loss of use, data or profits, whether
+  in an action of contract, negligence or other tortious action,
+  arising out of or in connection with the use or performance of
+  this software.
+*/
+
+
+/** \file
+ *
+ *  Header file for SectorCache.c.
+ */
+
+#ifndef _SECTOR_CACHE_H_
+#define _SECTOR_CACHE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "MassStoreCommands.h"
+
+	/* Macros: */
+		/** Size in bytes of each sector held in the cache. Attached devices with a different block size are not
+		 *  supported by the cache, and are rejected by \ref SectorCache_Init().
+		 */
+		#define SECTOR_CACHE_SECTOR_SIZE        512
+
+		#if !defined(SECTOR_CACHE_ENTRIES) || defined(__DOXYGEN__)
+			/** Number of sectors held in the cache at any one time. Each entry consumes \ref SECTOR_CACHE_SECTOR_SIZE
+			 *  bytes of SRAM plus a small header; this may be overridden in the project makefile to trade SRAM for
+			 *  fewer device accesses.
+			 */
+			#define SECTOR_CACHE_ENTRIES        (RAMEND > 0x10FF ? 4 : 2)
+		#endif
+
+		/** Additional error code for the sector cache functions, indicating that the attached device's block
+		 *  size does not match \ref SECTOR_CACHE_SECTOR_SIZE.
+		 */
+		#define SECTOR_CACHE_BAD_BLOCK_SIZE     0xC1
+
+	/* Type defines: */
+		/** Type define for a single cached sector, and its associated bookkeeping information. */
+		typedef struct
+		{
+			uint32_t BlockAddress; /**< Device block address of the cached sector */
+			uint16_t LastUsed; /**< Access stamp of the last access to the entry, for LRU eviction */
+			bool     IsValid; /**< Indicates if the entry currently holds a sector's data */
+			bool     IsDirty; /**< Indicates if the entry has been modified since it was read from the device */
+			uint8_t  Data[SECTOR_CACHE_SECTOR_SIZE]; /**< Cached sector data */
+		} SectorCache_Entry_t;
+
+	/* Function Prototypes: */
+		uint8_t SectorCache_Init(const uint8_t LUNIndex,
+		                         const uint16_t BlockSize);
+		uint8_t SectorCache_GetSector(const uint32_t BlockAddress,
+		                              const bool ForWrite,
+		                              uint8_t** const SectorData);
+		uint8_t SectorCache_ReadSectors(const uint32_t BlockAddress,
+		                                const uint8_t Blocks,
+		                                void* BufferPtr);
+		uint8_t SectorCache_Flush(void);
+
+		#if defined(INCLUDE_FROM_SECTORCACHE_C)
+			static uint8_t SectorCache_WriteBack(SectorCache_Entry_t* const Entry);
+		#endif
+
+#endif
@@ -319,7 +319,42 @@ void MassStorage_Task(void)
 				puts_P(PSTR("\r\n"));
 			}
 			
-			puts_P(PSTR("\r\n\r\nPress board button to read entire ASCII contents of disk...\r\n\r\n"));
+			/* Bind the sector cache to the attached device, and attempt to mount a FAT volume through it */
+			bool IsFATVolume = false;
+
+			if (!(SectorCache_Init(0, DiskCapacity.BlockSize)))
+			{
+				if (!(ErrorCode = FAT_Mount()))
+				{
+					IsFATVolume = true;
+				}
+				else if (ErrorCode != FAT_ERROR_NO_FILESYSTEM)
+				{
+					ShowDiskReadError(PSTR("Mount FAT Volume"), ErrorCode);
+
+					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+					break;
+				}
+			}
+
+			if (IsFATVolume)
+			{
+				printf_P(PSTR("\r\nFAT%d volume, root directory:\r\n"), FAT_GetType());
+
+				if ((ErrorCode = ShowRootDirectory(NULL, 0)) != 0)
+				{
+					ShowDiskReadError(PSTR("Read Directory"), ErrorCode);
+
+					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+					break;
+				}
+
+				puts_P(PSTR("\r\n\r\nPress board button to read ASCII contents of root directory files...\r\n\r\n"));
+			}
+			else
+			{
+				puts_P(PSTR("\r\n\r\nPress board button to read entire ASCII contents of disk...\r\n\r\n"));
+			}
 			
 			/* Wait for the board button to be pressed */
 			while (!(Buttons_GetStatus() & BUTTONS_BUTTON1))
@@ -332,32 +367,59 @@ void MassStorage_Task(void)
 			/* Abort if device removed */
 			if (USB_HostState == HOST_STATE_Unattached)
 			  break;
-			
-			/* Print out the entire disk contents in ASCII format */
-			for (uint32_t CurrBlockAddress = 0; CurrBlockAddress < DiskCapacity.Blocks; CurrBlockAddress++)
+
+			if (IsFATVolume)
 			{
-				/* Read in the next block of data from the device */
-				if ((ErrorCode = MassStore_ReadDeviceBlock(0, CurrBlockAddress, 1, DiskCapacity.BlockSize, BlockBuffer)) != 0)
+				/* Create a new buffer capable of holding several sectors, so that whole runs of sectors within each
+				 * cluster of a file are read from the device in a single command */
+				uint8_t FileBuffer[FILE_READ_SECTORS * SECTOR_CACHE_SECTOR_SIZE];
+
+				/* Stream out the contents of each file in the root directory in ASCII format */
+				if ((ErrorCode = ShowRootDirectory(FileBuffer, sizeof(FileBuffer))) != 0)
 				{
-					ShowDiskReadError(PSTR("Read Device Block"), ErrorCode);
-					
+					ShowDiskReadError(PSTR("Read File"), ErrorCode);
+
 					USB_HostState = HOST_STATE_WaitForDeviceRemoval;
 					break;
 				}
-
-				/* Send the ASCII data in the read in block to the serial port */
-				for (uint16_t Byte = 0; Byte < DiskCapacity.BlockSize; Byte++)
+			}
+			else
+			{
+				/* Print out the entire disk contents in ASCII format */
+				for (uint32_t CurrBlockAddress = 0; CurrBlockAddress < DiskCapacity.Blocks; CurrBlockAddress++)
 				{
-					char CurrByte = BlockBuffer[Byte];
-					
-					putchar(isprint(CurrByte) ? CurrByte : '.');
+					/* Read in the next block of data from the device */
+					if ((ErrorCode = MassStore_ReadDeviceBlock(0, CurrBlockAddress, 1, DiskCapacity.BlockSize, BlockBuffer)) != 0)
+					{
+						ShowDiskReadError(PSTR("Read Device Block"), ErrorCode);
+						
+						USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+						break;
+					}
+
+					/* Send the ASCII data in the read in block to the serial port */
+					for (uint16_t Byte = 0; Byte < DiskCapacity.BlockSize; Byte++)
+					{
+						char CurrByte = BlockBuffer[Byte];
+						
+						putchar(isprint(CurrByte) ? CurrByte : '.');
+					}
+
+					/* Abort if device removed */
+					if (USB_HostState == HOST_STATE_Unattached)
+					  break;
 				}
+			}
 
-				/* Abort if device removed */
-				if (USB_HostState == HOST_STATE_Unattached)
-				  break;
+			/* Commit any modified sectors still held in the sector cache */
+			if (IsFATVolume && ((ErrorCode = SectorCache_Flush()) != 0))
+			{
+				ShowDiskReadError(PSTR("Flush Sector Cache"), ErrorCode);
+
+				USB_HostState = HOST_STATE_WaitForDeviceRemoval;
+				break;
 			}
-			
+
 			/* Indicate device no longer busy */
 			LEDs_SetAllLEDs(LEDMASK_USB_READY);
 			
@@ -394,3 +456,69 @@ void ShowDiskReadError(char* CommandString,
 	/* Indicate device error via the status LEDs */
 	LEDs_SetAllLEDs(LEDMASK_USB_ERROR);
 }
+
+/** Walks the root directory of the mounted FAT volume, either listing each entry's name and size, or
+ *  streaming out the contents of each file in ASCII format. File data is read through the FAT reader,
+ *  which follows each file's cluster chain via the sector cache without re-reading cached FAT sectors.
+ *
+ *  \param[in] Buffer      Buffer to read file data into, or NULL to list the directory entries only
+ *  \param[in] BufferSize  Size in bytes of the given buffer
+ *
+ *  \return Zero on success, or an error code from the sector cache or FAT reader functions
+ */
+uint8_t ShowRootDirectory(uint8_t* const Buffer,
+                          const uint16_t BufferSize)
+{
+	FAT_File_t Directory;
+	FAT_File_t File;
+	uint8_t    ErrorCode;
+
+	FAT_OpenRootDirectory(&Directory);
+
+	while (!(ErrorCode = FAT_ReadDirectory(&Directory, &File)))
+	{
+		/* Abort if device removed */
+		if (USB_HostState == HOST_STATE_Unattached)
+		  return 0;
+
+		if (Buffer == NULL)
+		{
+			if (File.Attributes & FAT_ATTRIBUTE_DIRECTORY)
+			  printf_P(PSTR("  %.8s.%.3s  <DIR>\r\n"), &File.Name[0], &File.Name[8]);
+			else
+			  printf_P(PSTR("  %.8s.%.3s  %lu bytes\r\n"), &File.Name[0], &File.Name[8], File.FileSize);
+
+			continue;
+		}
+
+		if (File.Attributes & FAT_ATTRIBUTE_DIRECTORY)
+		  continue;
+
+		printf_P(PSTR("\r\n--- %.8s.%.3s ---\r\n"), &File.Name[0], &File.Name[8]);
+
+		for (;;)
+		{
+			uint16_t BytesRead;
+
+			if ((ErrorCode = FAT_ReadFile(&File, Buffer, BufferSize, &BytesRead)) != 0)
+			  return ErrorCode;
+
+			if (!(BytesRead))
+			  break;
+
+			/* Send the ASCII data in the read in file chunk to the serial port */
+			for (uint16_t Byte = 0; Byte < BytesRead; Byte++)
+			{
+				char CurrByte = Buffer[Byte];
+
+				putchar(isprint(CurrByte) ? CurrByte : '.');
+			}
+
+			/* Abort if device removed */
+			if (USB_HostState == HOST_STATE_Unattached)
+			  return 0;
+		}
+	}
+
+	return (ErrorCode == FAT_ERROR_END_OF_DIRECTORY) ? 0 : ErrorCode;
+}
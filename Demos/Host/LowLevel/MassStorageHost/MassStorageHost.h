@@ -49,6 +49,8 @@
 		#include "ConfigDescriptor.h"
 
 		#include "Lib/MassStoreCommands.h"
+		#include "Lib/SectorCache.h"
+		#include "Lib/FATReader.h"
 
 		#include <LUFA/Version.h>
 		#include <LUFA/Drivers/Misc/TerminalCodes.h>
@@ -72,6 +74,14 @@
 
 		/** LED mask for the library LED driver, to indicate that the USB interface is busy. */
 		#define LEDMASK_USB_BUSY          LEDS_LED2
+
+		#if !defined(FILE_READ_SECTORS) || defined(__DOXYGEN__)
+			/** Size in sectors of the buffer file data is read into when the root directory's files are streamed out.
+			 *  Whole sectors of each cluster are read into this buffer from the device in a single command, so this
+			 *  may be overridden in the project makefile to trade SRAM for fewer device accesses.
+			 */
+			#define FILE_READ_SECTORS    (RAMEND > 0x10FF ? 4 : 2)
+		#endif
 		
 	/* Function Prototypes: */
 		void MassStorage_Task(void);
@@ -86,5 +96,7 @@
 
 		void ShowDiskReadError(char* CommandString,
 		                       const uint8_t ErrorCode);
+		uint8_t ShowRootDirectory(uint8_t* const Buffer,
+		                          const uint16_t BufferSize);
 
 #endif
@@ -176,6 +176,29 @@
 				return SPI_ReceiveByte();
 			}
 
+			/** Starts sending a byte to the currently selected dataflash IC, without waiting for the transfer to complete, so
+			 *  that the next byte can be prepared while the byte is shifted out. The transfer must be completed with
+			 *  \ref Dataflash_EndTransferByte() before the next byte is sent to or received from the dataflash.
+			 *
+			 *  \param[in] Byte of data to send to the dataflash
+			 */
+			static inline void Dataflash_BeginTransferByte(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline void Dataflash_BeginTransferByte(const uint8_t Byte)
+			{
+				SPI_BeginTransferByte(Byte);
+			}
+
+			/** Waits until the transfer started by \ref Dataflash_BeginTransferByte() is complete, and returns the response
+			 *  byte from the dataflash.
+			 *
+			 *  \return Last response byte from the dataflash
+			 */
+			static inline uint8_t Dataflash_EndTransferByte(void) ATTR_ALWAYS_INLINE;
+			static inline uint8_t Dataflash_EndTransferByte(void)
+			{
+				return SPI_EndTransferByte();
+			}
+
 		/* Includes: */
 			#if (BOARD == BOARD_NONE)
 				#error The Board Buttons driver cannot be used if the makefile BOARD option is not set.
@@ -181,6 +181,30 @@
 				return SPDR;
 			}
 
+			/** Starts sending a byte through the SPI interface, without waiting for the transfer to complete. This allows
+			 *  other processing, such as fetching the next byte to send, to be performed while the byte is shifted out. The
+			 *  transfer must be completed with \ref SPI_EndTransferByte() before the next SPI transfer is started.
+			 *
+			 *  \param[in] Byte  Byte to send through the SPI interface.
+			 */
+			static inline void SPI_BeginTransferByte(const uint8_t Byte) ATTR_ALWAYS_INLINE;
+			static inline void SPI_BeginTransferByte(const uint8_t Byte)
+			{
+				SPDR = Byte;
+			}
+
+			/** Waits until the transfer started by \ref SPI_BeginTransferByte() is complete, and returns the response byte
+			 *  from the attached SPI device.
+			 *
+			 *  \return The response byte from the attached SPI device.
+			 */
+			static inline uint8_t SPI_EndTransferByte(void) ATTR_ALWAYS_INLINE;
+			static inline uint8_t SPI_EndTransferByte(void)
+			{
+				while (!(SPSR & (1 << SPIF)));
+				return SPDR;
+			}
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
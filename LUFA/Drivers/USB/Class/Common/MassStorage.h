@@ -114,9 +114,33 @@
 		/** SCSI Command Code for a READ (6) command. */
 		#define SCSI_CMD_READ_6                                0x08
 
+		/** SCSI Command Code for a WRITE (12) command. */
+		#define SCSI_CMD_WRITE_12                              0xAA
+
+		/** SCSI Command Code for a READ (12) command. */
+		#define SCSI_CMD_READ_12                               0xA8
+
+		/** SCSI Command Code for a WRITE (16) command. */
+		#define SCSI_CMD_WRITE_16                              0x8A
+
+		/** SCSI Command Code for a READ (16) command. */
+		#define SCSI_CMD_READ_16                               0x88
+
+		/** SCSI Command Code for a SERVICE ACTION IN (16) command, which holds the READ CAPACITY (16) command. */
+		#define SCSI_CMD_SERVICE_ACTION_IN_16                  0x9E
+
+		/** SCSI Service Action Code of a SERVICE ACTION IN (16) command for a READ CAPACITY (16) command. */
+		#define SCSI_SERVICE_ACTION_READ_CAPACITY_16           0x10
+
 		/** SCSI Command Code for a VERIFY (10) command. */
 		#define SCSI_CMD_VERIFY_10                             0x2F
 
+		/** SCSI Command Code for a SYNCHRONIZE CACHE (10) command. */
+		#define SCSI_CMD_SYNCHRONIZE_CACHE_10                  0x35
+
+		/** SCSI Command Code for a START STOP UNIT command. */
+		#define SCSI_CMD_START_STOP_UNIT                       0x1B
+
 		/** SCSI Command Code for a MODE SENSE (6) command. */
 		#define SCSI_CMD_MODE_SENSE_6                          0x1A
 
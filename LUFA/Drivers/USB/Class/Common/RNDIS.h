@@ -130,6 +130,9 @@
 			uint8_t       FrameData[ETHERNET_FRAME_SIZE_MAX]; /**< Ethernet frame contents. */
 			uint16_t      FrameLength; /**< Length in bytes of the Ethernet frame stored in the buffer. */
 			bool          FrameInBuffer; /**< Indicates if a frame is currently stored in the buffer. */
+			bool          FrameSendInPlace; /**< Indicates that a received frame has been overwritten with a response frame, which is to
+			                                 *   be sent to the host directly from the receive buffer before the buffer is reused.
+			                                 */
 		} Ethernet_Frame_Info_t;
 
 		/** \brief RNDIS Common Message Header Structure.
@@ -114,6 +114,12 @@ bool RNDIS_Device_ConfigureEndpoints(USB_ClassInfo_RNDIS_Device_t* const RNDISIn
 {
 	memset(&RNDISInterfaceInfo->State, 0x00, sizeof(RNDISInterfaceInfo->State));
 
+	for (uint8_t QueueFrame = 0; QueueFrame < RNDISInterfaceInfo->Config.RXFrameQueueSize; QueueFrame++)
+	  RNDISInterfaceInfo->Config.RXFrameQueue[QueueFrame].FrameInBuffer = false;
+
+	for (uint8_t QueueFrame = 0; QueueFrame < RNDISInterfaceInfo->Config.TXFrameQueueSize; QueueFrame++)
+	  RNDISInterfaceInfo->Config.TXFrameQueue[QueueFrame].FrameInBuffer = false;
+
 	if (!(Endpoint_ConfigureEndpoint(RNDISInterfaceInfo->Config.DataINEndpointNumber, EP_TYPE_BULK,
 							         ENDPOINT_DIR_IN, RNDISInterfaceInfo->Config.DataINEndpointSize,
 							         RNDISInterfaceInfo->Config.DataINEndpointDoubleBank ? ENDPOINT_BANK_DOUBLE : ENDPOINT_BANK_SINGLE)))
@@ -169,10 +175,22 @@ void RNDIS_Device_USBTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo
 	{
 		RNDIS_Packet_Message_t RNDISPacketHeader;
 
+		uint8_t RXQueueFrames = (RNDISInterfaceInfo->Config.RXFrameQueue != NULL) ?
+		                        (RNDISInterfaceInfo->Config.RXFrameQueueSize + 1) : 1;
+		uint8_t TXQueueFrames = (RNDISInterfaceInfo->Config.TXFrameQueue != NULL) ?
+		                        (RNDISInterfaceInfo->Config.TXFrameQueueSize + 1) : 1;
+
+		RNDIS_Device_ReleaseRXFrames(RNDISInterfaceInfo);
+		RNDIS_Device_CommitTXFrames(RNDISInterfaceInfo);
+
 		Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataOUTEndpointNumber);
 
-		if (Endpoint_IsOUTReceived() && !(RNDISInterfaceInfo->State.FrameIN.FrameInBuffer))
+		if (Endpoint_IsOUTReceived() && (RNDISInterfaceInfo->State.RXFrameCount < RXQueueFrames))
 		{
+			Ethernet_Frame_Info_t* FrameIN = RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameIN,
+			                                                            RNDISInterfaceInfo->Config.RXFrameQueue,
+			                                                            RNDISInterfaceInfo->State.RXFrameHead);
+
 			Endpoint_Read_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NO_STREAM_CALLBACK);
 
 			if (RNDISPacketHeader.DataLength > ETHERNET_FRAME_SIZE_MAX)
@@ -181,35 +199,163 @@ void RNDIS_Device_USBTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo
 				return;
 			}
 			
-			Endpoint_Read_Stream_LE(RNDISInterfaceInfo->State.FrameIN.FrameData, RNDISPacketHeader.DataLength, NO_STREAM_CALLBACK);
+			Endpoint_Read_Stream_LE(FrameIN->FrameData, RNDISPacketHeader.DataLength, NO_STREAM_CALLBACK);
 
 			Endpoint_ClearOUT();
 			
-			RNDISInterfaceInfo->State.FrameIN.FrameLength = RNDISPacketHeader.DataLength;
+			FrameIN->FrameLength      = RNDISPacketHeader.DataLength;
+			FrameIN->FrameSendInPlace = false;
+			FrameIN->FrameInBuffer    = true;
+
+			if (++RNDISInterfaceInfo->State.RXFrameHead == RXQueueFrames)
+			  RNDISInterfaceInfo->State.RXFrameHead = 0;
 
-			RNDISInterfaceInfo->State.FrameIN.FrameInBuffer = true;
+			RNDISInterfaceInfo->State.RXFrameCount++;
 		}
 		
 		Endpoint_SelectEndpoint(RNDISInterfaceInfo->Config.DataINEndpointNumber);
 		
-		if (Endpoint_IsINReady() && RNDISInterfaceInfo->State.FrameOUT.FrameInBuffer)
+		Ethernet_Frame_Info_t* FrameOUT = NULL;
+		bool                   InPlace  = false;
+
+		/* Responses built in place over the oldest received frame are sent first, so that the receive buffer can be reused */
+		if (RNDISInterfaceInfo->State.RXFrameCount)
+		{
+			FrameOUT = RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameIN, RNDISInterfaceInfo->Config.RXFrameQueue,
+			                                      RNDISInterfaceInfo->State.RXFrameTail);
+
+			InPlace  = (FrameOUT->FrameSendInPlace && !(FrameOUT->FrameInBuffer));
+		}
+
+		if (!(InPlace))
+		{
+			FrameOUT = (RNDISInterfaceInfo->State.TXFrameCount) ?
+			           RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameOUT, RNDISInterfaceInfo->Config.TXFrameQueue,
+			                                      RNDISInterfaceInfo->State.TXFrameTail) : NULL;
+		}
+
+		if (Endpoint_IsINReady() && (FrameOUT != NULL))
 		{
 			memset(&RNDISPacketHeader, 0, sizeof(RNDIS_Packet_Message_t));
 
 			RNDISPacketHeader.MessageType   = REMOTE_NDIS_PACKET_MSG;
-			RNDISPacketHeader.MessageLength = (sizeof(RNDIS_Packet_Message_t) + RNDISInterfaceInfo->State.FrameOUT.FrameLength);
+			RNDISPacketHeader.MessageLength = (sizeof(RNDIS_Packet_Message_t) + FrameOUT->FrameLength);
 			RNDISPacketHeader.DataOffset    = (sizeof(RNDIS_Packet_Message_t) - sizeof(RNDIS_Message_Header_t));
-			RNDISPacketHeader.DataLength    = RNDISInterfaceInfo->State.FrameOUT.FrameLength;
+			RNDISPacketHeader.DataLength    = FrameOUT->FrameLength;
 
 			Endpoint_Write_Stream_LE(&RNDISPacketHeader, sizeof(RNDIS_Packet_Message_t), NO_STREAM_CALLBACK);
-			Endpoint_Write_Stream_LE(RNDISInterfaceInfo->State.FrameOUT.FrameData, RNDISPacketHeader.DataLength, NO_STREAM_CALLBACK);
+			Endpoint_Write_Stream_LE(FrameOUT->FrameData, RNDISPacketHeader.DataLength, NO_STREAM_CALLBACK);
 			Endpoint_ClearIN();
 			
-			RNDISInterfaceInfo->State.FrameOUT.FrameInBuffer = false;
+			if (InPlace)
+			{
+				/* Received frame buffer is released on the next call to RNDIS_Device_ReleaseRXFrames() */
+				FrameOUT->FrameSendInPlace = false;
+			}
+			else
+			{
+				FrameOUT->FrameInBuffer = false;
+
+				if (++RNDISInterfaceInfo->State.TXFrameTail == TXQueueFrames)
+				  RNDISInterfaceInfo->State.TXFrameTail = 0;
+
+				RNDISInterfaceInfo->State.TXFrameCount--;
+			}
 		}
 	}
 }							
 
+Ethernet_Frame_Info_t* RNDIS_Device_GetReceivedFrame(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t RXQueueFrames = (RNDISInterfaceInfo->Config.RXFrameQueue != NULL) ?
+	                        (RNDISInterfaceInfo->Config.RXFrameQueueSize + 1) : 1;
+
+	RNDIS_Device_ReleaseRXFrames(RNDISInterfaceInfo);
+
+	uint8_t FrameIndex = RNDISInterfaceInfo->State.RXFrameTail;
+
+	/* Skip over processed frames at the head of the queue which are still waiting for their in place responses to be sent */
+	for (uint8_t QueuedFrames = RNDISInterfaceInfo->State.RXFrameCount; QueuedFrames; QueuedFrames--)
+	{
+		Ethernet_Frame_Info_t* FrameIN = RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameIN,
+		                                                            RNDISInterfaceInfo->Config.RXFrameQueue, FrameIndex);
+
+		if (FrameIN->FrameInBuffer)
+		  return FrameIN;
+
+		if (++FrameIndex == RXQueueFrames)
+		  FrameIndex = 0;
+	}
+
+	return NULL;
+}
+
+Ethernet_Frame_Info_t* RNDIS_Device_GetTransmitFrame(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t TXQueueFrames = (RNDISInterfaceInfo->Config.TXFrameQueue != NULL) ?
+	                        (RNDISInterfaceInfo->Config.TXFrameQueueSize + 1) : 1;
+
+	RNDIS_Device_CommitTXFrames(RNDISInterfaceInfo);
+
+	if (RNDISInterfaceInfo->State.TXFrameCount == TXQueueFrames)
+	  return NULL;
+
+	return RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameOUT, RNDISInterfaceInfo->Config.TXFrameQueue,
+	                                  RNDISInterfaceInfo->State.TXFrameHead);
+}
+
+static Ethernet_Frame_Info_t* RNDIS_Device_GetQueueFrame(Ethernet_Frame_Info_t* const BaseFrame,
+                                                         Ethernet_Frame_Info_t* const QueueFrames,
+                                                         const uint8_t Index)
+{
+	/* The interface state's own frame buffer is always the first in the queue, followed by any user supplied buffers */
+	return (Index == 0) ? BaseFrame : &QueueFrames[Index - 1];
+}
+
+static void RNDIS_Device_ReleaseRXFrames(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t RXQueueFrames = (RNDISInterfaceInfo->Config.RXFrameQueue != NULL) ?
+	                        (RNDISInterfaceInfo->Config.RXFrameQueueSize + 1) : 1;
+
+	/* Free up the oldest received frames in order once the user application has finished processing them, and any
+	   response built in place over them has been sent */
+	while (RNDISInterfaceInfo->State.RXFrameCount)
+	{
+		Ethernet_Frame_Info_t* FrameIN = RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameIN,
+		                                                            RNDISInterfaceInfo->Config.RXFrameQueue,
+		                                                            RNDISInterfaceInfo->State.RXFrameTail);
+
+		if (FrameIN->FrameInBuffer || FrameIN->FrameSendInPlace)
+		  break;
+
+		if (++RNDISInterfaceInfo->State.RXFrameTail == RXQueueFrames)
+		  RNDISInterfaceInfo->State.RXFrameTail = 0;
+
+		RNDISInterfaceInfo->State.RXFrameCount--;
+	}
+}
+
+static void RNDIS_Device_CommitTXFrames(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+{
+	uint8_t TXQueueFrames = (RNDISInterfaceInfo->Config.TXFrameQueue != NULL) ?
+	                        (RNDISInterfaceInfo->Config.TXFrameQueueSize + 1) : 1;
+
+	/* Add the frames filled by the user application to the transmit queue, in the order they were handed out */
+	while (RNDISInterfaceInfo->State.TXFrameCount < TXQueueFrames)
+	{
+		if (!(RNDIS_Device_GetQueueFrame(&RNDISInterfaceInfo->State.FrameOUT, RNDISInterfaceInfo->Config.TXFrameQueue,
+		                                 RNDISInterfaceInfo->State.TXFrameHead)->FrameInBuffer))
+		{
+			break;
+		}
+
+		if (++RNDISInterfaceInfo->State.TXFrameHead == TXQueueFrames)
+		  RNDISInterfaceInfo->State.TXFrameHead = 0;
+
+		RNDISInterfaceInfo->State.TXFrameCount++;
+	}
+}
+
 void RNDIS_Device_ProcessRNDISControlMessage(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
 {
 	/* Note: Only a single buffer is used for both the received message and its response to save SRAM. Because of
@@ -97,6 +97,17 @@
 					
 					char*         AdapterVendorDescription; /**< String description of the adapter vendor. */
 					MAC_Address_t AdapterMACAddress; /**< MAC address of the adapter. */
+
+					Ethernet_Frame_Info_t* RXFrameQueue; /**< Pointer to an optional array of additional frame buffers, used to queue
+					                                      *   further received frames from the host while earlier frames are still being
+					                                      *   processed. NULL if only the single \c FrameIN buffer should be used.
+					                                      */
+					uint8_t                RXFrameQueueSize; /**< Number of frame buffers in the \c RXFrameQueue array. */
+					Ethernet_Frame_Info_t* TXFrameQueue; /**< Pointer to an optional array of additional frame buffers, used to queue
+					                                      *   further frames to send to the host while earlier frames are still being
+					                                      *   transmitted. NULL if only the single \c FrameOUT buffer should be used.
+					                                      */
+					uint8_t                TXFrameQueueSize; /**< Number of frame buffers in the \c TXFrameQueue array. */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section.
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -114,6 +125,12 @@
 					Ethernet_Frame_Info_t FrameOUT; /**< Structure holding the next Ethernet frame to send to the host, populated by the
 													 *   user application.
 													 */
+					uint8_t  RXFrameHead; /**< Index of the next receive queue frame buffer to fill, used internally by the class driver. */
+					uint8_t  RXFrameTail; /**< Index of the oldest received frame in the receive queue, used internally by the class driver. */
+					uint8_t  RXFrameCount; /**< Number of received frames in the receive queue, used internally by the class driver. */
+					uint8_t  TXFrameHead; /**< Index of the transmit queue frame buffer to fill next, used internally by the class driver. */
+					uint8_t  TXFrameTail; /**< Index of the oldest frame in the transmit queue, used internally by the class driver. */
+					uint8_t  TXFrameCount; /**< Number of frames waiting in the transmit queue, used internally by the class driver. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 				          *   are reset to their defaults when the interface is enumerated.
 				          */
@@ -143,6 +160,36 @@
 			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing a RNDIS Class configuration and state.
 			 */
 			void RNDIS_Device_USBTask(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Retrieves the oldest received Ethernet frame from the host which has not yet been processed by the user application.
+			 *  Once the user application has finished processing the frame, its \c FrameInBuffer flag should be cleared so that the
+			 *  buffer can be reused by the class driver for a new frame.
+			 *
+			 *  Responses to a received frame may be built in place over the received frame's data, rather than copied into a separate
+			 *  transmit frame buffer. To send such a response, the frame's \c FrameLength should be set to the response length and its
+			 *  \c FrameSendInPlace flag set before \c FrameInBuffer is cleared; the buffer is then sent to the host before it is reused.
+			 *
+			 *  When the optional receive queue is not used, this always refers to the \c FrameIN buffer in the interface state.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing a RNDIS Class configuration and state.
+			 *
+			 *  \return Pointer to the oldest unprocessed received frame, or NULL if no frames are waiting to be processed.
+			 */
+			Ethernet_Frame_Info_t* RNDIS_Device_GetReceivedFrame(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+			                                                     ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Retrieves the next free frame buffer into which the user application may write an Ethernet frame to send to the host.
+			 *  Once the frame data and length have been written, the frame's \c FrameInBuffer flag should be set to queue the frame
+			 *  for transmission. Frames are sent to the host in the order in which they were retrieved.
+			 *
+			 *  When the optional transmit queue is not used, this always refers to the \c FrameOUT buffer in the interface state.
+			 *
+			 *  \param[in,out] RNDISInterfaceInfo  Pointer to a structure containing a RNDIS Class configuration and state.
+			 *
+			 *  \return Pointer to a free frame buffer to fill, or NULL if all frame buffers are waiting to be sent.
+			 */
+			Ethernet_Frame_Info_t* RNDIS_Device_GetTransmitFrame(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+			                                                     ATTR_NON_NULL_PTR_ARG(1);
 		
 	/* Private Interface - For use in library only: */
 	#if !defined(__DOXYGEN__)
@@ -162,6 +209,13 @@
 			                                        const void* SetData,
                                                     const uint16_t SetSize) ATTR_NON_NULL_PTR_ARG(1)
 			                                        ATTR_NON_NULL_PTR_ARG(3);
+			static Ethernet_Frame_Info_t* RNDIS_Device_GetQueueFrame(Ethernet_Frame_Info_t* const BaseFrame,
+			                                                         Ethernet_Frame_Info_t* const QueueFrames,
+			                                                         const uint8_t Index) ATTR_NON_NULL_PTR_ARG(1);
+			static void RNDIS_Device_ReleaseRXFrames(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+			                                         ATTR_NON_NULL_PTR_ARG(1);
+			static void RNDIS_Device_CommitTXFrames(USB_ClassInfo_RNDIS_Device_t* const RNDISInterfaceInfo)
+			                                        ATTR_NON_NULL_PTR_ARG(1);
 		#endif
 		
 	#endif
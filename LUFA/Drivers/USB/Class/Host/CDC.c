@@ -231,9 +231,46 @@ void CDC_Host_USBTask(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 	
 	Pipe_Freeze();
 
+	if (CDCInterfaceInfo->Config.RXBuffer != NULL)
+	  CDC_Host_FillRXBuffer(CDCInterfaceInfo);
+
 	CDC_Host_Flush(CDCInterfaceInfo);
 }
 
+static void CDC_Host_FillRXBuffer(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
+{
+	uint8_t* const RXBuffer     = CDCInterfaceInfo->Config.RXBuffer;
+	uint16_t const RXBufferSize = CDCInterfaceInfo->Config.RXBufferSize;
+
+	Pipe_SelectPipe(CDCInterfaceInfo->Config.DataINPipeNumber);
+	Pipe_Unfreeze();
+
+	while (Pipe_IsINReceived())
+	{
+		uint16_t BytesInPipe = Pipe_BytesInPipe();
+		
+		if (BytesInPipe > (RXBufferSize - CDCInterfaceInfo->State.RXBufferCount))
+		  break;
+
+		uint16_t BufferIn = CDCInterfaceInfo->State.RXBufferIn;
+		CDCInterfaceInfo->State.RXBufferCount += BytesInPipe;
+
+		while (BytesInPipe--)
+		{
+			RXBuffer[BufferIn] = Pipe_Read_Byte();
+
+			if (++BufferIn == RXBufferSize)
+			  BufferIn = 0;
+		}
+
+		CDCInterfaceInfo->State.RXBufferIn = BufferIn;
+
+		Pipe_ClearIN();
+	}
+
+	Pipe_Freeze();
+}
+
 uint8_t CDC_Host_SetLineEncoding(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 {
 	USB_ControlRequest = (USB_Request_Header_t)
@@ -331,6 +368,12 @@ uint16_t CDC_Host_BytesReceived(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo
 	if ((USB_HostState != HOST_STATE_Configured) || !(CDCInterfaceInfo->State.IsActive))
 	  return 0;
 	
+	if (CDCInterfaceInfo->Config.RXBuffer != NULL)
+	{
+		CDC_Host_FillRXBuffer(CDCInterfaceInfo);
+		return CDCInterfaceInfo->State.RXBufferCount;
+	}
+
 	Pipe_SelectPipe(CDCInterfaceInfo->Config.DataINPipeNumber);
 	Pipe_Unfreeze();
 
@@ -363,6 +406,16 @@ int16_t CDC_Host_ReceiveByte(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 	  
 	int16_t ReceivedByte = -1;
 
+	if (CDCInterfaceInfo->Config.RXBuffer != NULL)
+	{
+		uint8_t Data;
+	
+		if (CDC_Host_ReadData(CDCInterfaceInfo, &Data, sizeof(Data)))
+		  ReceivedByte = Data;
+		  
+		return ReceivedByte;
+	}
+
 	Pipe_SelectPipe(CDCInterfaceInfo->Config.DataINPipeNumber);
 	Pipe_Unfreeze();
 
@@ -380,6 +433,72 @@ int16_t CDC_Host_ReceiveByte(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 	return ReceivedByte;
 }
 
+uint16_t CDC_Host_ReadData(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo,
+                           void* const Buffer,
+                           const uint16_t Length)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(CDCInterfaceInfo->State.IsActive))
+	  return 0;
+
+	uint8_t* DataStream = (uint8_t*)Buffer;
+	uint16_t BytesRem   = Length;
+	
+	if (CDCInterfaceInfo->Config.RXBuffer != NULL)
+	{
+		uint8_t* const RXBuffer  = CDCInterfaceInfo->Config.RXBuffer;
+		uint16_t       BufferOut = CDCInterfaceInfo->State.RXBufferOut;
+		uint16_t       BytesToCopy;
+
+		if (!(CDCInterfaceInfo->State.RXBufferCount))
+		  CDC_Host_FillRXBuffer(CDCInterfaceInfo);
+		
+		BytesToCopy = CDCInterfaceInfo->State.RXBufferCount;
+
+		if (BytesToCopy > BytesRem)
+		  BytesToCopy = BytesRem;
+
+		CDCInterfaceInfo->State.RXBufferCount -= BytesToCopy;
+		BytesRem -= BytesToCopy;
+
+		while (BytesToCopy--)
+		{
+			*(DataStream++) = RXBuffer[BufferOut];
+
+			if (++BufferOut == CDCInterfaceInfo->Config.RXBufferSize)
+			  BufferOut = 0;
+		}
+
+		CDCInterfaceInfo->State.RXBufferOut = BufferOut;
+
+		/* Remaining data may only be read directly from the pipe once the ring buffer is empty, to preserve ordering */
+		if (CDCInterfaceInfo->State.RXBufferCount)
+		  return (Length - BytesRem);
+	}
+
+	Pipe_SelectPipe(CDCInterfaceInfo->Config.DataINPipeNumber);
+	Pipe_Unfreeze();
+
+	while (BytesRem && Pipe_IsINReceived())
+	{
+		uint16_t BytesToRead = Pipe_BytesInPipe();
+
+		if (BytesToRead > BytesRem)
+		  BytesToRead = BytesRem;
+
+		BytesRem -= BytesToRead;
+
+		while (BytesToRead--)
+		  *(DataStream++) = Pipe_Read_Byte();
+
+		if (!(Pipe_BytesInPipe()))
+		  Pipe_ClearIN();
+	}
+
+	Pipe_Freeze();
+
+	return (Length - BytesRem);
+}
+
 uint8_t CDC_Host_Flush(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
 {
 	if ((USB_HostState != HOST_STATE_Configured) || !(CDCInterfaceInfo->State.IsActive))
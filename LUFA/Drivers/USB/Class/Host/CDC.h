@@ -90,6 +90,15 @@
 
 					uint8_t  NotificationPipeNumber; /**< Pipe number of the CDC interface's IN notification endpoint, if used. */			
 					bool     NotificationPipeDoubleBank; /**< Indicates if the CDC interface's notification pipe should use double banking. */
+
+					uint8_t* RXBuffer; /**< Optional pointer to a user allocated ring buffer, into which whole IN packets from the
+					                    *   device are drained by \ref CDC_Host_USBTask() to free the pipe banks for the next
+					                    *   transfers. If NULL, data is read directly from the IN pipe.
+					                    */
+					uint16_t RXBufferSize; /**< Size in bytes of the buffer pointed to by RXBuffer, if used. This should be at least
+					                        *   twice the size of the device's IN endpoint so that a received packet can always be
+					                        *   drained while the previous packet is being consumed.
+					                        */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -131,6 +140,10 @@
 					                 *   by the host application, the \ref CDC_Host_SetLineEncoding() function must be called to push
 					                 *   the changes to the device.
 					                 */
+
+					uint16_t RXBufferCount; /**< Number of bytes currently stored in the optional receive ring buffer. */
+					uint16_t RXBufferIn; /**< Index of the next free location in the optional receive ring buffer. */
+					uint16_t RXBufferOut; /**< Index of the next byte to read from the optional receive ring buffer. */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
@@ -241,6 +254,9 @@
 			 *  immediately. If multiple bytes are to be received, they should be buffered by the user application, as the pipe bank will not be
 			 *  released back to the USB controller until all bytes are read.
 			 *
+			 *  If a receive ring buffer has been supplied in the interface's configuration, the returned count is instead the number of
+			 *  bytes currently held in the ring buffer.
+			 *
 			 *  \pre This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
 			 *       call will fail.
 			 *
@@ -262,6 +278,25 @@
 			 *  \return Next received byte from the device, or a negative value if no data received.
 			 */
 			int16_t CDC_Host_ReceiveByte(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
+			/** Reads a block of data from the device, returning as soon as either the requested number of bytes have been read or
+			 *  no more received data is waiting. Unlike \ref CDC_Host_ReceiveByte(), the IN pipe is selected and unfrozen only once
+			 *  for the entire transfer, and consecutive received packets (including both banks of a double banked pipe) are drained
+			 *  in the same pipe session. If a receive ring buffer has been supplied in the interface's configuration, buffered data
+			 *  is returned first.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] CDCInterfaceInfo  Pointer to a structure containing a CDC Class host configuration and state.
+			 *  \param[out]    Buffer            Pointer to the destination buffer for the received data.
+			 *  \param[in]     Length            Maximum number of bytes to read into the destination buffer.
+			 *
+			 *  \return Number of bytes read from the device into the destination buffer.
+			 */
+			uint16_t CDC_Host_ReadData(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo,
+			                           void* const Buffer,
+			                           const uint16_t Length) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
 			
 			/** Flushes any data waiting to be sent, ensuring that the send buffer is cleared.
 			 *
@@ -326,6 +361,7 @@
 				                            FILE* Stream) ATTR_NON_NULL_PTR_ARG(2);
 				static int CDC_Host_getchar(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
 				static int CDC_Host_getchar_Blocking(FILE* Stream) ATTR_NON_NULL_PTR_ARG(1);
+				static void CDC_Host_FillRXBuffer(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
 
 				void CDC_Host_Event_Stub(void);
 				void EVENT_CDC_Host_ControLineStateChanged(USB_ClassInfo_CDC_Host_t* const CDCInterfaceInfo)
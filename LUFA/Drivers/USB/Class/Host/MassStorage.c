@@ -222,7 +222,8 @@ static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfac
                                        void* BufferPtr)
 {
 	uint8_t  ErrorCode = PIPE_RWSTREAM_NoError;
-	uint16_t BytesRem  = SCSICommandBlock->DataTransferLength;
+	uint32_t BytesRem  = SCSICommandBlock->DataTransferLength;
+	uint8_t* DataPtr   = (uint8_t*)BufferPtr;
 
 	if (SCSICommandBlock->Flags & COMMAND_DIRECTION_DATA_IN)
 	{
@@ -235,8 +236,16 @@ static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfac
 		Pipe_SelectPipe(MSInterfaceInfo->Config.DataINPipeNumber);
 		Pipe_Unfreeze();
 		
-		if ((ErrorCode = Pipe_Read_Stream_LE(BufferPtr, BytesRem, NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
-		  return ErrorCode;
+		while (BytesRem)
+		{
+			uint16_t BytesInChunk = (BytesRem > MS_MAX_STREAM_CHUNK_SIZE) ? MS_MAX_STREAM_CHUNK_SIZE : BytesRem;
+
+			if ((ErrorCode = Pipe_Read_Stream_LE(DataPtr, BytesInChunk, NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
+			  return ErrorCode;
+			
+			DataPtr  += BytesInChunk;
+			BytesRem -= BytesInChunk;
+		}
 
 		Pipe_ClearIN();
 	}
@@ -245,8 +254,16 @@ static uint8_t MS_Host_SendReceiveData(USB_ClassInfo_MS_Host_t* const MSInterfac
 		Pipe_SelectPipe(MSInterfaceInfo->Config.DataOUTPipeNumber);
 		Pipe_Unfreeze();
 
-		if ((ErrorCode = Pipe_Write_Stream_LE(BufferPtr, BytesRem, NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
-		  return ErrorCode;
+		while (BytesRem)
+		{
+			uint16_t BytesInChunk = (BytesRem > MS_MAX_STREAM_CHUNK_SIZE) ? MS_MAX_STREAM_CHUNK_SIZE : BytesRem;
+
+			if ((ErrorCode = Pipe_Write_Stream_LE(DataPtr, BytesInChunk, NO_STREAM_CALLBACK)) != PIPE_RWSTREAM_NoError)
+			  return ErrorCode;
+			
+			DataPtr  += BytesInChunk;
+			BytesRem -= BytesInChunk;
+		}
 
 		Pipe_ClearOUT();
 		
@@ -443,6 +460,11 @@ uint8_t MS_Host_ReadDeviceCapacity(USB_ClassInfo_MS_Host_t* const MSInterfaceInf
 	if ((ErrorCode = MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSICommandStatus)) != PIPE_RWSTREAM_NoError)
 	  return ErrorCode;
 
+	/* READ CAPACITY returns the address of the last block, save it so that the block cache's read-ahead can be limited */
+	MSInterfaceInfo->State.CapacityLastBlock = DeviceCapacity->Blocks;
+	MSInterfaceInfo->State.CapacityLUNIndex  = LUNIndex;
+	MSInterfaceInfo->State.CapacityIsKnown   = true;
+
 	return PIPE_RWSTREAM_NoError;
 }
 
@@ -520,35 +542,33 @@ uint8_t MS_Host_PreventAllowMediumRemoval(USB_ClassInfo_MS_Host_t* const MSInter
 	return PIPE_RWSTREAM_NoError;
 }
 
-uint8_t MS_Host_ReadDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
-                                 const uint8_t LUNIndex,
-                                 const uint32_t BlockAddress,
-                                 const uint8_t Blocks,
-                                 const uint16_t BlockSize,
-                                 void* BlockBuffer)
+static uint8_t MS_Host_TransferDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                            const uint8_t LUNIndex,
+                                            const uint32_t BlockAddress,
+                                            const uint8_t Blocks,
+                                            const uint16_t BlockSize,
+                                            void* BlockBuffer,
+                                            const bool IsRead)
 {
-	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
-	  return HOST_SENDCONTROL_DeviceDisconnected;
-
 	uint8_t ErrorCode;
 
 	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
 		{
 			.DataTransferLength = ((uint32_t)Blocks * BlockSize),
-			.Flags              = COMMAND_DIRECTION_DATA_IN,
+			.Flags              = (IsRead ? COMMAND_DIRECTION_DATA_IN : COMMAND_DIRECTION_DATA_OUT),
 			.LUN                = LUNIndex,
 			.SCSICommandLength  = 10,
 			.SCSICommandData    =
 				{
-					SCSI_CMD_READ_10,
+					(IsRead ? SCSI_CMD_READ_10 : SCSI_CMD_WRITE_10),
 					0x00,                   // Unused (control bits, all off)
 					(BlockAddress >> 24),   // MSB of Block Address
 					(BlockAddress >> 16),
 					(BlockAddress >> 8),
 					(BlockAddress & 0xFF),  // LSB of Block Address
 					0x00,                   // Reserved
-					0x00,                   // MSB of Total Blocks to Read
-					Blocks,                 // LSB of Total Blocks to Read
+					0x00,                   // MSB of Total Blocks to Transfer
+					Blocks,                 // LSB of Total Blocks to Transfer
 					0x00                    // Unused (control)
 				}
 		};
@@ -564,6 +584,171 @@ uint8_t MS_Host_ReadDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 	return PIPE_RWSTREAM_NoError;
 }
 
+static uint8_t MS_Host_GetCacheCapacity(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                        const uint16_t BlockSize)
+{
+	uint16_t CacheBlocks = (MSInterfaceInfo->Config.BlockCacheSize / BlockSize);
+	
+	return (CacheBlocks > 0xFF) ? 0xFF : CacheBlocks;
+}
+
+static bool MS_Host_IsCacheForMedium(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                     const uint8_t LUNIndex,
+                                     const uint16_t BlockSize)
+{
+	return (MSInterfaceInfo->State.CacheTotalBlocks &&
+	        (MSInterfaceInfo->State.CacheLUNIndex  == LUNIndex) &&
+	        (MSInterfaceInfo->State.CacheBlockSize == BlockSize));
+}
+
+static uint8_t MS_Host_ReadDeviceBlocksCached(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                              const uint8_t LUNIndex,
+                                              uint32_t BlockAddress,
+                                              uint8_t Blocks,
+                                              const uint16_t BlockSize,
+                                              uint8_t* BlockBuffer)
+{
+	uint8_t* const BlockCache  = MSInterfaceInfo->Config.BlockCache;
+	uint8_t  const CacheBlocks = MS_Host_GetCacheCapacity(MSInterfaceInfo, BlockSize);
+	uint8_t        ErrorCode;
+
+	while (Blocks)
+	{
+		uint32_t CacheStart = MSInterfaceInfo->State.CacheStartBlock;
+		uint32_t CacheEnd   = (CacheStart + MSInterfaceInfo->State.CacheTotalBlocks);
+
+		if (MS_Host_IsCacheForMedium(MSInterfaceInfo, LUNIndex, BlockSize) &&
+		    (BlockAddress >= CacheStart) && (BlockAddress < CacheEnd))
+		{
+			uint8_t BlocksToCopy = (CacheEnd - BlockAddress);
+			
+			if (BlocksToCopy > Blocks)
+			  BlocksToCopy = Blocks;
+
+			memcpy(BlockBuffer, &BlockCache[(uint16_t)(BlockAddress - CacheStart) * BlockSize],
+			       ((uint16_t)BlocksToCopy * BlockSize));
+
+			BlockAddress += BlocksToCopy;
+			BlockBuffer  += ((uint16_t)BlocksToCopy * BlockSize);
+			Blocks       -= BlocksToCopy;
+			continue;
+		}
+
+		if ((ErrorCode = MS_Host_FlushBlockCache(MSInterfaceInfo)) != PIPE_RWSTREAM_NoError)
+		  return ErrorCode;
+
+		/* Large reads gain nothing from the cache, transfer them in a single command straight to the caller's buffer */
+		if (Blocks >= CacheBlocks)
+		  break;
+
+		/* Only read ahead within a medium of known capacity, so that the device is never asked for blocks past its end */
+		if (!(MSInterfaceInfo->State.CapacityIsKnown) || (MSInterfaceInfo->State.CapacityLUNIndex != LUNIndex) ||
+		    (BlockAddress > MSInterfaceInfo->State.CapacityLastBlock))
+		{
+			break;
+		}
+
+		uint8_t  ReadAheadBlocks = CacheBlocks;
+		uint32_t BlocksToEnd     = (MSInterfaceInfo->State.CapacityLastBlock - BlockAddress + 1);
+
+		if ((BlocksToEnd != 0) && (BlocksToEnd < ReadAheadBlocks))
+		  ReadAheadBlocks = BlocksToEnd;
+
+		/* Reads which extend past the end of the medium are passed straight to the device, to report the error */
+		if (ReadAheadBlocks < Blocks)
+		  break;
+
+		MSInterfaceInfo->State.CacheTotalBlocks = 0;
+
+		if ((ErrorCode = MS_Host_TransferDeviceBlocks(MSInterfaceInfo, LUNIndex, BlockAddress, ReadAheadBlocks, BlockSize,
+		                                              BlockCache, true)) != PIPE_RWSTREAM_NoError)
+		{
+			return ErrorCode;
+		}
+
+		MSInterfaceInfo->State.CacheStartBlock  = BlockAddress;
+		MSInterfaceInfo->State.CacheBlockSize   = BlockSize;
+		MSInterfaceInfo->State.CacheLUNIndex    = LUNIndex;
+		MSInterfaceInfo->State.CacheTotalBlocks = ReadAheadBlocks;
+	}
+
+	if (!(Blocks))
+	  return PIPE_RWSTREAM_NoError;
+	
+	return MS_Host_TransferDeviceBlocks(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize, BlockBuffer, true);
+}
+
+static uint8_t MS_Host_WriteDeviceBlocksCached(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                               const uint8_t LUNIndex,
+                                               const uint32_t BlockAddress,
+                                               const uint8_t Blocks,
+                                               const uint16_t BlockSize,
+                                               const void* BlockBuffer)
+{
+	uint8_t* const BlockCache  = MSInterfaceInfo->Config.BlockCache;
+	uint8_t  const CacheBlocks = MS_Host_GetCacheCapacity(MSInterfaceInfo, BlockSize);
+	uint32_t const CacheStart  = MSInterfaceInfo->State.CacheStartBlock;
+	uint32_t const CacheEnd    = (CacheStart + MSInterfaceInfo->State.CacheTotalBlocks);
+	bool     const SameMedium  = MS_Host_IsCacheForMedium(MSInterfaceInfo, LUNIndex, BlockSize);
+	uint8_t        ErrorCode;
+
+	/* Combine writes which overwrite or directly follow the blocks already waiting in the cache */
+	if (SameMedium && MSInterfaceInfo->State.CacheIsDirty &&
+	    (BlockAddress >= CacheStart) && (BlockAddress <= CacheEnd) &&
+	    ((BlockAddress + Blocks - CacheStart) <= CacheBlocks))
+	{
+		memcpy(&BlockCache[(uint16_t)(BlockAddress - CacheStart) * BlockSize], BlockBuffer,
+		       ((uint16_t)Blocks * BlockSize));
+		
+		if ((BlockAddress + Blocks) > CacheEnd)
+		  MSInterfaceInfo->State.CacheTotalBlocks = (BlockAddress + Blocks - CacheStart);
+
+		if (MSInterfaceInfo->State.CacheTotalBlocks == CacheBlocks)
+		  return MS_Host_FlushBlockCache(MSInterfaceInfo);
+
+		return PIPE_RWSTREAM_NoError;
+	}
+
+	if ((ErrorCode = MS_Host_FlushBlockCache(MSInterfaceInfo)) != PIPE_RWSTREAM_NoError)
+	  return ErrorCode;
+
+	/* Discard any read-ahead blocks which are about to become stale */
+	if (SameMedium && (BlockAddress < CacheEnd) && ((BlockAddress + Blocks) > CacheStart))
+	  MSInterfaceInfo->State.CacheTotalBlocks = 0;
+
+	if (Blocks >= CacheBlocks)
+	{
+		return MS_Host_TransferDeviceBlocks(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize,
+		                                    (void*)BlockBuffer, false);
+	}
+
+	memcpy(BlockCache, BlockBuffer, ((uint16_t)Blocks * BlockSize));
+
+	MSInterfaceInfo->State.CacheStartBlock  = BlockAddress;
+	MSInterfaceInfo->State.CacheBlockSize   = BlockSize;
+	MSInterfaceInfo->State.CacheLUNIndex    = LUNIndex;
+	MSInterfaceInfo->State.CacheTotalBlocks = Blocks;
+	MSInterfaceInfo->State.CacheIsDirty     = true;
+
+	return PIPE_RWSTREAM_NoError;
+}
+
+uint8_t MS_Host_ReadDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+                                 const uint8_t LUNIndex,
+                                 const uint32_t BlockAddress,
+                                 const uint8_t Blocks,
+                                 const uint16_t BlockSize,
+                                 void* BlockBuffer)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
+
+	if (MSInterfaceInfo->Config.BlockCache != NULL)
+	  return MS_Host_ReadDeviceBlocksCached(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize, BlockBuffer);
+
+	return MS_Host_TransferDeviceBlocks(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize, BlockBuffer, true);
+}
+
 uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
                                   const uint8_t LUNIndex,
                                   const uint32_t BlockAddress,
@@ -574,37 +759,33 @@ uint8_t MS_Host_WriteDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo
 	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
 	  return HOST_SENDCONTROL_DeviceDisconnected;
 
-	uint8_t ErrorCode;
+	if (MSInterfaceInfo->Config.BlockCache != NULL)
+	  return MS_Host_WriteDeviceBlocksCached(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize, BlockBuffer);
 
-	MS_CommandBlockWrapper_t SCSICommandBlock = (MS_CommandBlockWrapper_t)
-		{
-			.DataTransferLength = ((uint32_t)Blocks * BlockSize),
-			.Flags              = COMMAND_DIRECTION_DATA_OUT,
-			.LUN                = LUNIndex,
-			.SCSICommandLength  = 10,
-			.SCSICommandData    =
-				{
-					SCSI_CMD_WRITE_10,
-					0x00,                   // Unused (control bits, all off)
-					(BlockAddress >> 24),   // MSB of Block Address
-					(BlockAddress >> 16),
-					(BlockAddress >> 8),
-					(BlockAddress & 0xFF),  // LSB of Block Address
-					0x00,                   // Reserved
-					0x00,                   // MSB of Total Blocks to Write
-					Blocks,                 // LSB of Total Blocks to Write
-					0x00                    // Unused (control)
-				}
-		};
+	return MS_Host_TransferDeviceBlocks(MSInterfaceInfo, LUNIndex, BlockAddress, Blocks, BlockSize,
+	                                    (void*)BlockBuffer, false);
+}
 
-	MS_CommandStatusWrapper_t SCSICommandStatus;
+uint8_t MS_Host_FlushBlockCache(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo)
+{
+	if ((USB_HostState != HOST_STATE_Configured) || !(MSInterfaceInfo->State.IsActive))
+	  return HOST_SENDCONTROL_DeviceDisconnected;
 
-	if ((ErrorCode = MS_Host_SendCommand(MSInterfaceInfo, &SCSICommandBlock, BlockBuffer)) != PIPE_RWSTREAM_NoError)
-	  return ErrorCode;
-	
-	if ((ErrorCode = MS_Host_GetReturnedStatus(MSInterfaceInfo, &SCSICommandStatus)) != PIPE_RWSTREAM_NoError)
-	  return ErrorCode;
+	if (!(MSInterfaceInfo->State.CacheIsDirty))
+	  return PIPE_RWSTREAM_NoError;
+
+	uint8_t ErrorCode;
+
+	if ((ErrorCode = MS_Host_TransferDeviceBlocks(MSInterfaceInfo, MSInterfaceInfo->State.CacheLUNIndex,
+	                                              MSInterfaceInfo->State.CacheStartBlock,
+	                                              MSInterfaceInfo->State.CacheTotalBlocks,
+	                                              MSInterfaceInfo->State.CacheBlockSize,
+	                                              MSInterfaceInfo->Config.BlockCache, false)) != PIPE_RWSTREAM_NoError)
+	{
+		return ErrorCode;
+	}
 
+	MSInterfaceInfo->State.CacheIsDirty = false;
 	return PIPE_RWSTREAM_NoError;
 }
 
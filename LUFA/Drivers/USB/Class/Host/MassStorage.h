@@ -88,6 +88,14 @@
 
 					uint8_t  DataOUTPipeNumber; /**< Pipe number of the Mass Storage interface's OUT data pipe. */
 					bool     DataOUTPipeDoubleBank; /**< Indicates if the Mass Storage interface's OUT data pipe should use double banking. */
+
+					uint8_t* BlockCache; /**< Optional pointer to a user allocated buffer, used as a read-ahead and write-combining
+					                      *   cache by \ref MS_Host_ReadDeviceBlocks() and \ref MS_Host_WriteDeviceBlocks(). If NULL,
+					                      *   all block accesses are issued directly to the device.
+					                      */
+					uint16_t BlockCacheSize; /**< Size in bytes of the buffer pointed to by BlockCache, if used. This should be a
+					                          *   multiple of the device's block size.
+					                          */
 				} Config; /**< Config data for the USB class interface within the device. All elements in this section
 				           *   <b>must</b> be set or the interface will fail to enumerate and operate correctly.
 				           */
@@ -103,6 +111,23 @@
 					uint16_t DataOUTPipeSize;  /**< Size in bytes of the Mass Storage interface's OUT data pipe. */
 					
 					uint32_t TransactionTag; /**< Current transaction tag for data synchronizing of packets. */
+
+					uint32_t CacheStartBlock; /**< Address of the first block held in the optional block cache. */
+					uint16_t CacheBlockSize; /**< Size in bytes of each block held in the optional block cache. */
+					uint8_t  CacheLUNIndex; /**< LUN index of the blocks held in the optional block cache. */
+					uint8_t  CacheTotalBlocks; /**< Number of valid blocks held in the optional block cache. */
+					bool     CacheIsDirty; /**< Indicates if the blocks held in the optional block cache have yet to be written
+					                        *   to the device.
+					                        */
+					
+					uint32_t CapacityLastBlock; /**< Address of the last block of the LUN indexed by CapacityLUNIndex, as
+					                             *   returned by the last successful call to \ref MS_Host_ReadDeviceCapacity().
+					                             */
+					uint8_t  CapacityLUNIndex; /**< LUN index whose capacity is held in CapacityLastBlock. */
+					bool     CapacityIsKnown; /**< Indicates if CapacityLastBlock is valid. The block cache only reads ahead
+					                           *   once the medium's capacity is known, so that it never reads past the end
+					                           *   of the medium.
+					                           */
 				} State; /**< State data for the USB class interface within the device. All elements in this section
 						  *   <b>may</b> be set to initial values, but may also be ignored to default to sane values when
 						  *   the interface is enumerated.
@@ -249,6 +274,10 @@
 			                                          const bool PreventRemoval) ATTR_NON_NULL_PTR_ARG(1);
 			
 			/** Reads blocks of data from the attached Mass Storage device's medium.
+			 *
+			 *  If a block cache has been supplied in the interface's configuration, small reads which miss the cache fill the
+			 *  entire cache from the requested block onwards in a single command, so that subsequent sequential reads are
+			 *  served from memory. Reads at least as large as the cache are issued directly to the device as a single command.
 			 *
 			 *  \pre This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
 			 *       call will fail.
@@ -270,6 +299,10 @@
 			                                 void* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 		
 			/** Writes blocks of data to the attached Mass Storage device's medium.
+			 *
+			 *  If a block cache has been supplied in the interface's configuration, small sequential writes are combined in the
+			 *  cache and written to the device as a single command once the cache is full, a non-sequential access is made, or
+			 *  \ref MS_Host_FlushBlockCache() is called.
 			 *
 			 *  \pre This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
 			 *       call will fail.
@@ -290,6 +323,19 @@
 			                                  const uint16_t BlockSize,
 			                                  const void* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 
+			/** Writes any combined blocks held in the interface's block cache to the device. This must be called before the
+			 *  device is removed or the medium is unlocked if a block cache is in use, or written data may be lost.
+			 *
+			 *  \pre This function must only be called when the Host state machine is in the HOST_STATE_Configured state or the
+			 *       call will fail.
+			 *
+			 *  \param[in,out] MSInterfaceInfo  Pointer to a structure containing a MS Class host configuration and state.
+			 *
+			 *  \return A value from the \ref Pipe_Stream_RW_ErrorCodes_t enum, MS_ERROR_LOGICAL_CMD_FAILED if the device
+			 *          rejected the write command, or HOST_SENDCONTROL_DeviceDisconnected if the device is not configured.
+			 */
+			uint8_t MS_Host_FlushBlockCache(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo) ATTR_NON_NULL_PTR_ARG(1);
+
 		/* Inline Functions: */
 			/** General management task for a given Mass Storage host class interface, required for the correct operation of
 			 *  the interface. This should be called frequently in the main program loop, before the master USB management task
@@ -323,6 +369,8 @@
 
 			#define MS_FOUND_DATAPIPE_IN           (1 << 0)
 			#define MS_FOUND_DATAPIPE_OUT          (1 << 1)
+
+			#define MS_MAX_STREAM_CHUNK_SIZE       0x8000
 			
 		/* Function Prototypes: */
 			#if defined(__INCLUDE_FROM_MS_CLASS_HOST_C)		
@@ -339,6 +387,30 @@
 				static uint8_t MS_Host_GetReturnedStatus(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
 				                                         MS_CommandStatusWrapper_t* const SCSICommandStatus)
 				                                         ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(2);
+				static uint8_t MS_Host_TransferDeviceBlocks(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                            const uint8_t LUNIndex,
+				                                            const uint32_t BlockAddress,
+				                                            const uint8_t Blocks,
+				                                            const uint16_t BlockSize,
+				                                            void* BlockBuffer,
+				                                            const bool IsRead) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
+				static uint8_t MS_Host_GetCacheCapacity(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                        const uint16_t BlockSize) ATTR_NON_NULL_PTR_ARG(1);
+				static bool MS_Host_IsCacheForMedium(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                     const uint8_t LUNIndex,
+				                                     const uint16_t BlockSize) ATTR_NON_NULL_PTR_ARG(1);
+				static uint8_t MS_Host_ReadDeviceBlocksCached(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                              const uint8_t LUNIndex,
+				                                              uint32_t BlockAddress,
+				                                              uint8_t Blocks,
+				                                              const uint16_t BlockSize,
+				                                              uint8_t* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
+				static uint8_t MS_Host_WriteDeviceBlocksCached(USB_ClassInfo_MS_Host_t* const MSInterfaceInfo,
+				                                               const uint8_t LUNIndex,
+				                                               const uint32_t BlockAddress,
+				                                               const uint8_t Blocks,
+				                                               const uint16_t BlockSize,
+				                                               const void* BlockBuffer) ATTR_NON_NULL_PTR_ARG(1) ATTR_NON_NULL_PTR_ARG(6);
 			#endif
 	#endif
 	
@@ -29,6 +29,7 @@
 */
 
 #define  __INCLUDE_FROM_USB_DRIVER
+#define  __INCLUDE_FROM_ENDPOINTSTREAM_C
 #include "USBMode.h"
 
 #if defined(USB_CAN_BE_DEVICE)
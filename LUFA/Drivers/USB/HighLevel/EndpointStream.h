@@ -514,6 +514,57 @@
 			uint8_t Endpoint_Read_Control_EStream_BE(void* Buffer,
 			                                         uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
 
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Macros: */
+			#if !defined(STREAM_CALLBACK_BANK_INTERVAL)
+				#define STREAM_CALLBACK_BANK_INTERVAL   1
+			#endif
+
+			#if !defined(NO_STREAM_CALLBACKS)
+				#define __STREAM_CALLBACK_DISPATCH(Func, Buffer, Length, Callback)                  \
+				       ((__builtin_constant_p((Callback) == NULL) && ((Callback) == NULL)) ?        \
+				        Func ## _NoCallback(Buffer, Length) : Func(Buffer, Length, Callback))
+
+				#if !defined(__INCLUDE_FROM_ENDPOINTSTREAM_C)
+					#define Endpoint_Write_Stream_LE(Buffer, Length, Callback)   __STREAM_CALLBACK_DISPATCH(Endpoint_Write_Stream_LE, Buffer, Length, Callback)
+					#define Endpoint_Write_EStream_LE(Buffer, Length, Callback)  __STREAM_CALLBACK_DISPATCH(Endpoint_Write_EStream_LE, Buffer, Length, Callback)
+					#define Endpoint_Write_PStream_LE(Buffer, Length, Callback)  __STREAM_CALLBACK_DISPATCH(Endpoint_Write_PStream_LE, Buffer, Length, Callback)
+					#define Endpoint_Write_Stream_BE(Buffer, Length, Callback)   __STREAM_CALLBACK_DISPATCH(Endpoint_Write_Stream_BE, Buffer, Length, Callback)
+					#define Endpoint_Write_EStream_BE(Buffer, Length, Callback)  __STREAM_CALLBACK_DISPATCH(Endpoint_Write_EStream_BE, Buffer, Length, Callback)
+					#define Endpoint_Write_PStream_BE(Buffer, Length, Callback)  __STREAM_CALLBACK_DISPATCH(Endpoint_Write_PStream_BE, Buffer, Length, Callback)
+					#define Endpoint_Read_Stream_LE(Buffer, Length, Callback)    __STREAM_CALLBACK_DISPATCH(Endpoint_Read_Stream_LE, Buffer, Length, Callback)
+					#define Endpoint_Read_EStream_LE(Buffer, Length, Callback)   __STREAM_CALLBACK_DISPATCH(Endpoint_Read_EStream_LE, Buffer, Length, Callback)
+					#define Endpoint_Read_Stream_BE(Buffer, Length, Callback)    __STREAM_CALLBACK_DISPATCH(Endpoint_Read_Stream_BE, Buffer, Length, Callback)
+					#define Endpoint_Read_EStream_BE(Buffer, Length, Callback)   __STREAM_CALLBACK_DISPATCH(Endpoint_Read_EStream_BE, Buffer, Length, Callback)
+				#endif
+			#endif
+
+		/* Function Prototypes: */
+			#if !defined(NO_STREAM_CALLBACKS)
+				uint8_t Endpoint_Write_Stream_LE_NoCallback(const void* Buffer,
+				                                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Write_EStream_LE_NoCallback(const void* Buffer,
+				                                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Write_PStream_LE_NoCallback(const void* Buffer,
+				                                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Write_Stream_BE_NoCallback(const void* Buffer,
+				                                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Write_EStream_BE_NoCallback(const void* Buffer,
+				                                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Write_PStream_BE_NoCallback(const void* Buffer,
+				                                             uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Read_Stream_LE_NoCallback(void* Buffer,
+				                                           uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Read_EStream_LE_NoCallback(void* Buffer,
+				                                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Read_Stream_BE_NoCallback(void* Buffer,
+				                                           uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+				uint8_t Endpoint_Read_EStream_BE_NoCallback(void* Buffer,
+				                                            uint16_t Length) ATTR_NON_NULL_PTR_ARG(1);
+			#endif
+	#endif
+
 	/* Disable C linkage for C++ Compilers: */
 		#if defined(__cplusplus)
 			}
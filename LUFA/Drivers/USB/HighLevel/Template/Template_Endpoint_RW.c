@@ -1,79 +1,34 @@
-uint8_t TEMPLATE_FUNC_NAME (TEMPLATE_BUFFER_TYPE Buffer,
-                            uint16_t Length
-                            __CALLBACK_PARAM)
-{
-	uint8_t* DataStream = ((uint8_t*)Buffer + TEMPLATE_BUFFER_OFFSET(Length));
-	uint8_t  ErrorCode;
-	
-	if ((ErrorCode = Endpoint_WaitUntilReady()))
-	  return ErrorCode;
-
-	#if defined(FAST_STREAM_TRANSFERS)
-	uint8_t BytesRemToAlignment = (Endpoint_BytesInEndpoint() & 0x07);
-
-	if (Length >= 8)
-	{
-		Length -= BytesRemToAlignment;
-
-		switch (BytesRemToAlignment)
-		{
-			default:
-				do
-				{
-					if (!(Endpoint_IsReadWriteAllowed()))
-					{
-						TEMPLATE_CLEAR_ENDPOINT();
-
-						#if !defined(NO_STREAM_CALLBACKS)
-						if ((Callback != NULL) && (Callback() == STREAMCALLBACK_Abort))
-						  return ENDPOINT_RWSTREAM_CallbackAborted;
-						#endif
-
-						if ((ErrorCode = Endpoint_WaitUntilReady()))
-						  return ErrorCode;
-					}
-
-					Length -= 8;
-					
-					TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 7: TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 6: TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 5: TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 4: TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 3: TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 2: TEMPLATE_TRANSFER_BYTE(DataStream);
-			case 1:	TEMPLATE_TRANSFER_BYTE(DataStream);
-				} while (Length >= 8);	
-		}
-	}
-	#endif
-
-	while (Length)
-	{
-		if (!(Endpoint_IsReadWriteAllowed()))
-		{
-			TEMPLATE_CLEAR_ENDPOINT();
-
-			#if !defined(NO_STREAM_CALLBACKS)
-			if ((Callback != NULL) && (Callback() == STREAMCALLBACK_Abort))
-			  return ENDPOINT_RWSTREAM_CallbackAborted;
-			#endif
-
-			if ((ErrorCode = Endpoint_WaitUntilReady()))
-			  return ErrorCode;
-		}
-		else
-		{
-			TEMPLATE_TRANSFER_BYTE(DataStream);
-			Length--;
-		}
-	}
-
-	return ENDPOINT_RWSTREAM_NoError;
-}
+#if !defined(TEMPLATE_CONCAT)
+	#define TEMPLATE_CONCAT(x, y)                  TEMPLATE_CONCAT_EXPANDED(x, y)
+	#define TEMPLATE_CONCAT_EXPANDED(x, y)         x ## y
+#endif
+
+#if !defined(NO_STREAM_CALLBACKS)
+	/* Callback variant, called when the stream's callback parameter is not known to be NULL at compile time */
+	#define TEMPLATE_VARIANT_NAME                  TEMPLATE_FUNC_NAME
+	#define TEMPLATE_CALLBACK_PARAM                __CALLBACK_PARAM
+	#define TEMPLATE_STREAM_CALLBACKS
+	#include "Template_Endpoint_RW_Body.c"
+	#undef  TEMPLATE_VARIANT_NAME
+	#undef  TEMPLATE_CALLBACK_PARAM
+	#undef  TEMPLATE_STREAM_CALLBACKS
+
+	/* Callback free variant, automatically selected when the stream's callback parameter is a compile time NULL */
+	#define TEMPLATE_VARIANT_NAME                  TEMPLATE_CONCAT(TEMPLATE_FUNC_NAME, _NoCallback)
+	#define TEMPLATE_CALLBACK_PARAM
+	#include "Template_Endpoint_RW_Body.c"
+	#undef  TEMPLATE_VARIANT_NAME
+	#undef  TEMPLATE_CALLBACK_PARAM
+#else
+	#define TEMPLATE_VARIANT_NAME                  TEMPLATE_FUNC_NAME
+	#define TEMPLATE_CALLBACK_PARAM
+	#include "Template_Endpoint_RW_Body.c"
+	#undef  TEMPLATE_VARIANT_NAME
+	#undef  TEMPLATE_CALLBACK_PARAM
+#endif
 
 #undef TEMPLATE_FUNC_NAME
 #undef TEMPLATE_BUFFER_TYPE
 #undef TEMPLATE_TRANSFER_BYTE
 #undef TEMPLATE_CLEAR_ENDPOINT
-#undef TEMPLATE_BUFFER_OFFSET
\ No newline at end of file
+#undef TEMPLATE_BUFFER_OFFSET
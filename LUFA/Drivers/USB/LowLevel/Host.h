@@ -310,6 +310,18 @@
 				return ((USBSTA & (1 << SPEED)) ? true : false);
 			}
 
+			/** Retrieves the current USB frame number, incremented once for each Start Of Frame sent to the
+			 *  attached device. As frames are issued once every millisecond in Full Speed mode, this can be used
+			 *  as a coarse millisecond timebase for measuring the duration of host operations.
+			 *
+			 *  \return Current 11-bit USB frame number.
+			 */
+			static inline uint16_t USB_Host_GetFrameNumber(void) ATTR_WARN_UNUSED_RESULT ATTR_ALWAYS_INLINE;
+			static inline uint16_t USB_Host_GetFrameNumber(void)
+			{
+				return UHFNUM;
+			}
+
 			/** Determines if the attached device is currently issuing a Remote Wakeup request, requesting
 			 *  that the host resume the USB bus and wake up the device, false otherwise.
 			 *